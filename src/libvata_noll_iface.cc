@@ -129,6 +129,17 @@ void vata_free_ta(
 	delete ta;
 }
 
+vata_ta_t* vata_copy_ta(
+	const vata_ta_t*       ta)
+{
+	assert(nullptr != ta);
+
+	vata_ta_t* copy = new vata_ta_t;
+	copy->ta = ta->ta;
+
+	return copy;
+}
+
 void vata_set_state_root(
 	vata_ta_t*          ta,
 	vata_state_t        state)
@@ -166,6 +177,37 @@ void vata_add_transition(
 }
 
 
+void vata_add_transitions(
+	vata_ta_t*                  ta,
+	const noll_uid_array*       parents,
+	const noll_ta_symbol_array* symbols,
+	const noll_uid_array*       children,
+	const noll_uid_array*       offsets)
+{
+	// check that the input is sane
+	assert(nullptr != ta);
+	assert(nullptr != parents);
+	assert(nullptr != symbols);
+	assert(nullptr != children);
+	assert(nullptr != offsets);
+	assert(noll_vector_size(parents) == noll_vector_size(symbols));
+	assert(noll_vector_size(parents) + 1 == noll_vector_size(offsets));
+
+	TreeAut::StateTuple tupChildren;
+	for (size_t i = 0; i < noll_vector_size(parents); ++i)
+	{
+		const uid_t* first = noll_vector_array(children) + noll_vector_at(offsets, i);
+		const uid_t* last = noll_vector_array(children) + noll_vector_at(offsets, i + 1);
+		tupChildren.assign(first, last);
+
+		ta->ta.AddTransition(
+			tupChildren,
+			NollAlphabet::noll_to_vata_symbol(noll_vector_at(symbols, i)),
+			noll_vector_at(parents, i));
+	}
+}
+
+
 void vata_print_ta(
 	const vata_ta_t*        ta)
 {
@@ -179,17 +221,41 @@ void vata_print_ta(
 }
 
 
+void vata_reduce_ta(
+	vata_ta_t*              ta)
+{
+	assert(nullptr != ta);
+
+	ta->ta = ta->ta.RemoveUselessStates();
+	ta->ta = ta->ta.Reduce();
+}
+
+
 bool vata_check_inclusion(
 	const vata_ta_t*        smaller_ta,
-	const vata_ta_t*        bigger_ta)
+	const vata_ta_t*        bigger_ta,
+	vata_incl_e             mode)
 {
 	// check the sanity of passed paremeters
 	assert(nullptr != smaller_ta);
 	assert(nullptr != bigger_ta);
 
-	// the params may be used to specify the exact inclusion checking
-	// algorithm
 	VATA::InclParam params;
+	params.SetAlgorithm(VATA::InclParam::e_algorithm::antichains);
+	switch (mode)
+	{
+		case VATA_INCL_UPWARD:
+			params.SetDirection(VATA::InclParam::e_direction::upward);
+			break;
+		case VATA_INCL_DOWNWARD:
+			params.SetDirection(VATA::InclParam::e_direction::downward);
+			break;
+		case VATA_INCL_DOWNWARD_SIM:
+			params.SetDirection(VATA::InclParam::e_direction::downward);
+			params.SetUseSimulation(true);
+			break;
+	}
+
 	return TreeAut::CheckInclusion(smaller_ta->ta, bigger_ta->ta, params);
 }
 
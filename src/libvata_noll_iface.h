@@ -56,6 +56,14 @@ extern "C"
 
   typedef noll_ta_symbol_t vata_symbol_t;
 
+/// Algorithms checking inclusion of TA
+  typedef enum
+  {
+    VATA_INCL_UPWARD = 0,       ///< upward antichains
+    VATA_INCL_DOWNWARD,         ///< downward antichains
+    VATA_INCL_DOWNWARD_SIM      ///< downward antichains using simulation
+  } vata_incl_e;
+
 /* ====================================================================== */
 /* Functions */
 /* ====================================================================== */
@@ -83,6 +91,19 @@ extern "C"
   void vata_free_ta (vata_ta_t * ta);
 
 
+/**
+ * @brief  Copies a TA
+ *
+ * This function creates on the heap a copy of the tree automaton @p ta. The
+ * copy needs to be freed using the vata_free_ta() function.
+ *
+ * @param[in]  ta  The TA to be copied
+ *
+ * @returns  Pointer to the created TA
+ */
+  vata_ta_t *vata_copy_ta (const vata_ta_t * ta);
+
+
 /**
  * @brief  Sets a state as a root state
  *
@@ -114,6 +135,27 @@ extern "C"
                             const noll_uid_array * children);
 
 
+/**
+ * @brief  Adds a batch of transitions into a TA
+ *
+ * This function adds the transitions @p parents[i] -> [@p symbols[i]](@p
+ * children[@p offsets[i]], ..., @p children[@p offsets[i+1] - 1]) into the TA
+ * @p ta, for every i.
+ *
+ * @param[in,out]  ta        The TA to be altered
+ * @param[in]      parents   The parent states of the transitions
+ * @param[in]      symbols   The symbols of the transitions
+ * @param[in]      children  The children states of all transitions
+ * @param[in]      offsets   The start of the children of each transition in
+ *                           @p children, followed by the size of @p children
+ */
+  void vata_add_transitions (vata_ta_t * ta,
+                             const noll_uid_array * parents,
+                             const noll_ta_symbol_array * symbols,
+                             const noll_uid_array * children,
+                             const noll_uid_array * offsets);
+
+
 /**
  * @brief  Prints the automaton
  *
@@ -122,20 +164,34 @@ extern "C"
   void vata_print_ta (const vata_ta_t * ta);
 
 
+/**
+ * @brief  Reduces a TA
+ *
+ * This function removes the useless states of @p ta and then merges its
+ * states equivalent w.r.t. the downward simulation. The language of @p ta is
+ * unchanged.
+ *
+ * @param[in,out]  ta  The TA to be reduced
+ */
+  void vata_reduce_ta (vata_ta_t * ta);
+
+
 /**
  * @brief Checks whether L(smaller_ta) <= L(bigger_ta)
  *
  * This function checks whether the language of the TA @p
  * smaller_ta is included in the language of the TA @p
- * bigger_ta.
+ * bigger_ta, using the algorithm @p mode.
  *
  * @param[in]  smaller_ta   The included TA
  * @param[in]  bigger_ta    The including TA
+ * @param[in]  mode         The algorithm used
  *
  * @returns  @p bool if L(smaller_ta) <= L(bigger_ta), @p false otherwise
  */
   bool vata_check_inclusion (const vata_ta_t * smaller_ta,
-                             const vata_ta_t * bigger_ta);
+                             const vata_ta_t * bigger_ta,
+                             vata_incl_e mode);
 
 
 /**
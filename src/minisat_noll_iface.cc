@@ -0,0 +1,180 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+// minisat header files
+#include "simp/SimpSolver.h"
+
+#include "minisat_noll_iface.h"
+
+// to catch strange behaviour
+#ifndef __cplusplus
+	#error "Needs a C++ compiler!"
+#endif
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+using Solver  = Minisat::SimpSolver;
+using Var     = Minisat::Var;
+using Lit     = Minisat::Lit;
+using lbool   = Minisat::lbool;
+
+typedef struct type_minisat_solver_t
+{
+	Solver solver;
+	Minisat::vec<Lit> lits;             // buffer for clauses and assumptions
+} minisat_solver_t;
+
+/* ====================================================================== */
+/* Auxiliary functions */
+/* ====================================================================== */
+
+static Lit minisat_to_lit(
+	minisat_solver_t*        s,
+	minisat_lit_t            lit)
+{
+	assert(0 != lit);
+
+	Var v = ((lit > 0) ? lit : -lit) - 1;
+	while (v >= s->solver.nVars())
+		s->solver.newVar();
+
+	return Minisat::mkLit(v, lit < 0);
+}
+
+static void minisat_to_lits(
+	minisat_solver_t*        s,
+	const minisat_lit_t*     lits,
+	uint_t                   size)
+{
+	s->lits.clear();
+	for (uint_t i = 0; i < size; i++)
+		s->lits.push(minisat_to_lit(s, lits[i]));
+}
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+minisat_solver_t* minisat_create_solver()
+{
+	minisat_solver_t* s = minisat_create_simp_solver();
+
+	// no preprocessing, the solver behaves as the core one
+	s->solver.eliminate(true);
+
+	return s;
+}
+
+minisat_solver_t* minisat_create_simp_solver()
+{
+	minisat_solver_t* s = new minisat_solver_t;
+
+	// no output from the solver
+	s->solver.verbosity = 0;
+
+	return s;
+}
+
+void minisat_free_solver(
+	minisat_solver_t*        s)
+{
+	delete s;
+}
+
+void minisat_reserve_vars(
+	minisat_solver_t*        s,
+	uint_t                   nvars)
+{
+	assert(nullptr != s);
+
+	while (static_cast<uint_t>(s->solver.nVars()) < nvars)
+		s->solver.newVar();
+}
+
+void minisat_freeze_var(
+	minisat_solver_t*        s,
+	uint_t                   var)
+{
+	assert(nullptr != s);
+	assert(0 < var);
+
+	Lit p = minisat_to_lit(s, static_cast<minisat_lit_t>(var));
+	s->solver.setFrozen(Minisat::var(p), true);
+}
+
+bool minisat_eliminate(
+	minisat_solver_t*        s)
+{
+	assert(nullptr != s);
+
+	// the preprocessing is done once, later clauses are kept as given
+	return s->solver.eliminate(true);
+}
+
+bool minisat_add_clause(
+	minisat_solver_t*        s,
+	const minisat_lit_t*     lits,
+	uint_t                   size)
+{
+	// check that the input is sane
+	assert(nullptr != s);
+	assert((0 == size) || (nullptr != lits));
+
+	minisat_to_lits(s, lits, size);
+
+	return s->solver.addClause_(s->lits);
+}
+
+int minisat_solve(
+	minisat_solver_t*        s,
+	const minisat_lit_t*     assums,
+	uint_t                   size)
+{
+	// check that the input is sane
+	assert(nullptr != s);
+	assert((0 == size) || (nullptr != assums));
+
+	if (!s->solver.okay())
+		return 0;
+
+	minisat_to_lits(s, assums, size);
+
+	return s->solver.solve(s->lits) ? 1 : 0;
+}
+
+int minisat_model_value(
+	const minisat_solver_t*  s,
+	uint_t                   var)
+{
+	// check that the input is sane
+	assert(nullptr != s);
+	assert(0 < var);
+
+	Var v = static_cast<Var>(var) - 1;
+	if (v >= s->solver.model.size())
+		return -1;
+
+	lbool val = s->solver.modelValue(v);
+	if (val == l_True)
+		return 1;
+	if (val == l_False)
+		return 0;
+	return -1;
+}
@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Interface to the bundled minisat (minisat/minisat-inc).
+ */
+
+#ifndef MINISAT_NOLL_IFACE_H_
+#define MINISAT_NOLL_IFACE_H_
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+// NOLL headers
+#include "noll_vector.h"
+
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+  struct type_minisat_solver_t;
+  typedef struct type_minisat_solver_t minisat_solver_t;
+
+/// Literals are given in the DIMACS convention: variable v > 0 is the
+/// positive literal v and the negative literal -v.
+  typedef int minisat_lit_t;
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+/**
+ * @brief  Creates an empty solver
+ *
+ * This function creates a solver without variables and clauses on the heap.
+ * The solver needs to be freed using the minisat_free_solver() function to
+ * avoid resource leakage.
+ *
+ * @returns  Pointer to the created solver
+ */
+  minisat_solver_t *minisat_create_solver (void);
+
+
+/**
+ * @brief  Creates an empty solver with preprocessing
+ *
+ * As minisat_create_solver(), but the clauses added until the call to
+ * minisat_eliminate() are simplified by subsumption and bounded variable
+ * elimination.
+ *
+ * @returns  Pointer to the created solver
+ */
+  minisat_solver_t *minisat_create_simp_solver (void);
+
+/**
+ * @brief  Frees a solver
+ *
+ * @param[in]  s  The solver to be freed, if NULL, nothing happens.
+ */
+  void minisat_free_solver (minisat_solver_t * s);
+
+
+/**
+ * @brief  Declares the variables 1..@p nvars
+ *
+ * Variables occurring in clauses are declared on demand, this function
+ * is only needed for variables that may appear only in assumptions.
+ *
+ * @param[in,out]  s      The solver to be altered
+ * @param[in]      nvars  The greatest variable used
+ */
+  void minisat_reserve_vars (minisat_solver_t * s, uint_t nvars);
+
+
+/**
+ * @brief  Protects a variable from elimination
+ *
+ * Variables used in assumptions, read in models or in clauses added
+ * after minisat_eliminate() shall be frozen before this call.
+ *
+ * @param[in,out]  s    The solver to be altered
+ * @param[in]      var  The variable (> 0)
+ */
+  void minisat_freeze_var (minisat_solver_t * s, uint_t var);
+
+/**
+ * @brief  Simplifies the clauses added so far
+ *
+ * Runs subsumption and bounded elimination of the variables not frozen,
+ * once: the clauses added later are not simplified.
+ *
+ * @param[in,out]  s  The solver to be simplified
+ *
+ * @returns  @p false if the solver became trivially unsatisfiable
+ */
+  bool minisat_eliminate (minisat_solver_t * s);
+
+/**
+ * @brief  Adds a clause into the solver
+ *
+ * @param[in,out]  s     The solver to be altered
+ * @param[in]      lits  Array of the literals of the clause
+ * @param[in]      size  Number of literals in @p lits
+ *
+ * @returns  @p false if the solver became trivially unsatisfiable
+ */
+  bool minisat_add_clause (minisat_solver_t * s,
+                           const minisat_lit_t * lits, uint_t size);
+
+
+/**
+ * @brief  Checks satisfiability under assumptions
+ *
+ * The clauses added and the clauses learnt are kept after the call,
+ * such that the solver may be queried again with other assumptions.
+ *
+ * @param[in,out]  s       The solver to be queried
+ * @param[in]      assums  Array of literals assumed true (may be @p NULL)
+ * @param[in]      size    Number of literals in @p assums
+ *
+ * @returns  1 if satisfiable, 0 if unsatisfiable
+ */
+  int minisat_solve (minisat_solver_t * s,
+                     const minisat_lit_t * assums, uint_t size);
+
+
+/**
+ * @brief  Value of a variable in the last model
+ *
+ * The last call to minisat_solve() must have returned 1.
+ *
+ * @param[in]  s    The solver
+ * @param[in]  var  The variable (> 0)
+ *
+ * @returns  1 if true, 0 if false, -1 if unassigned
+ */
+  int minisat_model_value (const minisat_solver_t * s, uint_t var);
+
+
+#ifdef __cplusplus
+}                               // extern "C"
+#endif
+
+#endif                          /* MINISAT_NOLL_IFACE_H_ */
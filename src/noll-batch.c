@@ -0,0 +1,491 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Batch driver: solve a set of problems with parallel workers.
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <limits.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "smtlib2noll.h"
+#include "noll_entl.h"
+#include "noll_option.h"
+#include "noll_scratch.h"
+#include "noll_ta_symbols.h"
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+/** Problem of the batch */
+typedef struct noll_batch_prob_t
+{
+  char *fname;                  // absolute path of the problem
+  const char *result;           // sat, unsat, unknown, timeout, memout, error
+  double time;                  // CPU time used (sec)
+} noll_batch_prob_t;
+
+/** Worker solving one problem at a time */
+typedef struct noll_batch_worker_t
+{
+  pid_t pid;                    // process solving the problem, 0 if idle
+  size_t prob;                  // index of the problem solved
+  char *dir;                    // scratch directory
+} noll_batch_worker_t;
+
+/* ====================================================================== */
+/* Globals */
+/* ====================================================================== */
+
+static noll_batch_prob_t *batch_probs = NULL;
+static size_t batch_size = 0;
+static size_t batch_capacity = 0;
+
+/* limits for each problem, 0 for unlimited */
+static long batch_cpu = 0;      // seconds
+static long batch_mem = 0;      // MB
+
+/* ====================================================================== */
+/* Problems */
+/* ====================================================================== */
+
+/**
+ * Push the problem in file @p fname in the batch.
+ */
+static void
+noll_batch_push (const char *fname)
+{
+  char *path = realpath (fname, NULL);
+  if (path == NULL)
+    {
+      fprintf (stderr, "File %s not found!\n", fname);
+      return;
+    }
+  if (batch_size == batch_capacity)
+    {
+      batch_capacity = (batch_capacity == 0) ? 64 : 2 * batch_capacity;
+      batch_probs = (noll_batch_prob_t *) realloc (batch_probs,
+                                                   batch_capacity *
+                                                   sizeof
+                                                   (noll_batch_prob_t));
+    }
+  batch_probs[batch_size].fname = path;
+  batch_probs[batch_size].result = NULL;
+  batch_probs[batch_size].time = 0.0;
+  batch_size++;
+}
+
+static int
+noll_batch_cmp_name (const void *a, const void *b)
+{
+  return strcmp (*(char *const *) a, *(char *const *) b);
+}
+
+/**
+ * Push the problems given by @p arg: all the .smt files of a directory,
+ * a .smt file, or a file listing the problems (one per line).
+ */
+static void
+noll_batch_push_arg (const char *arg)
+{
+  struct stat st;
+  if (stat (arg, &st) != 0)
+    {
+      fprintf (stderr, "File %s not found!\n", arg);
+      return;
+    }
+
+  if (S_ISDIR (st.st_mode))
+    {
+      DIR *d = opendir (arg);
+      if (d == NULL)
+        return;
+      char **names = NULL;
+      size_t n = 0;
+      struct dirent *e;
+      while ((e = readdir (d)) != NULL)
+        {
+          size_t len = strlen (e->d_name);
+          if ((len <= 4) || (strcmp (e->d_name + len - 4, ".smt") != 0))
+            continue;
+          names = (char **) realloc (names, (n + 1) * sizeof (char *));
+          names[n] = (char *) malloc (strlen (arg) + len + 2);
+          sprintf (names[n], "%s/%s", arg, e->d_name);
+          n++;
+        }
+      closedir (d);
+      /* the results are printed in the order of the names */
+      qsort (names, n, sizeof (char *), noll_batch_cmp_name);
+      for (size_t i = 0; i < n; i++)
+        {
+          noll_batch_push (names[i]);
+          free (names[i]);
+        }
+      free (names);
+      return;
+    }
+
+  size_t len = strlen (arg);
+  if ((len > 4) && (strcmp (arg + len - 4, ".smt") == 0))
+    {
+      noll_batch_push (arg);
+      return;
+    }
+
+  /* list of problems */
+  FILE *f = fopen (arg, "r");
+  if (f == NULL)
+    return;
+  char *line = NULL;
+  size_t cap = 0;
+  ssize_t l;
+  while ((l = getline (&line, &cap, f)) > 0)
+    {
+      while ((l > 0) && ((line[l - 1] == '\n') || (line[l - 1] == '\r')))
+        line[--l] = '\0';
+      if ((l > 0) && (line[0] != '#'))
+        noll_batch_push (line);
+    }
+  free (line);
+  fclose (f);
+}
+
+/* ====================================================================== */
+/* Workers */
+/* ====================================================================== */
+
+/* file of the worker directory receiving the answers of (check-sat) */
+#define NOLL_BATCH_OUT "spen.out"
+
+/**
+ * Solve the problem @p fname in the current process,
+ * the answer of (check-sat) is printed in the file NOLL_BATCH_OUT
+ * of @p dir, which does not block the worker whatever its size.
+ * Does not return.
+ */
+static void
+noll_batch_solve (char *fname, const char *dir)
+{
+  /* limits of the problem */
+  struct rlimit rl;
+  if (batch_cpu > 0)
+    {
+      rl.rlim_cur = batch_cpu;
+      rl.rlim_max = batch_cpu + 1;
+      setrlimit (RLIMIT_CPU, &rl);
+    }
+  if (batch_mem > 0)
+    {
+      rl.rlim_cur = rl.rlim_max = (rlim_t) batch_mem *1024 * 1024;
+      setrlimit (RLIMIT_AS, &rl);
+    }
+
+  /* the files written are kept in the directory of the worker */
+  if ((chdir (dir) != 0)
+      || (freopen ("spen.log", "w", stdout) == NULL)
+      || (dup2 (fileno (stdout), fileno (stderr)) < 0))
+    _exit (1);
+
+  FILE *out = fopen (NOLL_BATCH_OUT, "w");
+  FILE *f = fopen (fname, "r");
+  if ((out == NULL) || (f == NULL))
+    _exit (1);
+
+  noll_ta_symbol_init ();
+  noll_entl_init ();
+  noll_entl_set_fname (fname);
+  smtlib2_noll_parser *sp = smtlib2_noll_parser_new ();
+  ((smtlib2_abstract_parser *) sp)->outstream_ = out;
+  smtlib2_abstract_parser_parse ((smtlib2_abstract_parser *) sp, f);
+
+  /* the memory is freed with the process */
+  noll_scratch_free ();
+  fflush (stdout);
+  fclose (out);
+  _exit (0);
+}
+
+/**
+ * Start the worker @p w on the problem @p i.
+ * @return 1 if started, 0 otherwise
+ */
+static int
+noll_batch_start (noll_batch_worker_t * w, size_t i)
+{
+  fflush (stdout);
+  pid_t pid = fork ();
+  if (pid == 0)
+    noll_batch_solve (batch_probs[i].fname, w->dir);
+  if (pid < 0)
+    return 0;
+  w->pid = pid;
+  w->prob = i;
+  return 1;
+}
+
+/**
+ * Collect the result of the worker @p w, ended with @p status.
+ */
+static void
+noll_batch_end (noll_batch_worker_t * w, int status, struct rusage *ru)
+{
+  noll_batch_prob_t *p = &batch_probs[w->prob];
+  p->time = ru->ru_utime.tv_sec + ru->ru_stime.tv_sec
+    + (ru->ru_utime.tv_usec + ru->ru_stime.tv_usec) / 1e6;
+
+  /* the whole output, the result is the answer of the last check-sat;
+   * the file is removed for the next problem of the worker */
+  char *path = (char *) malloc (strlen (w->dir) + sizeof (NOLL_BATCH_OUT) + 1);
+  sprintf (path, "%s/%s", w->dir, NOLL_BATCH_OUT);
+  size_t cap = 256, n = 0;
+  char *buf = (char *) malloc (cap);
+  FILE *f = fopen (path, "r");
+  if (f != NULL)
+    {
+      size_t l;
+      while ((l = fread (buf + n, 1, cap - 1 - n, f)) > 0)
+        {
+          n += l;
+          if (n == cap - 1)
+            {
+              cap *= 2;
+              buf = (char *) realloc (buf, cap);
+            }
+        }
+      fclose (f);
+      unlink (path);
+    }
+  buf[n] = '\0';
+  free (path);
+
+  const char *answer = NULL;
+  for (char *line = strtok (buf, "\r\n"); line != NULL;
+       line = strtok (NULL, "\r\n"))
+    {
+      while (isspace ((unsigned char) *line))
+        line++;
+      size_t len = strlen (line);
+      while ((len > 0) && isspace ((unsigned char) line[len - 1]))
+        line[--len] = '\0';
+      if (strcmp (line, "unsat") == 0)
+        answer = "unsat";
+      else if (strcmp (line, "sat") == 0)
+        answer = "sat";
+      else if (strcmp (line, "unknown") == 0)
+        answer = "unknown";
+    }
+  free (buf);
+
+  p->result = "error";
+  if (answer != NULL)
+    p->result = answer;
+  else if (WIFSIGNALED (status))
+    {
+      /* under RLIMIT_AS, an allocation failing ends in an abort
+       * (assert, std::bad_alloc) or a fault on the NULL returned */
+      int sig = WTERMSIG (status);
+      if ((batch_cpu > 0) && ((sig == SIGXCPU) || (sig == SIGKILL)))
+        p->result = "timeout";
+      else if ((batch_mem > 0) && ((sig == SIGABRT) || (sig == SIGSEGV)))
+        p->result = "memout";
+    }
+
+  w->pid = 0;
+}
+
+/**
+ * Solve the problems of the batch with @p jobs workers,
+ * each one with its own scratch directory in @p scratch.
+ * The results are printed in the order of the batch.
+ */
+static int
+noll_batch_run (uint_t jobs, const char *scratch)
+{
+  char *root = (char *) malloc (strlen (scratch) + 32);
+  sprintf (root, "%s/spen-batch-XXXXXX", scratch);
+  if (mkdtemp (root) == NULL)
+    {
+      fprintf (stderr, "Scratch %s: %s!\nquit.", scratch, strerror (errno));
+      free (root);
+      return 1;
+    }
+
+  noll_batch_worker_t *ws =
+    (noll_batch_worker_t *) malloc (jobs * sizeof (noll_batch_worker_t));
+  for (uint_t k = 0; k < jobs; k++)
+    {
+      ws[k].pid = 0;
+      ws[k].dir = (char *) malloc (strlen (root) + 16);
+      sprintf (ws[k].dir, "%s/w%u", root, k);
+      mkdir (ws[k].dir, 0700);
+    }
+
+  size_t next = 0;              // next problem to start
+  size_t printed = 0;           // next problem to print
+  uint_t running = 0;
+  while (printed < batch_size)
+    {
+      /* give a problem to the idle workers */
+      for (uint_t k = 0; (k < jobs) && (next < batch_size); k++)
+        if ((ws[k].pid == 0) && noll_batch_start (&ws[k], next))
+          {
+            next++;
+            running++;
+          }
+      if (running == 0)
+        {                       /* fork failed */
+          batch_probs[next++].result = "error";
+        }
+      else
+        {
+          /* wait the end of a worker */
+          int status;
+          struct rusage ru;
+          pid_t pid = wait4 (-1, &status, 0, &ru);
+          if (pid < 0)
+            {
+              if (errno == EINTR)
+                continue;
+              break;
+            }
+          for (uint_t k = 0; k < jobs; k++)
+            if (ws[k].pid == pid)
+              {
+                noll_batch_end (&ws[k], status, &ru);
+                running--;
+              }
+        }
+
+      /* print the results available, in order */
+      while ((printed < batch_size) && (batch_probs[printed].result != NULL))
+        {
+          fprintf (stdout, "%s %s %.3f\n", batch_probs[printed].fname,
+                   batch_probs[printed].result, batch_probs[printed].time);
+          printed++;
+        }
+      fflush (stdout);
+    }
+
+  /* remove the scratch directories */
+  for (uint_t k = 0; k < jobs; k++)
+    {
+      DIR *d = opendir (ws[k].dir);
+      if (d != NULL)
+        {
+          struct dirent *e;
+          while ((e = readdir (d)) != NULL)
+            if (e->d_name[0] != '.')
+              {
+                char *path = (char *) malloc (strlen (ws[k].dir)
+                                              + strlen (e->d_name) + 2);
+                sprintf (path, "%s/%s", ws[k].dir, e->d_name);
+                unlink (path);
+                free (path);
+              }
+          closedir (d);
+        }
+      rmdir (ws[k].dir);
+      free (ws[k].dir);
+    }
+  rmdir (root);
+  free (root);
+  free (ws);
+  return 0;
+}
+
+/* ====================================================================== */
+/* MAIN/Main/main */
+/* ====================================================================== */
+
+/**
+ * Print informations on usage.
+ */
+void
+print_help (void)
+{
+  printf ("spen-batch: parallel driver of spen, version 1.1\n");
+  printf ("Usage: spen-batch [batch options] [options] problems...\n");
+  printf ("Batch options:\n");
+  printf ("  -wN    use N workers (default: number of processors)\n");
+  printf ("  -tN    limit the CPU time of a problem to N seconds\n");
+  printf ("  -MN    limit the memory of a problem to N MB\n");
+  noll_option_print (stdout);
+  printf
+    ("  problems  directories (of .smt files), .smt files, or lists of files\n");
+  printf ("Prints one line per problem: file result CPU-time\n");
+}
+
+int
+main (int argc, char **argv)
+{
+  long jobs = sysconf (_SC_NPROCESSORS_ONLN);
+
+  int arg = 1;
+  for (; arg < argc && argv[arg][0] == '-'; arg++)
+    {
+      char *opt = argv[arg];
+      if ((opt[1] == 'w') && (opt[2] >= '0') && (opt[2] <= '9'))
+        jobs = atol (opt + 2);
+      else if ((opt[1] == 't') && (opt[2] >= '0') && (opt[2] <= '9'))
+        batch_cpu = atol (opt + 2);
+      else if ((opt[1] == 'M') && (opt[2] >= '0') && (opt[2] <= '9'))
+        batch_mem = atol (opt + 2);
+      else if (noll_option_set (opt) != 1)
+        {
+          print_help ();
+          return 1;
+        }
+    }
+  if (arg >= argc)
+    {
+      printf ("no input file\n");
+      print_help ();
+      return 1;
+    }
+  if (jobs < 1)
+    jobs = 1;
+
+  for (; arg < argc; arg++)
+    noll_batch_push_arg (argv[arg]);
+
+  /* the directories of the workers are with the scratch files */
+  const char *scratch = noll_option_get_scratch ();
+  if ((scratch == NULL) || (strcmp (scratch, "mem") == 0))
+    scratch = getenv ("TMPDIR");
+  if (scratch == NULL)
+    scratch = "/tmp";
+  int res = noll_batch_run ((uint_t) jobs, scratch);
+
+  for (size_t i = 0; i < batch_size; i++)
+    free (batch_probs[i].fname);
+  free (batch_probs);
+  return res;
+}
@@ -20,6 +20,11 @@
 #include "smtlib2noll.h"
 #include "noll_option.h"
 #include "noll_ta_symbols.h"
+#include "noll_pred2ta.h"
+#include "noll_server.h"
+#include "noll_data.h"
+#include "noll_arena.h"
+#include "noll_hom.h"
 
 /* ====================================================================== */
 /* MAIN/Main/main */
@@ -33,9 +38,11 @@ print_help (void)
 {
   printf ("spen: decision procedure for SLRD, version 1.1\n");
   printf ("Usage: spen [options] file [output]\n");
+  printf ("       spen -s [options] [socket]\n");
   noll_option_print (stdout);
   printf ("  file   input file in SMTLIB2 format\n");
   printf ("  output proof of sat/unsat\n");
+  printf ("  socket UNIX socket to listen on, default is stdin\n");
   printf
     ("See http://www.liafa.univ-paris-diderot.fr/spen for more details.\n");
 }
@@ -69,6 +76,10 @@ main (int argc, char **argv)
       else
         break;
     }
+  // Server mode: the problems are read from stdin or a socket
+  if (noll_option_is_server ())
+    return noll_server_run ((arg_file < argc) ? argv[arg_file] : NULL);
+
   if (arg_file >= argc)
     {
 
@@ -112,7 +123,11 @@ main (int argc, char **argv)
   smtlib2_noll_parser_delete (sp);
   fclose (f);
   noll_entl_free ();
+  noll_edge2ta_cache_free ();   // destroy the TA built for predicate edges
+  noll_shom_cache_free ();      // destroy the results of the TA checks
+  noll_data_free ();            // destroy the results on data constraints
   noll_ta_symbol_destroy ();    // destroy the TA symbol database
+  noll_arena_free ();           // free the chunks kept by the arenas
 
   return 0;
 }
@@ -205,6 +205,29 @@ noll_context_restore_global (noll_context_t * ctx)
   return;
 }
 
+/**
+ * Reinitialize the context to the empty set of globals (only nil),
+ * used between two problems sharing the same declarations.
+ * The arrays in @p ctx are not in the formulae (@see restore_global).
+ */
+void
+noll_context_reset_global (noll_context_t * ctx)
+{
+  assert (ctx != NULL);
+  assert (noll_vector_size (ctx->lvar_stack) == 1);
+  assert (noll_vector_size (ctx->svar_stack) == 1);
+
+  // the variables may share their type with the declared sorts,
+  // they are not freed
+  /// Ref, Int and BagInt vars, keep nil
+  noll_var_array_resize (ctx->lvar_env, 1);
+  noll_vector_at (ctx->lvar_stack, 0) = 1;
+
+  /// SetLoc vars
+  noll_var_array_clear (ctx->svar_env);
+  noll_vector_at (ctx->svar_stack, 0) = 0;
+}
+
 void
 noll_context_fprint (FILE * f, noll_context_t * ctx)
 {
@@ -638,7 +661,7 @@ noll_mk_pred_rule_check_pure (const char *name,
       if (nrec_p == 1)
         {
           /// shall be E = nil
-          if ((prule->pure->m != NULL) &&
+          if ((prule->pure->size > 0) &&
               (noll_pure_matrix_at (prule->pure, 0, E) != NOLL_PURE_EQ))
             {
               noll_error (1, "Building predicate definition ", name);
@@ -652,7 +675,7 @@ noll_mk_pred_rule_check_pure (const char *name,
         {
           /// shall be E = F
           uint_t F = 2;
-          if ((prule->pure->m != NULL) &&
+          if ((prule->pure->size > 0) &&
               (noll_pure_matrix_at (prule->pure, E, F) != NOLL_PURE_EQ))
             {
               noll_error (1, "Building predicate definition ", name);
@@ -675,7 +698,7 @@ noll_mk_pred_rule_check_pure (const char *name,
       if (nrec_p == 1)
         {
           /// may be E != nil
-          if ((prule->pure->m != NULL) &&
+          if ((prule->pure->size > 0) &&
               (noll_pure_matrix_at (prule->pure, 0, E) == NOLL_PURE_EQ))
             {
               noll_error (1, "Building predicate definition ", name);
@@ -689,7 +712,7 @@ noll_mk_pred_rule_check_pure (const char *name,
         {
           /// shall be E != F U B
           uint_t F = 2;
-          if ((prule->pure->m != NULL) &&
+          if ((prule->pure->size > 0) &&
               (noll_pure_matrix_at (prule->pure, E, F) != NOLL_PURE_NEQ))
             {
               noll_error (1, "Building predicate definition ", name);
@@ -2562,7 +2585,19 @@ noll_exp_typecheck (noll_context_t * ctx, noll_exp_t * e)
     case NOLL_F_NOT:
       {
         assert (e->size == 1);
-        noll_exp_t *se = noll_exp_typecheck_exists (ctx, e->args[0]);
+        noll_exp_t *se = e->args[0];
+        /* a negated disjunction is typechecked by disjunct */
+        if ((se != NULL) && (se->discr == NOLL_F_OR))
+          {
+            for (uint_t i = 0; i < se->size; i++)
+              {
+                se->args[i] = noll_exp_typecheck_exists (ctx, se->args[i]);
+                if (se->args[i] == NULL)
+                  return NULL;
+              }
+          }
+        else
+          se = noll_exp_typecheck_exists (ctx, se);
         if (se == NULL)
           return NULL;
         e->args[0] = se;
@@ -3460,6 +3495,29 @@ noll_exp_push (noll_context_t * ctx, noll_exp_t * e, int ispos)
 #endif
   if (!e)
     return;
+  /* a disjunction in the negative formula gives one formula per disjunct,
+   * each with its own copy of the variables of the context */
+  if ((ispos == 0) && (e->discr == NOLL_F_OR))
+    {
+      for (uint_t i = 0; i < e->size; i++)
+        {
+          if (i > 0)
+            noll_form_array_push (noll_entl_get_nform (), noll_form_new ());
+          noll_form_t *form = noll_entl_get_nform_last ();
+          noll_exp_push_top (ctx, e->args[i], form);
+          if (form->lvars == ctx->lvar_env)
+            {
+              form->lvars = noll_var_array_new ();
+              noll_var_array_copy (form->lvars, ctx->lvar_env);
+            }
+          if (form->svars == ctx->svar_env)
+            {
+              form->svars = noll_var_array_new ();
+              noll_var_array_copy (form->svars, ctx->svar_env);
+            }
+        }
+      return;
+    }
   noll_form_t *form =
     (ispos == 0) ? noll_entl_get_nform_last () : noll_entl_get_pform ();
   /* if unsat formula, no need to push more formulas */
@@ -180,6 +180,7 @@ extern "C"
 /* Parsing context */
   noll_context_t *noll_mk_context (void);
   void noll_del_context (noll_context_t * ctx);
+  void noll_context_reset_global (noll_context_t * ctx);
 /* Allocator/deallocator. */
 
 /* Parsing logic */
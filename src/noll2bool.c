@@ -3,6 +3,7 @@
 #include <string.h>
 #include <assert.h>
 #include "noll2bool.h"
+#include "noll_scratch.h"
 
 #define MAX_PRED 50
 #define MAX_PTO 50
@@ -83,7 +84,6 @@ bool_abstr_pure (noll_form_t * form, FILE * out)
     }
   if (form->pure == NULL)
     form->pure = noll_pure_new (size);
-  noll_pure_op_t **eqns = form->pure->m;
   //write reflexivity
   for (i = 0; i < form->pure->size; i++)
     {
@@ -94,12 +94,12 @@ bool_abstr_pure (noll_form_t * form, FILE * out)
   for (i = 0; i < form->pure->size; i++)
     for (j = i + 1; j < form->pure->size; j++)
       {
-        if (eqns[i][j - i] == NOLL_PURE_EQ)
+        if (noll_pure_matrix_at (form->pure, i, j) == NOLL_PURE_EQ)
           {
             fprintf (out, "%d 0\n", encode_eq (i, j));
             nb_clauses++;
           }
-        else if (eqns[i][j - i] == NOLL_PURE_NEQ)
+        else if (noll_pure_matrix_at (form->pure, i, j) == NOLL_PURE_NEQ)
           {
             fprintf (out, "-%d 0\n", encode_eq (i, j));
             nb_clauses++;
@@ -1655,8 +1655,10 @@ write_bool_abstr (noll_form_t * form, char *fname, int *nbvar, int *nbclauses)
 
   // init the data structures used
   bool_abstr_init (form);
+  char *abstr_fname = noll_scratch_path ("", fname);
   FILE *out;
-  out = fopen (fname, "w");
+  out = fopen (abstr_fname, "w");
+  free (abstr_fname);
   int nb_clauses = 0;
   nb_clauses += bool_abstr_pure (form, out);
 #ifndef NDEBUG
@@ -1731,9 +1733,7 @@ test_in_equality (uint_t x, uint_t y, noll_pure_op_t oper, int nbv, int nbc,
     }
 
   // print the prefix file with information about variables and clauses
-  char *pre_fname = (char *) malloc ((5 + strlen (fname)) * sizeof (char));
-  memset (pre_fname, 0, (5 + strlen (fname)) * sizeof (char));
-  sprintf (pre_fname, "pre_%s", fname);
+  char *pre_fname = noll_scratch_path ("pre_", fname);
   out = fopen (pre_fname, "w");
   fprintf (out, "p cnf %d %d\n", max - 1, nbc + 1);
 #ifndef NDEBUG
@@ -1743,13 +1743,10 @@ test_in_equality (uint_t x, uint_t y, noll_pure_op_t oper, int nbv, int nbc,
              nbc + 1);
   }
 #endif
-  free (pre_fname);
   fclose (out);
 
   // print the suffix file with the equality to test
-  char *eq_fname = (char *) malloc ((5 + strlen (fname)) * sizeof (char));
-  memset (eq_fname, 0, (5 + strlen (fname)) * sizeof (char));
-  sprintf (eq_fname, "eq_%s", fname);
+  char *eq_fname = noll_scratch_path ("eq_", fname);
   out = fopen (eq_fname, "w");
 
   //write a new clause in the DIMACS file
@@ -1763,6 +1760,8 @@ test_in_equality (uint_t x, uint_t y, noll_pure_op_t oper, int nbv, int nbc,
     }
   else
     {
+      fclose (out);
+      free (pre_fname);
       free (eq_fname);
       return -1;
     }
@@ -1780,21 +1779,32 @@ test_in_equality (uint_t x, uint_t y, noll_pure_op_t oper, int nbv, int nbc,
     }
 
   // build the final file for sat using cat
-  char *command = (char *) calloc ((100 + 4 * strlen (fname)), sizeof (char));
-  memset (command, 0, (100 + 4 * strlen (fname)) * sizeof (char));
-  sprintf (command, "cat pre_%s %s eq_%s 1> full_new_%s", fname, fname, fname,
-           fname);
+  char *abstr_fname = noll_scratch_path ("", fname);
+  char *full_fname = noll_scratch_path ("full_new_", fname);
+  char *res_fname = noll_scratch_path ("result_", fname);
+  char *msat_fname = noll_scratch_path ("msat_eq_", fname);
+  size_t command_len = 100 + strlen (pre_fname) + strlen (abstr_fname)
+    + strlen (eq_fname) + strlen (full_fname) + strlen (res_fname)
+    + strlen (msat_fname);
+  char *command = (char *) calloc (command_len, sizeof (char));
+  sprintf (command, "cat %s %s %s 1> %s", pre_fname, abstr_fname, eq_fname,
+           full_fname);
+  free (pre_fname);
+  free (abstr_fname);
+  free (eq_fname);
   if (system (command) != -1)
     assert (0);
 
   // print the minisat command
-  memset (command, 0, (100 + 4 * strlen (fname)) * sizeof (char));
-  sprintf (command, "minisat -verb=0 full_new_%s result.txt 1> msat_eq_%s",
-           fname, fname);
+  memset (command, 0, command_len * sizeof (char));
+  sprintf (command, "minisat -verb=0 %s %s 1> %s",
+           full_fname, res_fname, msat_fname);
+  free (full_fname);
+  free (msat_fname);
   if (system (command) != -1)
     {
       FILE *res;
-      res = fopen ("result.txt", "r");
+      res = fopen (res_fname, "r");
       char *s = (char *) malloc (10 * sizeof (char));
       s[9] = '\0';
       fgets (s, 10, res);
@@ -1803,11 +1813,13 @@ test_in_equality (uint_t x, uint_t y, noll_pure_op_t oper, int nbv, int nbc,
         {
           free (s);
           free (command);
+          free (res_fname);
           return 1;
         }
       free (s);
     }
   free (command);
+  free (res_fname);
   return 0;
 }
 
@@ -1819,10 +1831,7 @@ int
 test_satisfiability (int nbv, int nbc, char *fname)
 {
   // print the prefix file for sat
-  char *fname_pre = (char *) malloc ((strlen (fname) + 5) * sizeof (char));
-  memset (fname_pre, 0, (strlen (fname) + 5) * sizeof (char));
-  // fname_pre[0] = '\0';
-  sprintf (fname_pre, "pre_%s", fname);
+  char *fname_pre = noll_scratch_path ("pre_", fname);
   FILE *out = fopen (fname_pre, "w");
   fprintf (out, "p cnf %d %d\n", nbv, nbc);
 #ifndef NDEBUG
@@ -1832,28 +1841,32 @@ test_satisfiability (int nbv, int nbc, char *fname)
   }
 #endif
   fclose (out);
-  free (fname_pre);
 
   // build the final file for sat using cat
-  char *command =
-    (char *) malloc ((100 + 3 * strlen (fname)) * sizeof (char));
-  memset (command, 0, (100 + 3 * strlen (fname)) * sizeof (char));
-  //command[0] = '\0';
-  sprintf (command, "cat pre_%s %s 1> sat_%s", fname, fname, fname);
+  char *abstr_fname = noll_scratch_path ("", fname);
+  char *sat_fname = noll_scratch_path ("sat_", fname);
+  char *res_fname = noll_scratch_path ("result_", fname);
+  char *msat_fname = noll_scratch_path ("msat_", fname);
+  size_t command_len = 100 + strlen (fname_pre) + strlen (abstr_fname)
+    + strlen (sat_fname) + strlen (res_fname) + strlen (msat_fname);
+  char *command = (char *) malloc (command_len * sizeof (char));
+  memset (command, 0, command_len * sizeof (char));
+  sprintf (command, "cat %s %s 1> %s", fname_pre, abstr_fname, sat_fname);
+  free (fname_pre);
+  free (abstr_fname);
   if (system (command) != -1)
     {
 
       // print the minisat command
-      memset (command, 0, (100 + 3 * strlen (fname)) * sizeof (char));
-      //command[0] = '\0';
-      sprintf (command, "minisat -verb=0 sat_%s result.txt 1> msat_%s",
-               fname, fname);
+      memset (command, 0, command_len * sizeof (char));
+      sprintf (command, "minisat -verb=0 %s %s 1> %s",
+               sat_fname, res_fname, msat_fname);
 
       //call minisat
       if (system (command) != -1)
         {
           FILE *res;
-          res = fopen ("result.txt", "r");
+          res = fopen (res_fname, "r");
           char *s = malloc (10 * sizeof (char));
           s[9] = '\0';
           fgets (s, 10, res);
@@ -1865,12 +1878,18 @@ test_satisfiability (int nbv, int nbc, char *fname)
 
               free (command);
               free (s);
+              free (sat_fname);
+              free (res_fname);
+              free (msat_fname);
               return 0;
             }
           free (s);
         }
     }
   free (command);
+  free (sat_fname);
+  free (res_fname);
+  free (msat_fname);
   return 1;
 }
 
@@ -1911,12 +1930,10 @@ normalize (noll_form_t * form, char *fname)
    */
 #ifndef NDEBUG
   //all (in)equalities are written in the file "($fname)_inc.txt"
-  char *fname_inc = (char *) malloc ((strlen (fname) + 20) * sizeof (char));
-  memset (fname_inc, 0, (strlen (fname) + 20) * sizeof (char));
-  // fname_pre[0] = '\0';
-  sprintf (fname_inc, "%s_inc.txt", fname);
+  char *fname_inc = noll_scratch_path ("inc_txt_", fname);
 
   FILE *inc = fopen (fname_inc, "w");
+  free (fname_inc);
   int counter = 0;
 #endif
 
@@ -1931,8 +1948,7 @@ normalize (noll_form_t * form, char *fname)
           fflush (stdout);
         }
 #endif
-        if ((form->pure->m[i][j - i] != NOLL_PURE_EQ)
-            && (form->pure->m[i][j - i] != NOLL_PURE_NEQ))
+        if (noll_pure_matrix_at (form->pure, i, j) == NOLL_PURE_OTHER)
           {
             uint_t type_i =
               noll_vector_at (noll_vector_at (form->lvars, i)->vty->args,
@@ -1941,7 +1957,7 @@ normalize (noll_form_t * form, char *fname)
               noll_vector_at (noll_vector_at (form->lvars, j)->vty->args,
                               0);
             if (type_i != type_j)       //variables of different types
-              form->pure->m[i][j - i] = NOLL_PURE_NEQ;
+              noll_pure_matrix_set (form->pure, i, j, NOLL_PURE_NEQ);
             else
               {                 //variables of the same type
 #ifndef NDEBUG
@@ -1975,7 +1991,7 @@ normalize (noll_form_t * form, char *fname)
                                noll_vector_at (form->lvars, j)->vname);
                     }
 #endif
-                    form->pure->m[i][j - i] = NOLL_PURE_EQ;
+                    noll_pure_matrix_set (form->pure, i, j, NOLL_PURE_EQ);
                   }
 #ifndef NDEBUG
                 else
@@ -2008,7 +2024,7 @@ normalize (noll_form_t * form, char *fname)
                                noll_vector_at (form->lvars, j)->vname);
                     }
 #endif
-                    form->pure->m[i][j - i] = NOLL_PURE_NEQ;
+                    noll_pure_matrix_set (form->pure, i, j, NOLL_PURE_NEQ);
                   }
 #ifndef NDEBUG
                 else
@@ -2067,10 +2083,7 @@ normalize_incremental (noll_form_t * form, char *fname)
    * Checking the implied (in)equalities
    */
   //all (in)equalities are written in the file "($fname)_inc.txt"
-  char *fname_inc = (char *) malloc ((strlen (fname) + 20) * sizeof (char));
-  memset (fname_inc, 0, (strlen (fname) + 20) * sizeof (char));
-  // fname_pre[0] = '\0';
-  sprintf (fname_inc, "inc_%s", fname);
+  char *fname_inc = noll_scratch_path ("inc_", fname);
 
   FILE *inc = fopen (fname_inc, "w");
 
@@ -2089,8 +2102,7 @@ normalize_incremental (noll_form_t * form, char *fname)
           fflush (stdout);
         }
 #endif
-        if ((form->pure->m[i][j - i] != NOLL_PURE_EQ)
-            && (form->pure->m[i][j - i] != NOLL_PURE_NEQ))
+        if (noll_pure_matrix_at (form->pure, i, j) == NOLL_PURE_OTHER)
           {
             uint_t type_i =
               noll_vector_at (noll_vector_at (form->lvars, i)->vty->args,
@@ -2099,7 +2111,7 @@ normalize_incremental (noll_form_t * form, char *fname)
               noll_vector_at (noll_vector_at (form->lvars, j)->vty->args,
                               0);
             if (type_i != type_j)       //variables of different types
-              form->pure->m[i][j - i] = NOLL_PURE_NEQ;
+              noll_pure_matrix_set (form->pure, i, j, NOLL_PURE_NEQ);
             else
               {                 //variables of the same type
 #ifndef NDEBUG
@@ -2132,39 +2144,36 @@ normalize_incremental (noll_form_t * form, char *fname)
       }
 
   fclose (inc);
-  free (fname_inc);
 
-  char *fname_pre = (char *) malloc ((strlen (fname) + 5) * sizeof (char));
-  memset (fname_pre, 0, (strlen (fname) + 5) * sizeof (char));
-  // fname_pre[0] = '\0';
-  sprintf (fname_pre, "pre_%s", fname);
+  char *fname_pre = noll_scratch_path ("pre_", fname);
   FILE *out = fopen (fname_pre, "w");
   fprintf (out, "p inccnf\n");
   fclose (out);
-  free (fname_pre);
 
   // build the final file for sat using cat
-  char *command = (char *) calloc ((100 + 4 * strlen (fname)), sizeof (char));
-  memset (command, 0, (100 + 4 * strlen (fname)) * sizeof (char));
-  sprintf (command, "cat pre_%s %s inc_%s 1> full_%s", fname, fname, fname,
-           fname);
+  char *abstr_fname = noll_scratch_path ("", fname);
+  char *full_fname = noll_scratch_path ("full_", fname);
+  char *fname_res = noll_scratch_path ("results_", fname);
+  size_t command_len = 100 + strlen (fname_pre) + strlen (abstr_fname)
+    + strlen (fname_inc) + strlen (full_fname) + strlen (fname_res);
+  char *command = (char *) calloc (command_len, sizeof (char));
+  sprintf (command, "cat %s %s %s 1> %s", fname_pre, abstr_fname, fname_inc,
+           full_fname);
+  free (fname_pre);
+  free (abstr_fname);
+  free (fname_inc);
   if (system (command) == -1)
     assert (0);
 
   // print the minisat command
-  memset (command, 0, (100 + 4 * strlen (fname)) * sizeof (char));
-  sprintf (command, "minisat_inc -verb=0 full_%s 1> results_%s",
-           fname, fname);
+  memset (command, 0, command_len * sizeof (char));
+  sprintf (command, "minisat_inc -verb=0 %s 1> %s", full_fname, fname_res);
+  free (full_fname);
   if (system (command) == -1)
     assert (0);
 
   FILE *res;
 
-  char *fname_res = (char *) malloc ((strlen (fname) + 20) * sizeof (char));
-  memset (fname_res, 0, (strlen (fname) + 20) * sizeof (char));
-  // fname_pre[0] = '\0';
-  sprintf (fname_res, "results_%s", fname);
-
   res = fopen (fname_res, "r");
 
   char *temp = malloc (100 * sizeof (char));
@@ -2212,14 +2221,8 @@ normalize_incremental (noll_form_t * form, char *fname)
                      noll_vector_at (form->lvars, atoms_array[k].y)->vname);
           }
 #endif
-          if (atoms_array[k].x <= atoms_array[k].y)
-            form->pure->m[atoms_array[k].x][atoms_array[k].y
-                                            - atoms_array[k].x] =
-              atoms_array[k].sign;
-          else
-            form->pure->m[atoms_array[k].y][atoms_array[k].x
-                                            - atoms_array[k].y] =
-              atoms_array[k].sign;
+          noll_pure_matrix_set (form->pure, atoms_array[k].x,
+                                atoms_array[k].y, atoms_array[k].sign);
         }
     }
   free (temp);
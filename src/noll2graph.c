@@ -38,11 +38,8 @@ noll_nodes_of_form (noll_form_t * phi, uint_t * vars)
     {
       for (uint_t i = 0; i < phi->pure->size; i++)
         {
-          // search the first variable equal to this one
-          uint_t min = 0;
-          for (min = 0; min < i; min++)
-            if (phi->pure->m[min][i - min] == NOLL_PURE_EQ)
-              break;
+          // the first variable equal to this one is the root of its class
+          uint_t min = noll_pure_find (phi->pure, i);
           if (min == i)
             {
               // set node in the locs_vars
@@ -168,26 +165,13 @@ noll_graph_of_space (noll_space_t * phi, bool isMatrix,
             uint_t ndst = g->var2node[noll_vector_at (phi->m.pto.dest, i)];
             assert (ndst < g->nodes_size);
             // build the edge
-            noll_edge_t *e = noll_edge_alloc (NOLL_EDGE_PTO, nsrc, ndst, fi);
+            noll_edge_t *e = noll_edge_alloc (g->arena, NOLL_EDGE_PTO, nsrc,
+                                              ndst, fi);
             e->id = nedges + i;
             // push edge in graph
             noll_edge_array_push (g->edges, e);
             // push its identifier in the result
             noll_uid_array_push (res, e->id);
-            // push the edge id in the matrix at entry nsrc
-            noll_uid_array *src_edges = g->mat[nsrc];
-            if (src_edges == NULL)
-              {
-                src_edges = g->mat[nsrc] = noll_uid_array_new ();
-              }
-            noll_uid_array_push (src_edges, e->id);
-            // push the edge id in the reverse matrix at entry ndst
-            noll_uid_array *dst_edges = g->rmat[ndst];
-            if (dst_edges == NULL)
-              {
-                dst_edges = g->rmat[ndst] = noll_uid_array_new ();
-              }
-            noll_uid_array_push (dst_edges, e->id);
           }
         break;
       }
@@ -292,7 +276,8 @@ noll_graph_of_space (noll_space_t * phi, bool isMatrix,
 
         /// build the edge
         noll_edge_t *e =
-          noll_edge_alloc (NOLL_EDGE_PRED, nsrc, ndst, phi->m.ls.pid);
+          noll_edge_alloc (g->arena, NOLL_EDGE_PRED, nsrc, ndst,
+                           phi->m.ls.pid);
         uint_t i = (noll_pred_isUnaryLoc (phi->m.ls.pid) == true) ? 1 : 2;
         for (; i < noll_vector_size (phi->m.ls.args); i++)
           noll_uid_array_push (e->args,
@@ -303,20 +288,6 @@ noll_graph_of_space (noll_space_t * phi, bool isMatrix,
         noll_edge_array_push (g->edges, e);
         // push its identifier in the result
         noll_uid_array_push (res, e->id);
-        // push the edgeid in the matrix at entry nsrc
-        noll_uid_array *src_edges = g->mat[nsrc];
-        if (src_edges == NULL)
-          {
-            src_edges = g->mat[nsrc] = noll_uid_array_new ();
-          }
-        noll_uid_array_push (src_edges, e->id);
-        // push the edgeid in the reverse matrix at entry ndst
-        noll_uid_array *dst_edges = g->rmat[ndst];
-        if (dst_edges == NULL)
-          {
-            dst_edges = g->rmat[ndst] = noll_uid_array_new ();
-          }
-        noll_uid_array_push (dst_edges, e->id);
         // fill the bounded sloc variable
         e->bound_svar = phi->m.ls.sid;
 
@@ -389,12 +360,9 @@ noll_graph_of_pure (noll_pure_t * phi, noll_graph_t * g)
       for (uint_t j = i + 1; j < phi->size; j++)
         {
           uint_t nj = g->var2node[j];
-          if (phi->m[i][j - i] == NOLL_PURE_NEQ)
+          if (noll_pure_matrix_at (phi, i, j) == NOLL_PURE_NEQ)
             {
-              if (ni <= nj)
-                g->diff[nj][ni] = true;
-              else
-                g->diff[ni][nj] = true;
+              noll_graph_set_diff (g, ni, nj);
             }
 
         }
@@ -414,7 +382,9 @@ noll_graph_of_form (noll_form_t * phi, bool isMatrix)
       fprintf (stdout, "noll_graph_of_form: NULL formula\n");
 #endif
       // emp formula, build empty graph
-      return noll_graph_alloc (NULL, NULL, 0, 0, NULL);
+      noll_graph_t *emp = noll_graph_alloc (NULL, NULL, 0, 0, NULL);
+      noll_graph_freeze (emp);
+      return emp;
     }
 
   if (phi->kind == NOLL_FORM_UNSAT)
@@ -473,6 +443,9 @@ noll_graph_of_form (noll_form_t * phi, bool isMatrix)
   /// aliasing of sharing constraints in the graph
   noll_share_array_copy (res->share, phi->share);
 
+  /// build the adjacency of nodes
+  noll_graph_freeze (res);
+
   // TODO: sort variables and
   // TODO: apply permutation obtained on
   //       - edges (for list segments indexed by svars)
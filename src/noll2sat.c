@@ -20,8 +20,12 @@
  * Building the boolean abstraction of NOLL formula.
  */
 
+#include <stdarg.h>
+#include <string.h>
+
 #include "noll2sat.h"
 #include "noll_option.h"
+#include "noll_scratch.h"
 
 NOLL_VECTOR_DEFINE (noll_sat_pure_array, noll_sat_pure_t *);
 
@@ -29,6 +33,8 @@ NOLL_VECTOR_DEFINE (noll_sat_space_array, noll_sat_space_t *);
 
 NOLL_VECTOR_DEFINE (noll_sat_in_array, noll_sat_in_t *);
 
+NOLL_VECTOR_DEFINE (noll_lit_array, minisat_lit_t);
+
 NOLL_VECTOR_DEFINE (noll_sat_array, noll_sat_t *);
 
 /* ====================================================================== */
@@ -45,12 +51,23 @@ noll_sat_new (noll_form_t * phi)
 
   fsat->form = phi;
   fsat->fname = NULL;
+  fsat->lits = NULL;
+  fsat->clauses = NULL;
+  fsat->lazy = false;
+  fsat->lazy_lits = NULL;
+  fsat->lazy_clauses = NULL;
+  fsat->solver = NULL;
+  fsat->arena = noll_arena_new ();
   fsat->finfo = NULL;
   fsat->var_pure = NULL;
   fsat->var_pto = NULL;
   fsat->var_pred = NULL;
   fsat->var_apto = NULL;
   fsat->var_inset = NULL;
+  fsat->idx_pto.slots = NULL;
+  fsat->idx_pred.slots = NULL;
+  fsat->idx_apto.slots = NULL;
+  fsat->idx_inset.slots = NULL;
   return fsat;
 }
 
@@ -64,8 +81,21 @@ noll_sat_free (noll_sat_t * fsat)
     return;
 
   fsat->fname = NULL;
-  if (fsat->file != NULL)
-    fclose (fsat->file);
+  if (fsat->lits != NULL)
+    noll_lit_array_delete (fsat->lits);
+  fsat->lits = NULL;
+  if (fsat->clauses != NULL)
+    noll_uint_array_delete (fsat->clauses);
+  fsat->clauses = NULL;
+  if (fsat->lazy_lits != NULL)
+    noll_lit_array_delete (fsat->lazy_lits);
+  fsat->lazy_lits = NULL;
+  if (fsat->lazy_clauses != NULL)
+    noll_uint_array_delete (fsat->lazy_clauses);
+  fsat->lazy_clauses = NULL;
+  if (fsat->solver != NULL)
+    minisat_free_solver (fsat->solver);
+  fsat->solver = NULL;
 
   if (fsat->finfo != NULL)
     {
@@ -81,27 +111,14 @@ noll_sat_free (noll_sat_t * fsat)
       fsat->finfo = NULL;
     }
 
-  if (fsat->var_pure != NULL)
-    {
-      for (uint_t i = 0; i < noll_vector_size (fsat->form->lvars); i++)
-        {
-          if (fsat->var_pure[i] != NULL)
-            free (fsat->var_pure[i]);
-          fsat->var_pure[i] = NULL;
-        }
-      free (fsat->var_pure);
-      fsat->var_pure = NULL;
-    }
-
+  /* the encodings of atoms are in the arena */
   fsat->form = NULL;
-  if (fsat->var_pto != NULL)
-    noll_sat_space_array_delete (fsat->var_pto);
-  if (fsat->var_pred != NULL)
-    noll_sat_space_array_delete (fsat->var_pred);
-  if (fsat->var_apto != NULL)
-    noll_sat_space_array_delete (fsat->var_apto);
-  if (fsat->var_inset != NULL)
-    noll_sat_in_array_delete (fsat->var_inset);
+  fsat->var_pure = NULL;
+  fsat->var_pto = NULL;
+  fsat->var_pred = NULL;
+  fsat->var_apto = NULL;
+  fsat->var_inset = NULL;
+  noll_arena_delete (fsat->arena);
 
   free (fsat);
 }
@@ -297,105 +314,198 @@ noll_sat_space_array_sort (noll_sat_space_array * a)
 #endif
 }
 
-uint_t
-noll_sat_space_array_bsearch (noll_sat_space_array * a,
-                              noll_sat_space_t * target)
-{
-  if (noll_vector_size (a) == 0)
-    return 0;
-#ifndef NDEBUG
-  /*
-     fprintf (stdout, "++++ bsearch of ");
-     noll_space_fprint(stdout, target->forig);
-     fprintf (stdout, " in [");
-     for (uint_t i = 0; i < noll_vector_size(a); i++)
-     noll_space_fprint(stdout, noll_vector_at(a,i)->forig);
-     fprintf (stdout, "]\n");
-     fflush (stdout);
-   */
-#endif
+/* ====================================================================== */
+/* Index of boolean variables */
+/* ====================================================================== */
 
-  uint_t min = 0;
-  uint_t max = noll_vector_size (a) - 1;
-  uint_t pos = 0;
-  while (min < max)
+/**
+ * Key of @p a, the values compared by noll_sat_space_cmp.
+ */
+static void
+noll_sat_space_key (noll_sat_space_t * a, uid_t * k)
+{
+  noll_space_t *f = a->forig;
+  if (f->kind == NOLL_SPACE_PTO)
     {
-      pos = min + ((max - min) / 2);
-      int cmp = noll_sat_space_cmp (noll_vector_at (a, pos), target);
-#ifndef NDEBUG
-      /*
-         fprintf (stdout, "++++ bsearch space between: %d,%d at pos %d\n", min, max, pos);
-         fprintf (stdout, "++++ space compare: return %d\n", cmp);
-       */
-#endif
-      if (cmp < 0)
-        min = pos + 1;
-      else if (cmp > 0)
-        max = pos - 1;
-      else
-        min = max = pos;
+      k[0] = f->m.pto.sid;
+      k[1] = noll_vector_at (f->m.pto.fields, a->m.idx);
+      k[2] = UNDEFINED_ID;
+    }
+  else if (a->m.p.var == UNDEFINED_ID)
+    {
+      k[0] = noll_vector_at (f->m.ls.args, 0);
+      k[1] = f->m.ls.pid;
+      k[2] = f->m.ls.sid;
     }
-  // position is at min = max
-  if (noll_sat_space_cmp (noll_vector_at (a, min), target) != 0)
-    pos = noll_vector_size (a); // unknown
   else
-    pos = min;
-  return pos;
+    {
+      k[0] = a->m.p.var;
+      k[1] = a->m.p.fld;
+      k[2] = f->m.ls.sid;
+    }
 }
 
-uint_t
-noll_sat_in_array_bsearch (noll_sat_in_array * a, uint_t x, uint_t alpha)
+static uint_t
+noll_sat_index_hash (const uid_t * k)
+{
+  uint_t h = k[0] * 0x9e3779b1u;
+  h = (h ^ k[1]) * 0x85ebca6bu;
+  h = (h ^ k[2]) * 0xc2b2ae35u;
+  return h ^ (h >> 16);
+}
+
+/**
+ * Allocate in @p a the slots of index @p idx for @p n keys.
+ */
+static void
+noll_sat_index_init (noll_arena_t * a, noll_sat_index_t * idx, uint_t n)
+{
+  uint_t size = 8;
+  while (size < 2 * n)
+    size *= 2;
+  idx->mask = size - 1;
+  idx->slots = (noll_sat_index_slot_t *)
+    noll_arena_calloc (a, size, sizeof (noll_sat_index_slot_t));
+}
+
+/**
+ * Map @p k to @p bvar in @p idx, keep the first variable for a key.
+ */
+static void
+noll_sat_index_put (noll_sat_index_t * idx, const uid_t * k, uint_t bvar)
+{
+  assert (bvar != 0);
+  uint_t i = noll_sat_index_hash (k) & idx->mask;
+  for (; idx->slots[i].bvar != 0; i = (i + 1) & idx->mask)
+    {
+      uid_t *ki = idx->slots[i].k;
+      if (ki[0] == k[0] && ki[1] == k[1] && ki[2] == k[2])
+        return;
+    }
+  idx->slots[i].k[0] = k[0];
+  idx->slots[i].k[1] = k[1];
+  idx->slots[i].k[2] = k[2];
+  idx->slots[i].bvar = bvar;
+}
+
+/**
+ * Boolean variable of @p k in @p idx, 0 if not encoded.
+ */
+static uint_t
+noll_sat_index_get (const noll_sat_index_t * idx, const uid_t * k)
 {
-  if (noll_vector_size (a) == 0)
+  if (idx->slots == NULL)
     return 0;
-#ifndef NDEBUG
-  /*
-     fprintf (stdout, "++++ bsearch of (%d,%d) in [", x, alpha);
-     for (uint_t i = 0; i < noll_vector_size(a); i++)
-     fprintf (stdout, "(%d,%d),", noll_vector_at(a,i)->x, noll_vector_at(a,i)->alpha);
-     fprintf (stdout, "]\n");
-     fflush (stdout);
-   */
-#endif
-  uint_t min = 0;
-  uint_t max = noll_vector_size (a) - 1;
-  uint_t pos = 0;
-  while (min < max)
+  uint_t i = noll_sat_index_hash (k) & idx->mask;
+  for (; idx->slots[i].bvar != 0; i = (i + 1) & idx->mask)
     {
-      pos = min + ((max - min) / 2);
-      int cmp = 0;
-      noll_sat_in_t *a_pos = noll_vector_at (a, pos);
-      if (a_pos->x < x)
-        cmp = -1;
-      else if (a_pos->x > x)
-        cmp = 1;
-      else
-        {                       // x == a_pos->x
-          if (a_pos->alpha < alpha)
-            cmp = -1;
-          else if (a_pos->alpha > alpha)
-            cmp = 1;
-        }
-#ifndef NDEBUG
-      /*
-         fprintf (stdout, "++++ bsearch space between: %d,%d at pos %d\n", min, max, pos);
-         fprintf (stdout, "++++ space compare: return %d\n", cmp);
-       */
-#endif
-      if (cmp < 0)
-        min = pos + 1;
-      else if (cmp > 0)
-        max = pos - 1;
-      else
-        min = max = pos;
+      const uid_t *ki = idx->slots[i].k;
+      if (ki[0] == k[0] && ki[1] == k[1] && ki[2] == k[2])
+        return idx->slots[i].bvar;
     }
-  // position is at min = max
-  if ((noll_vector_at (a, min)->x != x)
-      || (noll_vector_at (a, min)->alpha != alpha))
-    pos = noll_vector_size (a); // unknown
+  return 0;
+}
+
+/**
+ * Index the atoms of @p arr, encoded from @p start, in @p idx.
+ */
+static void
+noll_sat_space_array_index (noll_arena_t * a, noll_sat_index_t * idx,
+                            noll_sat_space_array * arr, uint_t start)
+{
+  noll_sat_index_init (a, idx, noll_vector_size (arr));
+  for (uint_t i = 0; i < noll_vector_size (arr); i++)
+    {
+      uid_t k[3];
+      noll_sat_space_key (noll_vector_at (arr, i), k);
+      noll_sat_index_put (idx, k, start + i);
+    }
+}
+
+/* ====================================================================== */
+/* Clauses */
+/* ====================================================================== */
+
+/**
+ * Add the literal @p lit to the clause being built.
+ * The clause is ended only by noll2sat_end, thus 0 (i.e., a variable
+ * not found by a getter) is an error, also in release builds.
+ */
+static void
+noll2sat_lit (noll_sat_t * fsat, int lit)
+{
+  assert (lit != 0);
+  if (lit == 0)
+    {
+      fprintf (stderr, "Literal without boolean variable! quit.\n");
+      exit (1);
+    }
+  noll_lit_array_push ((fsat->lazy) ? fsat->lazy_lits : fsat->lits, lit);
+}
+
+/**
+ * End the clause being built.
+ */
+static void
+noll2sat_end (noll_sat_t * fsat)
+{
+  if (fsat->lazy)
+    noll_uint_array_push (fsat->lazy_clauses,
+                          noll_vector_size (fsat->lazy_lits));
   else
-    pos = min;
-  return pos;
+    noll_uint_array_push (fsat->clauses, noll_vector_size (fsat->lits));
+}
+
+/**
+ * Add the clause built from the @p size literals (int) following.
+ */
+static void
+noll2sat_clause (noll_sat_t * fsat, uint_t size, ...)
+{
+  va_list ap;
+  va_start (ap, size);
+  for (uint_t i = 0; i < size; i++)
+    noll2sat_lit (fsat, va_arg (ap, int));
+  va_end (ap);
+  noll2sat_end (fsat);
+}
+
+/**
+ * True if no clause is being built.
+ */
+static bool
+noll2sat_is_closed (noll_sat_t * fsat)
+{
+  return (fsat->clauses != NULL)
+    && (noll_vector_last (fsat->clauses) == noll_vector_size (fsat->lits))
+    && ((fsat->lazy_clauses == NULL)
+        || (noll_vector_last (fsat->lazy_clauses) ==
+            noll_vector_size (fsat->lazy_lits)));
+}
+
+/**
+ * New auxiliary boolean variable, not encoding an atom.
+ */
+static uint_t
+noll2sat_fresh (noll_sat_t * fsat)
+{
+  return fsat->no_vars++;
+}
+
+void
+noll2sat_fprint (FILE * f, noll_sat_t * fsat)
+{
+  assert (noll2sat_is_closed (fsat));
+
+  uint_t size = noll_vector_size (fsat->clauses) - 1;
+  fprintf (f, "p cnf %d %d\n", fsat->no_vars - 1, size);
+  for (uint_t c = 0; c < size; c++)
+    {
+      for (uint_t l = noll_vector_at (fsat->clauses, c);
+           l < noll_vector_at (fsat->clauses, c + 1); l++)
+        fprintf (f, "%d ", noll_vector_at (fsat->lits, l));
+      fprintf (f, "0\n");
+    }
 }
 
 /* ====================================================================== */
@@ -489,8 +599,8 @@ noll2sat_info_space (noll_space_t * f, noll_sat_t * res)
               res->finfo->used_flds[fi] = true;
               res->finfo->fld_size++;
             }
-          noll_sat_space_t *pto_i =
-            (noll_sat_space_t *) malloc (sizeof (noll_sat_space_t));
+          noll_sat_space_t *pto_i = (noll_sat_space_t *)
+            noll_arena_alloc (res->arena, sizeof (noll_sat_space_t));
           pto_i->forig = f;
           pto_i->m.idx = i;
           noll_sat_space_array_push (res->var_pto, pto_i);
@@ -518,8 +628,8 @@ noll2sat_info_space (noll_space_t * f, noll_sat_t * res)
               res->finfo->lvar_size++;
             }
         }
-      noll_sat_space_t *pred =
-        (noll_sat_space_t *) malloc (sizeof (noll_sat_space_t));
+      noll_sat_space_t *pred = (noll_sat_space_t *)
+        noll_arena_alloc (res->arena, sizeof (noll_sat_space_t));
       pred->forig = f;
       pred->m.p.var = UNDEFINED_ID;
       pred->m.p.fld = UNDEFINED_ID;
@@ -642,18 +752,16 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
   noll_sat_t *res = (noll_sat_t *) malloc (sizeof (noll_sat_t));
   res->form = form;
   res->fname = fname;           /* TODO: copy? */
-  res->file = fopen (fname, "w");
-  if (res->file == NULL)
-    {
-#ifndef NDEBUG
-    if (noll_option_is_diag())
-    {
-      fprintf (stdout, "\nError: while open file %s! quit.\n", fname);
-    }
-#endif
-      free (res);
-      return NULL;
-    }
+  /* clauses are kept in memory and loaded in the solver when needed */
+  res->lits = noll_lit_array_new ();
+  res->clauses = noll_uint_array_new ();
+  noll_uint_array_push (res->clauses, 0);
+  res->lazy = false;
+  res->lazy_lits = noll_lit_array_new ();
+  res->lazy_clauses = noll_uint_array_new ();
+  noll_uint_array_push (res->lazy_clauses, 0);
+  res->solver = NULL;
+  res->arena = noll_arena_new ();
 
   res->finfo = noll2sat_info_alloc (form);
 
@@ -661,20 +769,23 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
   res->no_vars = 0;             /* max used number for boolean vars */
 
   // fill infos about formula, including var_pto and var_pred arrays
-  res->var_pto = noll_sat_space_array_new ();
-  res->var_pred = noll_sat_space_array_new ();
+  res->var_pto = noll_sat_space_array_new_in (res->arena);
+  res->var_pred = noll_sat_space_array_new_in (res->arena);
   noll2sat_info (form, res);
 
   /* fill bvars used for [x = y] encoding only for used variables in phi */
   res->start_pure = 1;          /* 0 index is used to signal clause end */
   res->size_pure = 0;
   res->size_var_pure = noll_vector_size (form->lvars);
-  res->var_pure = (uint_t **) malloc (sizeof (uint_t *) * res->size_var_pure);
+  res->var_pure = (uint_t **) noll_arena_alloc (res->arena, sizeof (uint_t *)
+                                                * res->size_var_pure);
   for (uint_t i = 0; i < res->size_var_pure; i++)
     {
       if (res->finfo->used_lvar[i] == true)
         {
-          res->var_pure[i] = (uint_t *) malloc (sizeof (uint_t) * (i + 1));
+          res->var_pure[i] = (uint_t *) noll_arena_alloc (res->arena,
+                                                          sizeof (uint_t)
+                                                          * (i + 1));
           for (uint_t j = 0; j <= i; j++)
             {
               if (res->finfo->used_lvar[j] == true)
@@ -694,17 +805,21 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
   res->size_pto = res->finfo->pto_size;
   noll_sat_space_array_resize (res->var_pto, res->size_pto);
   noll_sat_space_array_sort (res->var_pto);
+  noll_sat_space_array_index (res->arena, &res->idx_pto, res->var_pto,
+                              res->start_pto);
 
   /* fill bvars used for ls atoms in form */
   res->start_pred = res->start_pto + res->size_pto;
   res->size_pred = res->finfo->ls_size;
   noll_sat_space_array_resize (res->var_pred, res->size_pred);
   noll_sat_space_array_sort (res->var_pred);
+  noll_sat_space_array_index (res->arena, &res->idx_pred, res->var_pred,
+                              res->start_pred);
 
   /* fill bvars used for anonymous points-to constraints [x,f,space_atom] */
   res->start_apto = res->start_pred + res->size_pred;
   res->size_apto = 0;           /* computed below */
-  res->var_apto = noll_sat_space_array_new ();
+  res->var_apto = noll_sat_space_array_new_in (res->arena);
   // ignore 'nil'
   for (uint_t xi = 1; xi < noll_vector_size (form->lvars); xi++)
     if (res->finfo->used_lvar[xi] == true)
@@ -729,9 +844,9 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
                       noll_vector_at (fields_array, fid)->src_r;
                     if (tid_x == fld_tid_src)
                       {
-                        noll_sat_space_t *new_sat =
-                          (noll_sat_space_t *)
-                          malloc (sizeof (noll_sat_space_t));
+                        noll_sat_space_t *new_sat = (noll_sat_space_t *)
+                          noll_arena_alloc (res->arena,
+                                            sizeof (noll_sat_space_t));
                         new_sat->forig = ls;
                         new_sat->m.p.var = xi;
                         new_sat->m.p.fld = fid;
@@ -744,11 +859,13 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
       }
   noll_sat_space_array_resize (res->var_apto, res->size_apto);
   noll_sat_space_array_sort (res->var_apto);
+  noll_sat_space_array_index (res->arena, &res->idx_apto, res->var_apto,
+                              res->start_apto);
 
   /* fill bvars used for sharing constraints [x in alpha] */
   res->start_inset = res->start_apto + res->size_apto;
   res->size_inset = 0;          // computed below
-  res->var_inset = noll_sat_in_array_new ();
+  res->var_inset = noll_sat_in_array_new_in (res->arena);
   /* the array is generated lexically sorted (x, alpha) */
   // ignore 'nil'
   for (uint_t xi = 1; xi < noll_vector_size (form->lvars); xi++)
@@ -761,7 +878,9 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
               if (res->finfo->used_svar[alpha_i] == true)
                 {
                   noll_sat_in_t *new_bvar =
-                    (noll_sat_in_t *) malloc (sizeof (noll_sat_in_t));
+                    (noll_sat_in_t *) noll_arena_alloc (res->arena,
+                                                        sizeof
+                                                        (noll_sat_in_t));
                   new_bvar->alpha = alpha_i;
                   new_bvar->x = xi;
                   noll_sat_in_array_push (res->var_inset, new_bvar);
@@ -772,6 +891,13 @@ noll2sat_fill_bvar (noll_form_t * form, char *fname)
     }
   noll_sat_in_array_resize (res->var_inset, res->size_inset);
   // already sorted
+  noll_sat_index_init (res->arena, &res->idx_inset, res->size_inset);
+  for (uint_t i = 0; i < res->size_inset; i++)
+    {
+      noll_sat_in_t *in_i = noll_vector_at (res->var_inset, i);
+      uid_t k[3] = { in_i->x, in_i->alpha, UNDEFINED_ID };
+      noll_sat_index_put (&res->idx_inset, k, res->start_inset + i);
+    }
 
   res->no_vars = res->start_inset + res->size_inset;
 
@@ -852,25 +978,14 @@ noll2sat_get_bvar_pto (noll_sat_t * fsat, noll_space_t * subform, uint_t i)
   assert (fsat != NULL);
   assert (subform != NULL);
 
-  /* Binary search of information in a sorted array and
-   * return the position in the array.
-   */
-  if (fsat->var_pto == NULL || noll_vector_size (fsat->var_pto) == 0)
-    return 0;
+  /* search the key of the atom in the index */
+  noll_sat_space_t target;
+  target.forig = subform;
+  target.m.idx = i;
 
-  noll_sat_space_t *target =
-    (noll_sat_space_t *) malloc (sizeof (noll_sat_space_t));
-  target->forig = subform;
-  target->m.idx = i;
-
-  uint_t pos = noll_sat_space_array_bsearch (fsat->var_pto, target);
-  if (pos < noll_vector_size (fsat->var_pto))
-    pos += fsat->start_pto;
-  else
-    pos = 0;
-  target->forig = NULL;
-  free (target);
-  return pos;
+  uid_t k[3];
+  noll_sat_space_key (&target, k);
+  return noll_sat_index_get (&fsat->idx_pto, k);
 }
 
 uint_t
@@ -885,24 +1000,14 @@ noll2sat_get_bvar_pred (noll_sat_t * fsat, noll_space_t * subform,
   assert (fsat != NULL);
   assert (subform != NULL);
 
-  /* Binary search of information in a sorted array and
-   * return the position in the array.
-   */
-  if (fsat->var_pred == NULL || noll_vector_size (fsat->var_pred) == 0)
-    return 0;
-  noll_sat_space_t *target =
-    (noll_sat_space_t *) malloc (sizeof (noll_sat_space_t));
-  target->forig = subform;
-  target->m.p.var = UNDEFINED_ID;
-
-  uint_t pos = noll_sat_space_array_bsearch (fsat->var_pred, target);
-  if (pos < noll_vector_size (fsat->var_pred))
-    pos += fsat->start_pred;
-  else
-    pos = 0;
-  target->forig = NULL;
-  free (target);
-  return pos;
+  /* search the key of the atom in the index */
+  noll_sat_space_t target;
+  target.forig = subform;
+  target.m.p.var = UNDEFINED_ID;
+
+  uid_t k[3];
+  noll_sat_space_key (&target, k);
+  return noll_sat_index_get (&fsat->idx_pred, k);
 }
 
 int
@@ -960,13 +1065,8 @@ noll2sat_get_bvar_in (noll_sat_t * fsat, uint_t x, uint_t alpha)
 {
   assert (fsat != NULL);
 
-  // binary search x in fsat->var_in
-  uint_t pos = noll_sat_in_array_bsearch (fsat->var_inset, x, alpha);
-  if (pos < noll_vector_size (fsat->var_inset))
-    pos += fsat->start_inset;
-  else
-    pos = 0;
-  return pos;
+  uid_t k[3] = { x, alpha, UNDEFINED_ID };
+  return noll_sat_index_get (&fsat->idx_inset, k);
 }
 
 uint_t
@@ -976,24 +1076,15 @@ noll2sat_get_bvar_apto (noll_sat_t * fsat, uint_t x, uint_t f,
   assert (fsat != NULL);
   assert (forig != NULL);
 
-  /* Binary search of information in a sorted array and
-   * return the position in the array.
-   */
-  if (fsat->var_apto == NULL || noll_vector_size (fsat->var_apto) == 0)
-    return 0;
-  noll_sat_space_t *target =
-    (noll_sat_space_t *) malloc (sizeof (noll_sat_space_t));
-  target->forig = forig;
-  target->m.p.var = x;
-  target->m.p.fld = f;
-
-  uint_t pos = noll_sat_space_array_bsearch (fsat->var_apto, target);
-  if (pos < noll_vector_size (fsat->var_apto))
-    pos += fsat->start_apto;
-  else
-    pos = 0;
-  free (target);
-  return pos;
+  /* search the key of the atom in the index */
+  noll_sat_space_t target;
+  target.forig = forig;
+  target.m.p.var = x;
+  target.m.p.fld = f;
+
+  uid_t k[3];
+  noll_sat_space_key (&target, k);
+  return noll_sat_index_get (&fsat->idx_apto, k);
 }
 
 /* ====================================================================== */
@@ -1046,6 +1137,8 @@ noll2sat (noll_form_t * form, char *fname)
     fprintf (stdout, "---- F_det\n");
   }
 #endif
+  /* F_det and F(Lambda) are loaded in the solver on demand */
+  fsat->lazy = noll_option_is_enc_lazy ();
   nb_clauses = noll2sat_det (fsat);
 #ifndef NDEBUG
   if (noll_option_is_diag())
@@ -1055,6 +1148,7 @@ noll2sat (noll_form_t * form, char *fname)
   }
 #endif
   nb_clauses = noll2sat_share (fsat);
+  fsat->lazy = false;
 #ifndef NDEBUG
   if (noll_option_is_diag())
   {
@@ -1062,8 +1156,7 @@ noll2sat (noll_form_t * form, char *fname)
     fprintf (stdout, "Clauses for final formula = %d\n", fsat->no_clauses);
   }
 #endif
-  fclose (fsat->file);
-  fsat->file = NULL;
+  assert (noll2sat_is_closed (fsat));
 
   // DO NOT free the boolean abstraction, fsat, needed further
   return fsat;
@@ -1076,7 +1169,7 @@ int
 noll2sat_pure (noll_sat_t * fsat)
 {
   assert (fsat != NULL);
-  assert (fsat->file != NULL);
+  assert (fsat->lits != NULL);
   assert (fsat->form != NULL);
 
   // variables shall be generated
@@ -1104,7 +1197,7 @@ noll2sat_pure (noll_sat_t * fsat)
         {
           // write reflexivity
           uint_t eq_i_i = noll2sat_get_bvar_eq (fsat, i, i);
-          fprintf (fsat->file, "%d 0\n", eq_i_i);
+          noll2sat_clause (fsat, 1, eq_i_i);
           nb_clauses++;
 
           // write pure formula and transitivity
@@ -1128,7 +1221,7 @@ noll2sat_pure (noll_sat_t * fsat)
                         fprintf (stdout, "---- pure: [x%d = x%d]\n", i, j);
                       }
 #endif
-                      fprintf (fsat->file, "%d 0\n", eq_i_j);
+                      noll2sat_clause (fsat, 1, eq_i_j);
                       nb_clauses++;
                     }
                   else if (op == NOLL_PURE_NEQ)
@@ -1139,7 +1232,7 @@ noll2sat_pure (noll_sat_t * fsat)
                         fprintf (stdout, "---- pure: [x%d <> x%d]\n", i, j);
                       }
 #endif
-                      fprintf (fsat->file, "-%d 0\n", eq_i_j);
+                      noll2sat_clause (fsat, 1, -(int) eq_i_j);
                       nb_clauses++;
                     }
 
@@ -1148,7 +1241,7 @@ noll2sat_pure (noll_sat_t * fsat)
                   if ((typ_i != NOLL_TYP_VOID) &&
                       (typ_j != NOLL_TYP_VOID) && (typ_i != typ_j))
                     {
-                      fprintf (fsat->file, "-%d 0\n", eq_i_j);
+                      noll2sat_clause (fsat, 1, -(int) eq_i_j);
                       nb_clauses++;
                     }
 
@@ -1161,8 +1254,8 @@ noll2sat_pure (noll_sat_t * fsat)
                           uint_t eq_j_k = noll2sat_get_bvar_eq (fsat, j, k);
                           //fprintf (fsat->file, "-%d -%d %d 0\n", eq_i_j,
                           //        eq_j_k, eq_i_k);
-                          fprintf (fsat->file, "-%d -%d %d 0\n", eq_i_k,
-                                   eq_j_k, eq_i_j);
+                          noll2sat_clause (fsat, 3, -(int) eq_i_k,
+                                           -(int) eq_j_k, eq_i_j);
 #ifndef NDEBUG
                           if (noll_option_is_diag())
                           {
@@ -1184,10 +1277,12 @@ noll2sat_pure (noll_sat_t * fsat)
 
 /**
  * Print F_* between one atom in bvars_subform and one atom in bvars_i.
+ * The clauses [x in alpha_i] ==> ![x in alpha_j] between predicate atoms
+ * are printed only if @p with_in, otherwise by noll2sat_space_sep_in.
  */
 int
 noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
-                    noll_uint_array * bvars_i)
+                    noll_uint_array * bvars_i, bool with_in)
 {
 
   assert (fsat != NULL);
@@ -1223,7 +1318,7 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                   uint_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, src_i,
                                                              src_j);
                   assert (bvar_eq_i_j != 0);
-                  fprintf (fsat->file, "-%d 0\n", bvar_eq_i_j);
+                  noll2sat_clause (fsat, 1, -(int) bvar_eq_i_j);
                   nb_clauses++;
                 }
               else
@@ -1246,8 +1341,7 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                                                              in_j);
                   uint_t bvar_eq_j_j = noll2sat_get_bvar_eq (fsat, in_j,
                                                              out_j);
-                  fprintf (fsat->file, "-%d %d 0\n", bvar_eq_i_j,
-                           bvar_eq_j_j);
+                  noll2sat_clause (fsat, 2, -(int) bvar_eq_i_j, bvar_eq_j_j);
                   nb_clauses++;
 
                   if (noll_pred_is_one_dir (atomj->forig->m.ls.pid) == false)
@@ -1263,7 +1357,8 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                       }
 #endif
                       bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, src_i, out_j);
-                      fprintf (fsat->file, "-%d -%d 0\n", bvar_eq_i_j, bvarj);
+                      noll2sat_clause (fsat, 2, -(int) bvar_eq_i_j,
+                                       -(int) bvarj);
                       nb_clauses++;
                     }
                 }
@@ -1291,8 +1386,7 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                                                              in_i);
                   uint_t bvar_eq_i_i = noll2sat_get_bvar_eq (fsat, in_i,
                                                              out_i);
-                  fprintf (fsat->file, "-%d %d 0\n", bvar_eq_i_j,
-                           bvar_eq_i_i);
+                  noll2sat_clause (fsat, 2, -(int) bvar_eq_i_j, bvar_eq_i_i);
                   nb_clauses++;
 
                   if (noll_pred_is_one_dir (atomi->forig->m.ls.pid) == false)
@@ -1308,7 +1402,8 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                       }
 #endif
                       bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, src_j, out_i);
-                      fprintf (fsat->file, "-%d -%d 0\n", bvar_eq_i_j, bvari);
+                      noll2sat_clause (fsat, 2, -(int) bvar_eq_i_j,
+                                       -(int) bvari);
                       nb_clauses++;
                     }
                 }
@@ -1331,7 +1426,8 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                   uint_t sid_i = atomi->forig->m.ls.sid;
                   uint_t sid_j = atomj->forig->m.ls.sid;
                   for (uint_t xk = 1;   // ignore 'nil'
-                       xk < noll_vector_size (fsat->form->lvars); xk++)
+                       with_in && xk < noll_vector_size (fsat->form->lvars);
+                       xk++)
                     {
                       uint_t rk = noll_var_record (fsat->form->lvars, xk);
                       if (rk == UNDEFINED_ID)
@@ -1344,10 +1440,10 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                           uint_t bvar_k_in_j = noll2sat_get_bvar_in (fsat, xk,
                                                                      sid_j);
                           assert (bvar_k_in_j != 0);
-                          fprintf (fsat->file, "-%d -%d 0\n", bvar_k_in_i,
-                                   bvar_k_in_j);
-                          fprintf (fsat->file, "-%d -%d 0\n", bvar_k_in_j,
-                                   bvar_k_in_i);
+                          noll2sat_clause (fsat, 2, -(int) bvar_k_in_i,
+                                           -(int) bvar_k_in_j);
+                          noll2sat_clause (fsat, 2, -(int) bvar_k_in_j,
+                                           -(int) bvar_k_in_i);
                           nb_clauses += 2;
                         }
                     }
@@ -1367,8 +1463,8 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
                                                              out_i);
                   uint_t bvar_eq_j_j = noll2sat_get_bvar_eq (fsat, in_j,
                                                              out_j);
-                  fprintf (fsat->file, "-%d %d %d 0\n", bvar_eq_i_j,
-                           bvar_eq_i_i, bvar_eq_j_j);
+                  noll2sat_clause (fsat, 3, -(int) bvar_eq_i_j, bvar_eq_i_i,
+                                   bvar_eq_j_j);
                   nb_clauses++;
                 }
             }
@@ -1377,6 +1473,99 @@ noll2sat_space_sep (noll_sat_t * fsat, noll_uint_array * bvars_subform,
   return nb_clauses;
 }
 
+/**
+ * Print the part [x in alpha_i] ==> ![x in alpha_j] of F_* between the
+ * predicate atoms of @p bvars_i and the ones of the previous subformulas,
+ * with a sequential counter: for each used location x,
+ *    [x in alpha] ==> u_x   for alpha bound by a predicate atom in bvars_i
+ *    u_x ==> !seen[x]
+ *    seen[x] \/ u_x ==> seen'[x]   (if @p more subformulas follow)
+ * where seen[x] (0 if none) means x is in a previous subformula.
+ */
+static int
+noll2sat_space_sep_in (noll_sat_t * fsat, noll_uint_array * bvars_i,
+                       uint_t * seen, bool more)
+{
+  int nb_clauses = 0;
+
+  noll_uid_inline_array sids_buf;
+  noll_uid_array *sids = noll_uid_inline_array_init (&sids_buf);
+  for (uint_t bi = 0; bi < noll_vector_size (bvars_i); bi++)
+    {
+      noll_sat_space_t *atomi =
+        noll2sat_get_sat_space (fsat, noll_vector_at (bvars_i, bi));
+      if (atomi != NULL && atomi->forig->kind == NOLL_SPACE_LS)
+        noll_uid_array_push (sids, atomi->forig->m.ls.sid);
+    }
+
+  for (uint_t xk = 1;           // ignore 'nil'
+       xk < noll_vector_size (fsat->form->lvars) && noll_vector_size (sids) > 0;
+       xk++)
+    {
+      if (noll_var_record (fsat->form->lvars, xk) == UNDEFINED_ID)
+        continue;               // only location vars
+      if (fsat->finfo->used_lvar[xk] == false)
+        continue;
+      uint_t u = 0;
+      if (noll_vector_size (sids) == 1)
+        u = noll2sat_get_bvar_in (fsat, xk, noll_vector_at (sids, 0));
+      else
+        {
+          u = noll2sat_fresh (fsat);
+          for (uint_t si = 0; si < noll_vector_size (sids); si++)
+            {
+              uint_t bvar_k_in_i =
+                noll2sat_get_bvar_in (fsat, xk, noll_vector_at (sids, si));
+              noll2sat_clause (fsat, 2, -(int) bvar_k_in_i, u);
+              nb_clauses++;
+            }
+        }
+      assert (u != 0);
+      if (seen[xk] == 0)
+        {
+          seen[xk] = u;
+          continue;
+        }
+      noll2sat_clause (fsat, 2, -(int) u, -(int) seen[xk]);
+      nb_clauses++;
+      if (more)
+        {
+          uint_t next = noll2sat_fresh (fsat);
+          noll2sat_clause (fsat, 2, -(int) seen[xk], next);
+          noll2sat_clause (fsat, 2, -(int) u, next);
+          nb_clauses += 2;
+          seen[xk] = next;
+        }
+    }
+
+  noll_uid_inline_array_fini (&sids_buf);
+  return nb_clauses;
+}
+
+/**
+ * Push in @p dst the atoms of @p src, except the points-to atoms whose
+ * source is marked in @p srcs: their clauses in F_* are the same as the
+ * ones of the first points-to atom from this source.
+ */
+static void
+noll2sat_space_sep_src (noll_sat_t * fsat, noll_uint_array * dst,
+                        noll_uint_array * src, bool *srcs)
+{
+  for (uint_t bi = 0; bi < noll_vector_size (src); bi++)
+    {
+      uint_t bvari = noll_vector_at (src, bi);
+      noll_sat_space_t *atomi = noll2sat_get_sat_space (fsat, bvari);
+      if (atomi != NULL && atomi->forig->kind == NOLL_SPACE_PTO)
+        {
+          uid_t x = atomi->forig->m.pto.sid;
+          if (srcs[x])
+            continue;
+          srcs[x] = true;
+        }
+      noll_uint_array_push (dst, bvari);
+    }
+}
+
 /**
  * Store also the encoding of atoms seen during the printing,
  * in order to generate F_*
@@ -1388,7 +1577,7 @@ noll2sat_space_aux (noll_sat_t * fsat, noll_space_t * subform,
 
   assert (fsat != NULL);
   assert (fsat->form != NULL);
-  assert (fsat->file != NULL);
+  assert (fsat->lits != NULL);
 
   if (subform == NULL)
     {
@@ -1436,7 +1625,7 @@ noll2sat_space_aux (noll_sat_t * fsat, noll_space_t * subform,
                 // internal error
               }
             // print points to
-            fprintf (fsat->file, "%d 0\n", bvar_pto);
+            noll2sat_clause (fsat, 1, bvar_pto);
             nb_clauses++;
             // Warning: only for NOLL
 #ifdef NOLL_SAT
@@ -1483,8 +1672,8 @@ noll2sat_space_aux (noll_sat_t * fsat, noll_space_t * subform,
           {
             uint_t bvar_eq_in_out = noll2sat_get_bvar_eq (fsat, vin, vout);
 
-            fprintf (fsat->file, "%d %d 0\n", bvar_ls, bvar_eq_in_out);
-            fprintf (fsat->file, "-%d -%d 0\n", bvar_ls, bvar_eq_in_out);
+            noll2sat_clause (fsat, 2, bvar_ls, bvar_eq_in_out);
+            noll2sat_clause (fsat, 2, -(int) bvar_ls, -(int) bvar_eq_in_out);
             nb_clauses += 2;
           }
         else
@@ -1496,10 +1685,10 @@ noll2sat_space_aux (noll_sat_t * fsat, noll_space_t * subform,
             uint_t bvar_eq_in_fw = noll2sat_get_bvar_eq (fsat, vin, vfw);
             uint_t bvar_eq_out_pv = noll2sat_get_bvar_eq (fsat, vout, vpv);
 
-            fprintf (fsat->file, "%d %d 0\n", bvar_ls, bvar_eq_in_fw);
-            fprintf (fsat->file, "%d %d 0\n", bvar_ls, bvar_eq_out_pv);
-            fprintf (fsat->file, "-%d -%d 0\n", bvar_ls, bvar_eq_in_fw);
-            fprintf (fsat->file, "-%d -%d 0\n", bvar_ls, bvar_eq_out_pv);
+            noll2sat_clause (fsat, 2, bvar_ls, bvar_eq_in_fw);
+            noll2sat_clause (fsat, 2, bvar_ls, bvar_eq_out_pv);
+            noll2sat_clause (fsat, 2, -(int) bvar_ls, -(int) bvar_eq_in_fw);
+            noll2sat_clause (fsat, 2, -(int) bvar_ls, -(int) bvar_eq_out_pv);
             nb_clauses += 4;
           }
         // push atom in the list
@@ -1522,6 +1711,19 @@ noll2sat_space_aux (noll_sat_t * fsat, noll_space_t * subform,
       {
         // translate subformula and collect their used bvars
         noll_uint_array *bvars_subform = noll_uint_array_new ();        // acc for atoms
+        // for the linear encoding: locations in the previous subformulas
+        // and sources of the points-to atoms in bvars_subform and bvars_i
+        bool linear = noll_option_is_enc_linear ();
+        uint_t nvars = noll_vector_size (fsat->form->lvars);
+        uint_t *seen = NULL;
+        bool *srcs_subform = NULL;
+        bool *srcs_i = NULL;
+        if (linear)
+          {
+            seen = (uint_t *) calloc (nvars, sizeof (uint_t));
+            srcs_subform = (bool *) calloc (nvars, sizeof (bool));
+            srcs_i = (bool *) malloc (nvars * sizeof (bool));
+          }
         for (uint_t i = 0; i < noll_vector_size (subform->m.sep); i++)
           {
             noll_uint_array *bvars_i = noll_uint_array_new ();
@@ -1538,20 +1740,42 @@ noll2sat_space_aux (noll_sat_t * fsat, noll_space_t * subform,
 #endif
             // put F_* corresponding to
             // the bvars_subform (collected until i) and bvars_used_i atoms
-            nb_clauses += noll2sat_space_sep (fsat, bvars_subform, bvars_i);
-
-            // push bvars_i in bvars_subform and bvars_used
-            for (uint_t bi = 0; bi < noll_vector_size (bvars_i); bi++)
+            if (linear)
+              {
+                bool more = (i + 1 < noll_vector_size (subform->m.sep));
+                nb_clauses += noll2sat_space_sep_in (fsat, bvars_i, seen,
+                                                     more);
+                noll_uint_array *bvars_src = noll_uint_array_new ();
+                memset (srcs_i, 0, nvars * sizeof (bool));
+                noll2sat_space_sep_src (fsat, bvars_src, bvars_i, srcs_i);
+                nb_clauses += noll2sat_space_sep (fsat, bvars_subform,
+                                                  bvars_src, false);
+                noll_uint_array_delete (bvars_src);
+                noll2sat_space_sep_src (fsat, bvars_subform, bvars_i,
+                                        srcs_subform);
+              }
+            else
               {
-                noll_uint_array_push (bvars_subform,
-                                      noll_vector_at (bvars_i, bi));
-                noll_uint_array_push (bvars_used,
-                                      noll_vector_at (bvars_i, bi));
+                nb_clauses += noll2sat_space_sep (fsat, bvars_subform,
+                                                  bvars_i, true);
+                for (uint_t bi = 0; bi < noll_vector_size (bvars_i); bi++)
+                  noll_uint_array_push (bvars_subform,
+                                        noll_vector_at (bvars_i, bi));
               }
+
+            // push bvars_i in bvars_used
+            for (uint_t bi = 0; bi < noll_vector_size (bvars_i); bi++)
+              noll_uint_array_push (bvars_used, noll_vector_at (bvars_i, bi));
             // clean bvars_i
-            noll_uint_array_clear (bvars_i);
+            noll_uint_array_delete (bvars_i);
+          }
+        noll_uint_array_delete (bvars_subform);
+        if (linear)
+          {
+            free (seen);
+            free (srcs_subform);
+            free (srcs_i);
           }
-        noll_uint_array_clear (bvars_subform);
         break;
       }
     default:
@@ -1569,7 +1793,7 @@ noll2sat_space (noll_sat_t * fsat)
 
   assert (fsat != NULL);
   assert (fsat->form != NULL);
-  assert (fsat->file != NULL);
+  assert (fsat->lits != NULL);
 
   // call function above with the empty array
   noll_uint_array *atoms = noll_uint_array_new ();
@@ -1589,7 +1813,7 @@ noll2sat_membership (noll_sat_t * fsat)
 
   assert (fsat != NULL);
   assert (fsat->form != NULL);
-  assert (fsat->file != NULL);
+  assert (fsat->lits != NULL);
 
   int nb_clauses = 0;
 
@@ -1627,7 +1851,7 @@ noll2sat_membership (noll_sat_t * fsat)
                       uint_t bvar_i_in_j = noll2sat_get_bvar_in (fsat, xi,
                                                                  alphaj);
                       assert (bvar_i_in_j != 0);
-                      fprintf (fsat->file, "-%d 0\n", bvar_i_in_j);
+                      noll2sat_clause (fsat, 1, -(int) bvar_i_in_j);
                       nb_clauses++;
                     }
                 }
@@ -1670,8 +1894,8 @@ noll2sat_membership (noll_sat_t * fsat)
                          noll_pred_name (p_i), fsat->start_pred + lsi);
               }
 #endif
-              fprintf (fsat->file, "-%d %d 0\n", bvar_j_in_i,
-                       fsat->start_pred + (uint_t) lsi);
+              noll2sat_clause (fsat, 2, -(int) bvar_j_in_i,
+                               fsat->start_pred + (uint_t) lsi);
               nb_clauses++;
               // }
             }
@@ -1725,8 +1949,8 @@ noll2sat_membership (noll_sat_t * fsat)
                                             NOLL_TYP_SETLOC));
                   }
 #endif
-                  fprintf (fsat->file, "-%d -%d %d 0\n", bvar_eq_i_j,
-                           bvar_in_i, bvar_in_j_i);
+                  noll2sat_clause (fsat, 3, -(int) bvar_eq_i_j,
+                                   -(int) bvar_in_i, bvar_in_j_i);
                   nb_clauses++;
                 }
             }
@@ -1755,7 +1979,7 @@ noll2sat_membership (noll_sat_t * fsat)
 #endif
       uint_t bvar_pred_i = fsat->start_pred + i;
       uint_t bvar_in_i = noll2sat_get_bvar_in (fsat, x_i, alpha_i);
-      fprintf (fsat->file, "-%d %d 0\n", bvar_pred_i, bvar_in_i);
+      noll2sat_clause (fsat, 2, -(int) bvar_pred_i, bvar_in_i);
       nb_clauses++;
     }
 
@@ -1809,7 +2033,7 @@ noll2sat_membership (noll_sat_t * fsat)
                                                                        forig);
                         if (!flag)
                           {
-                            fprintf (fsat->file, "-%d ", bvar_j_in_i);
+                            noll2sat_lit (fsat, -(int) bvar_j_in_i);
 #ifndef NDEBUG
                             if (noll_option_is_diag())
                             {
@@ -1822,7 +2046,7 @@ noll2sat_membership (noll_sat_t * fsat)
 #endif
                             flag = 1;
                           }
-                        fprintf (fsat->file, "%d ", bvar_apto_j_k);
+                        noll2sat_lit (fsat, bvar_apto_j_k);
 #ifndef NDEBUG
                         if (noll_option_is_diag())
                         {
@@ -1839,7 +2063,7 @@ noll2sat_membership (noll_sat_t * fsat)
               }
             if (flag)
               {
-                fprintf (fsat->file, "0\n");
+                noll2sat_end (fsat);
 #ifndef NDEBUG
                 if (noll_option_is_diag())
                 {
@@ -1893,10 +2117,11 @@ noll2sat_det_pto_pto (noll_sat_t * fsat)
             }
 #endif
             uint_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, x_i, x_j);
-            fprintf (fsat->file, "-%d %d %d 0\n", bvar_eq_i_j,
-                     fsat->start_pto + i, fsat->start_pto + j);
-            fprintf (fsat->file, "-%d -%d -%d 0\n", bvar_eq_i_j,
-                     fsat->start_pto + i, fsat->start_pto + j);
+            noll2sat_clause (fsat, 3, -(int) bvar_eq_i_j, fsat->start_pto + i,
+                             fsat->start_pto + j);
+            noll2sat_clause (fsat, 3, -(int) bvar_eq_i_j,
+                             -(int) (fsat->start_pto + i),
+                             -(int) (fsat->start_pto + j));
             nb_clauses += 2;
           }
       }
@@ -1938,8 +2163,9 @@ noll2sat_det_apto_apto (noll_sat_t * fsat)
             }
 #endif
             uint_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, x_i, x_j);
-            fprintf (fsat->file, "-%d -%d -%d 0\n", bvar_eq_i_j,
-                     fsat->start_apto + i, fsat->start_apto + j);
+            noll2sat_clause (fsat, 3, -(int) bvar_eq_i_j,
+                             -(int) (fsat->start_apto + i),
+                             -(int) (fsat->start_apto + j));
             nb_clauses++;
           }
       }
@@ -1972,7 +2198,8 @@ noll2sat_det_apto_nil (noll_sat_t * fsat)
       }
 #endif
       uint_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, x_i, x_nil);
-      fprintf (fsat->file, "-%d -%d 0\n", bvar_eq_i_j, fsat->start_apto + i);
+      noll2sat_clause (fsat, 2, -(int) bvar_eq_i_j,
+                       -(int) (fsat->start_apto + i));
       nb_clauses++;
     }
   return nb_clauses;
@@ -2018,8 +2245,9 @@ noll2sat_det_pto_apto (noll_sat_t * fsat)
             }
 #endif
             uint_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, x_i, x_j);
-            fprintf (fsat->file, "-%d -%d -%d 0\n", bvar_eq_i_j,
-                     fsat->start_pto + i, fsat->start_apto + j);
+            noll2sat_clause (fsat, 3, -(int) bvar_eq_i_j,
+                             -(int) (fsat->start_pto + i),
+                             -(int) (fsat->start_apto + j));
             nb_clauses++;
           }
       }
@@ -2056,7 +2284,8 @@ noll2sat_det_pto_nil (noll_sat_t * fsat)
       }
 #endif
       uint_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, x_i, x_nil);
-      fprintf (fsat->file, "-%d -%d 0\n", fsat->start_pto + i, bvar_eq_i_j);
+      noll2sat_clause (fsat, 2, -(int) (fsat->start_pto + i),
+                       -(int) bvar_eq_i_j);
       nb_clauses++;
     }
   return nb_clauses;
@@ -2113,12 +2342,13 @@ noll2sat_det_pto_pred (noll_sat_t * fsat)
                                                             x_k);
                   uid_t bvar_in_k_j = noll2sat_get_bvar_in (fsat, x_k,
                                                             alpha_j);
-                  fprintf (fsat->file, "-%d -%d %d %d 0\n", bvar_eq_i_k,
-                           bvar_in_k_j, fsat->start_pto + i,
-                           fsat->start_pred + j);
-                  fprintf (fsat->file, "-%d -%d -%d -%d 0\n", bvar_eq_i_k,
-                           bvar_in_k_j, fsat->start_pto + i,
-                           fsat->start_pred + j);
+                  noll2sat_clause (fsat, 4, -(int) bvar_eq_i_k,
+                                   -(int) bvar_in_k_j, fsat->start_pto + i,
+                                   fsat->start_pred + j);
+                  noll2sat_clause (fsat, 4, -(int) bvar_eq_i_k,
+                                   -(int) bvar_in_k_j,
+                                   -(int) (fsat->start_pto + i),
+                                   -(int) (fsat->start_pred + j));
                   nb_clauses += 2;
                 }
             }
@@ -2204,9 +2434,10 @@ noll2sat_det_pred_pred (noll_sat_t * fsat)
                     uint_t bvar_in_2_j = noll2sat_get_bvar_in (fsat, x2,
                                                                alpha_j);
                     assert (bvar_in_2_j != 0);
-                    fprintf (fsat->file, "-%d -%d -%d -%d -%d 0\n",
-                             bvar_in_1_i, bvar_in_2_j, bvar_eq_1_2,
-                             fsat->start_pred + i, fsat->start_pred + j);
+                    noll2sat_clause (fsat, 5, -(int) bvar_in_1_i,
+                                     -(int) bvar_in_2_j, -(int) bvar_eq_1_2,
+                                     -(int) (fsat->start_pred + i),
+                                     -(int) (fsat->start_pred + j));
                     nb_clauses++;
                   }
             }
@@ -2214,13 +2445,153 @@ noll2sat_det_pred_pred (noll_sat_t * fsat)
   return nb_clauses;
 }
 
+/*
+ * write F_det of noll2sat_det_pred_pred with owner variables.
+ * The pairs of predicate atoms with a common field at level 0 are the
+ * pairs inside the groups G_f of atoms having f at level 0.
+ * For each group G_f = P_1 < ... < P_n and used location x:
+ *    o(x,i) <== [x in alpha_i] & [P_i,alpha_i(_)]      (P_i owns x)
+ *    s(x,i) <== o(x,i+1) \/ s(x,i+1)                   (a later P_j owns x)
+ * and for x1, x2 in usedvar(phi) s.t. x2 <= x1 and type(x1)=type(x2)=type0(P_i)
+ *    [x1 = x2] & o(x1,i) ==> !s(x2,i)
+ * which needs O(|G_f| * V^2) clauses instead of O(|G_f|^2 * V^2).
+ */
+int
+noll2sat_det_pred_pred_lin (noll_sat_t * fsat)
+{
+  int nb_clauses = 0;
+  uint_t nvars = noll_vector_size (fsat->form->lvars);
+  uint_t npred = fsat->size_pred;
+  if (npred < 2)
+    return 0;
+
+  /* owner variables, built when needed, 0 if not yet */
+  uint_t *owner = (uint_t *) calloc (nvars * npred, sizeof (uint_t));
+  /* variables s(x,i) of the current group for each location x */
+  uint_t *later = (uint_t *) malloc (nvars * npred * sizeof (uint_t));
+  /* groups already done */
+  noll_uint_array **groups = (noll_uint_array **)
+    malloc (noll_vector_size (fields_array) * sizeof (noll_uint_array *));
+  uint_t ngroups = 0;
+
+  for (uint_t fi = 0; fi < noll_vector_size (fields_array); fi++)
+    {
+      noll_uint_array *g = noll_uint_array_new ();
+      for (uint_t i = 0; i < npred; i++)
+        {
+          uid_t pid_i = noll_vector_at (fsat->var_pred, i)->forig->m.ls.pid;
+          if (noll_pred_is_field (pid_i, fi, NOLL_PFLD_BORDER))
+            noll_uint_array_push (g, i);
+        }
+      bool done = (noll_vector_size (g) < 2);
+      for (uint_t gi = 0; gi < ngroups && !done; gi++)
+        done = noll_uint_array_equal (g, groups[gi]);
+      if (done)
+        {
+          noll_uint_array_delete (g);
+          continue;
+        }
+      groups[ngroups++] = g;
+      uint_t n = noll_vector_size (g);
+
+      /* owners and chains s(x,_) for the locations of type type0(P_i) */
+      for (uint_t x = 1; x < nvars; x++)
+        {
+          uid_t typ_x = noll_var_record (fsat->form->lvars, x);
+          bool needed = false;
+          for (uint_t k = 0; k + 1 < n && !needed; k++)
+            {
+              noll_sat_space_t *sat_k =
+                noll_vector_at (fsat->var_pred, noll_vector_at (g, k));
+              needed = (typ_x ==
+                        noll_pred_getpred (sat_k->forig->m.ls.pid)->
+                        typ->ptype0);
+            }
+          if (fsat->finfo->used_lvar[x] == false || !needed)
+            continue;
+          for (uint_t k = 1; k < n; k++)
+            {
+              uint_t j = noll_vector_at (g, k);
+              if (owner[x * npred + j] != 0)
+                continue;
+              uid_t alpha_j =
+                noll_vector_at (fsat->var_pred, j)->forig->m.ls.sid;
+              uint_t bvar_in_x_j = noll2sat_get_bvar_in (fsat, x, alpha_j);
+              assert (bvar_in_x_j != 0);
+              owner[x * npred + j] = noll2sat_fresh (fsat);
+              noll2sat_clause (fsat, 3, -(int) bvar_in_x_j,
+                               -(int) (fsat->start_pred + j),
+                               owner[x * npred + j]);
+              nb_clauses++;
+            }
+          // s(x,n-2) = o(x,n-1)
+          uint_t last = noll_vector_at (g, n - 1);
+          later[x * npred + n - 2] = owner[x * npred + last];
+          for (uint_t k = n - 2; k > 0; k--)
+            {
+              uint_t s_k = noll2sat_fresh (fsat);
+              noll2sat_clause (fsat, 2,
+                               -(int) owner[x * npred + noll_vector_at (g, k)],
+                               s_k);
+              noll2sat_clause (fsat, 2, -(int) later[x * npred + k], s_k);
+              nb_clauses += 2;
+              later[x * npred + k - 1] = s_k;
+            }
+        }
+
+      /* conflicts between P_i owning x1 and a later P_j owning x2 */
+      for (uint_t k = 0; k + 1 < n; k++)
+        {
+          uint_t i = noll_vector_at (g, k);
+          noll_sat_space_t *sat_i = noll_vector_at (fsat->var_pred, i);
+          const noll_pred_t *pred_i =
+            noll_pred_getpred (sat_i->forig->m.ls.pid);
+          assert (NULL != pred_i);
+          uid_t typ0_i = pred_i->typ->ptype0;
+          uid_t alpha_i = sat_i->forig->m.ls.sid;
+          for (uint_t x1 = 1; x1 < nvars; x1++)
+            {
+              if ((fsat->finfo->used_lvar[x1] == false)
+                  || (noll_var_record (fsat->form->lvars, x1) != typ0_i))
+                continue;
+              uint_t bvar_in_1_i = noll2sat_get_bvar_in (fsat, x1, alpha_i);
+              assert (bvar_in_1_i != 0);
+              // P_i owns x1, directly by its atoms
+              int own_1_i[2] = { -(int) bvar_in_1_i,
+                -(int) (fsat->start_pred + i)
+              };
+              for (uint_t x2 = 1; x2 <= x1; x2++)
+                {
+                  if ((fsat->finfo->used_lvar[x2] == false)
+                      || (noll_var_record (fsat->form->lvars, x2) != typ0_i))
+                    continue;
+                  uint_t bvar_eq_1_2 = noll2sat_get_bvar_eq (fsat, x1, x2);
+                  assert (bvar_eq_1_2 != 0);
+                  uint_t s_2_k = later[x2 * npred + k];
+                  assert (s_2_k != 0);
+                  noll2sat_clause (fsat, 4, own_1_i[0], own_1_i[1],
+                                   -(int) bvar_eq_1_2, -(int) s_2_k);
+                  nb_clauses++;
+                }
+            }
+        }
+    }
+
+  for (uint_t gi = 0; gi < ngroups; gi++)
+    noll_uint_array_delete (groups[gi]);
+  free (groups);
+  free (later);
+  free (owner);
+  return nb_clauses;
+}
+
 int
 noll2sat_det (noll_sat_t * fsat)
 {
 
   assert (fsat != NULL);
   assert (fsat->form != NULL);
-  assert (fsat->file != NULL);
+  assert (fsat->lits != NULL);
 
   int nb_clauses = 0;
 
@@ -2288,7 +2659,10 @@ noll2sat_det (noll_sat_t * fsat)
   }
 #endif
   //pairs of ls predicates
-  nb_clauses += noll2sat_det_pred_pred (fsat);
+  if (noll_option_is_enc_linear ())
+    nb_clauses += noll2sat_det_pred_pred_lin (fsat);
+  else
+    nb_clauses += noll2sat_det_pred_pred (fsat);
 
   fsat->no_clauses += nb_clauses;
   return nb_clauses;
@@ -2322,7 +2696,7 @@ noll2sat_share_in (noll_sat_t * fsat, uid_t x, noll_sterm_array * t)
 #endif
           uint_t bvar_eq_x_tj = noll2sat_get_bvar_eq (fsat, x, term->lvar);
           assert (bvar_eq_x_tj != 0);
-          fprintf (fsat->file, "%d ", bvar_eq_x_tj);
+          noll2sat_lit (fsat, bvar_eq_x_tj);
         }
       else if ((term->kind == NOLL_STERM_SVAR)
                && (type_in_pred_of_svar (fsat, ty_x, term->svar) == 1))
@@ -2337,7 +2711,7 @@ noll2sat_share_in (noll_sat_t * fsat, uid_t x, noll_sterm_array * t)
 #endif
           uint_t bvar_in_x_tj = noll2sat_get_bvar_in (fsat, x, term->svar);
           assert (bvar_in_x_tj != 0);
-          fprintf (fsat->file, "%d ", bvar_in_x_tj);
+          noll2sat_lit (fsat, bvar_in_x_tj);
         }
       else if ((term->kind == NOLL_STERM_PRJ)
                && (type_in_pred_of_svar (fsat, ty_x, term->svar) == 1)
@@ -2353,7 +2727,7 @@ noll2sat_share_in (noll_sat_t * fsat, uid_t x, noll_sterm_array * t)
 #endif
           uint_t bvar_in_x_tj = noll2sat_get_bvar_in (fsat, x, term->svar);
           assert (bvar_in_x_tj != 0);
-          fprintf (fsat->file, "%d ", bvar_in_x_tj);
+          noll2sat_lit (fsat, bvar_in_x_tj);
         }
       else
         {
@@ -2381,7 +2755,7 @@ noll2sat_share (noll_sat_t * fsat)
 
   assert (fsat != NULL);
   assert (fsat->form != NULL);
-  assert (fsat->file != NULL);
+  assert (fsat->lits != NULL);
 
   int nb_clauses = 0;
 
@@ -2401,7 +2775,7 @@ noll2sat_share (noll_sat_t * fsat)
             assert (atom->t_left->kind == NOLL_STERM_LVAR);
             noll2sat_share_in (fsat, atom->t_left->lvar, atom->t_right);
             // end clause
-            fprintf (fsat->file, "0\n");
+            noll2sat_end (fsat);
             nb_clauses++;
             break;
           }
@@ -2429,7 +2803,7 @@ noll2sat_share (noll_sat_t * fsat)
                     uint_t bvar_in_x_ti = noll2sat_get_bvar_in (fsat, x,
                                                                 ti->svar);
                     assert (bvar_in_x_ti != 0);
-                    fprintf (fsat->file, "-%d 0\n", bvar_in_x_ti);
+                    noll2sat_clause (fsat, 1, -(int) bvar_in_x_ti);
                     nb_clauses++;
                   }
                 else
@@ -2446,7 +2820,7 @@ noll2sat_share (noll_sat_t * fsat)
                     uint_t bvar_eq_x_ti = noll2sat_get_bvar_eq (fsat, x,
                                                                 ti->lvar);
                     assert (bvar_eq_x_ti != 0);
-                    fprintf (fsat->file, "-%d 0\n", bvar_eq_x_ti);
+                    noll2sat_clause (fsat, 1, -(int) bvar_eq_x_ti);
                     nb_clauses++;
                   }
               }
@@ -2499,11 +2873,11 @@ noll2sat_share (noll_sat_t * fsat)
                                                               left_svar);
                   assert (bvar_vi_in_t != 0);
                   // print \neg x \in \alpha_1
-                  fprintf (fsat->file, "-%d ", bvar_vi_in_t);
+                  noll2sat_lit (fsat, -(int) bvar_vi_in_t);
                   // print disjunction of left terms for vi
                   noll2sat_share_in (fsat, vi, atom->t_right);
                   // end clause
-                  fprintf (fsat->file, "0\n");
+                  noll2sat_end (fsat);
                   nb_clauses++;
                 }
 
@@ -2532,7 +2906,7 @@ noll2sat_share (noll_sat_t * fsat)
                   break;        // nothing to be done
                 // else, generate the constraint
                 // if [pi ...] true then
-                fprintf (fsat->file, "-%d ", fsat->start_pred + lsi);
+                noll2sat_lit (fsat, -(int) (fsat->start_pred + lsi));
 #ifndef NDEBUG
                 if (noll_option_is_diag())
                 {
@@ -2542,7 +2916,7 @@ noll2sat_share (noll_sat_t * fsat)
                 // print disjunction for each term of t_right
                 noll2sat_share_in (fsat, in_lsi, atom->t_right);
                 // end clause
-                fprintf (fsat->file, "0\n");
+                noll2sat_end (fsat);
                 nb_clauses++;
               }
             break;
@@ -2558,153 +2932,256 @@ noll2sat_share (noll_sat_t * fsat)
 /* Calling Minisat and adding constraints */
 /* ====================================================================== */
 
-int
-noll2sat_is_eq (noll_sat_t * fsat, uid_t x, uid_t y, noll_pure_op_t oper)
+/**
+ * Move the clauses of the lazy store violated by the last model
+ * (or all if @p all) to the clauses of the abstraction and the solver.
+ * @return the number of clauses moved
+ */
+static uint_t
+noll2sat_refine (noll_sat_t * fsat, bool all)
 {
+  if (fsat->lazy_clauses == NULL || noll_vector_size (fsat->lazy_clauses) < 2)
+    return 0;
 
-  int res = 0;
-
-  size_t fname_len = strlen (fsat->fname);
+  uint_t moved = 0;
+  uint_t kept_lits = 0;         // the store is compacted in place
+  uint_t kept = 1;
+  for (uint_t c = 0; c + 1 < noll_vector_size (fsat->lazy_clauses); c++)
+    {
+      uint_t start = noll_vector_at (fsat->lazy_clauses, c);
+      uint_t end = noll_vector_at (fsat->lazy_clauses, c + 1);
+      bool sat = false;
+      for (uint_t l = start; l < end && !all && !sat; l++)
+        {
+          minisat_lit_t lit = noll_vector_at (fsat->lazy_lits, l);
+          int v = minisat_model_value (fsat->solver, (lit > 0) ? lit : -lit);
+          sat = (lit > 0) ? (v == 1) : (v == 0);
+        }
+      if (sat)
+        {
+          for (uint_t l = start; l < end; l++)
+            noll_vector_at (fsat->lazy_lits, kept_lits++) =
+              noll_vector_at (fsat->lazy_lits, l);
+          noll_vector_at (fsat->lazy_clauses, kept++) = kept_lits;
+          continue;
+        }
+      for (uint_t l = start; l < end; l++)
+        noll_lit_array_push (fsat->lits, noll_vector_at (fsat->lazy_lits, l));
+      noll2sat_end (fsat);
+      if (fsat->solver != NULL)
+        minisat_add_clause (fsat->solver,
+                            noll_vector_array (fsat->lazy_lits) + start,
+                            end - start);
+      moved++;
+    }
+  noll_lit_array_resize (fsat->lazy_lits, kept_lits);
+  noll_uint_array_resize (fsat->lazy_clauses, kept);
+  return moved;
+}
 
-  // print the prefix file with information about variables and clauses
-  char *pre_fname = (char *) malloc ((5 + fname_len) * sizeof (char));
-  memset (pre_fname, 0, (5 + fname_len) * sizeof (char));
-  sprintf (pre_fname, "pre_%s", fsat->fname);
-  FILE *out = fopen (pre_fname, "w");
-  fprintf (out, "p cnf %d %d\n", fsat->no_vars - 1, fsat->no_clauses + 1);      // -1 on no_vars ?
-#ifndef NDEBUG
-  if (noll_option_is_diag())
-  {
-    fprintf (stdout, "---- minisat query prefix: p cnf %d %d\n",
-             fsat->no_vars - 1, fsat->no_clauses + 1);
-  }
-#endif
-  free (pre_fname);
-  fclose (out);
+/**
+ * Load the clauses of the boolean abstraction in a new solver.
+ * The abstraction shall be finished, i.e., no clause is being built.
+ */
+minisat_solver_t *
+noll2sat_solver_new (noll_sat_t * fsat)
+{
+  assert (fsat != NULL);
+  assert (noll2sat_is_closed (fsat));
 
-  // print the suffix file with the equality to test
-  char *eq_fname = (char *) malloc ((5 + fname_len) * sizeof (char));
-  memset (eq_fname, 0, (5 + fname_len) * sizeof (char));
-  sprintf (eq_fname, "eq_%s", fsat->fname);
-  out = fopen (eq_fname, "w");
-  free (eq_fname);
+  bool simp = noll_option_is_sat_simp ();
+  minisat_solver_t *solver = (simp) ? minisat_create_simp_solver () :
+    minisat_create_solver ();
+  minisat_reserve_vars (solver, fsat->no_vars - 1);
 
-  //write a new clause in the DIMACS file
-  uid_t bvar_eq_x_y = noll2sat_get_bvar_eq (fsat, x, y);
-  if (oper == NOLL_PURE_EQ)
+  // load the clauses directly from the store
+  const minisat_lit_t *lits = noll_vector_array (fsat->lits);
+  for (uint_t c = 0; c + 1 < noll_vector_size (fsat->clauses); c++)
     {
-      fprintf (out, "-%d 0\n", bvar_eq_x_y);
+      uint_t start = noll_vector_at (fsat->clauses, c);
+      uint_t end = noll_vector_at (fsat->clauses, c + 1);
+      minisat_add_clause (solver, lits + start, end - start);
     }
-  else if (oper == NOLL_PURE_NEQ)
-    {
-      fprintf (out, "%d 0\n", bvar_eq_x_y);
-    }
-  else
+
+  if (simp)
     {
-      return -1;
+      // keep the variables of the queries: [x = y] and [x in alpha]
+      for (uint_t v = fsat->start_pure; v < fsat->start_pto; v++)
+        minisat_freeze_var (solver, v);
+      for (uint_t v = fsat->start_inset;
+           v < fsat->start_inset + fsat->size_inset; v++)
+        minisat_freeze_var (solver, v);
+      // and the ones of the clauses which may be added later
+      if (fsat->lazy_lits != NULL)
+        for (uint_t l = 0; l < noll_vector_size (fsat->lazy_lits); l++)
+          {
+            minisat_lit_t lit = noll_vector_at (fsat->lazy_lits, l);
+            minisat_freeze_var (solver, (lit > 0) ? lit : -lit);
+          }
+      minisat_eliminate (solver);
     }
-  fclose (out);
+  return solver;
+}
 
-  // build the final file for sat using cat
-  char *command = (char *) calloc ((100 + 4 * fname_len), sizeof (char));
-  memset (command, 0, (100 + 4 * fname_len) * sizeof (char));
-  sprintf (command,
-           "cat pre_%s %s eq_%s 1> full_new_%s", fsat->fname, fsat->fname,
-           fsat->fname, fsat->fname);
-  if (system (command) != -1)
-    assert (0);
+/**
+ * Check the boolean abstraction under the assumptions @p assums.
+ * The clauses are loaded once in fsat->solver, which is kept
+ * (with the learnt clauses) for the next queries.
+ * @return 1 if satisfiable, 0 otherwise
+ */
+int
+noll2sat_solve (noll_sat_t * fsat, minisat_lit_t * assums, uint_t size)
+{
+  assert (fsat != NULL);
 
-  // print the minisat command
-  memset (command, 0, (100 + 4 * fname_len) * sizeof (char));
-  sprintf (command,
-           "minisat_inc -verb=0 full_new_%s result.txt 1> msat_%s",
-           fsat->fname, fsat->fname);
-  if (system (command) != -1)
-    {
-      FILE *fres = fopen ("result.txt", "r");
-      char s[10];
-      fscanf (fres, "%s", s);
-      fclose (fres);
-      if (strcmp (s, "UNSAT") == 0)
-        {
-          res = 1;
-        }
-    }
-  free (command);
+  if (fsat->solver == NULL)
+    fsat->solver = noll2sat_solver_new (fsat);
+  int res = minisat_solve (fsat->solver, assums, size);
+  /* refine the abstraction until the model satisfies the lazy clauses */
+  while (res == 1 && noll2sat_refine (fsat, false) > 0)
+    res = minisat_solve (fsat->solver, assums, size);
   return res;
 }
 
+/**
+ * Check the boolean abstraction using the external minisat which
+ * prints the DRUP proof used by noll_sat_diag_unsat.
+ * @return 1 if satisfiable, 0 otherwise
+ */
 int
-noll2sat_is_sat (noll_sat_t * fsat)
+noll2sat_is_sat_drup (noll_sat_t * fsat)
 {
 
   int result = 1;
 
-  size_t fname_len = strlen (fsat->fname);
+  // print the file for sat: header and all clauses
+  noll2sat_refine (fsat, true);
+  char *sat_fname = noll_scratch_path ("sat_", fsat->fname);
+  FILE *out = fopen (sat_fname, "w");
+  if (out == NULL)
+    {
+      free (sat_fname);
+      return noll2sat_solve (fsat, NULL, 0);
+    }
+  noll2sat_fprint (out, fsat);
+  fclose (out);
 
-  // print the prefix file for sat in file in the command
-#ifndef NDEBUG
-  if (noll_option_is_diag())
-  {
-    fprintf (stdout, "---- minisat query prefix: p cnf %d %d\n",
-             fsat->no_vars - 1, fsat->no_clauses);
-  }
-#endif
-  // build the final file for sat using echo and cat
-  size_t command_len = 100 + 2 * fname_len;
+  // print the minisat command
+  char *drup_fname = noll_scratch_path ("drup_", fsat->fname);
+  char *res_fname = noll_scratch_path ("result_", fsat->fname);
+  size_t command_len = 100 + strlen (sat_fname) + strlen (drup_fname)
+    + strlen (res_fname);
   char *command = (char *) malloc (command_len * sizeof (char));
   memset (command, '\0', command_len * sizeof (char));
   sprintf (command,
-           "echo \"p cnf %d %d\" | cat - %s 1> sat_%s", fsat->no_vars - 1,
-           fsat->no_clauses, fsat->fname, fsat->fname);
-  // execute cat
+           "minisat -verb=0 %s %s 1> %s", sat_fname, drup_fname, res_fname);
+  free (sat_fname);
+  free (drup_fname);
+
+  // call minisat
   if (system (command) != -1)
     {
-      // print the minisat command
-      memset (command, '\0', command_len * sizeof (char));
-      sprintf (command,
-               "minisat -verb=0 sat_%s drup_%s 1> result.txt", fsat->fname,
-               fsat->fname);
-
-      // call minisat
-      if (system (command) != -1)
+      FILE *rfile = fopen (res_fname, "r");
+      char *line = NULL;
+      size_t linelen = 0;
+      /// read result of minisat with output for SAT-COMP
+      while (rfile != NULL && getline (&line, &linelen, rfile) != -1)
         {
-          FILE *rfile = fopen ("result.txt", "r");
-          char *line = NULL;
-          size_t linelen = 0;
-          /// read result of minisat with output for SAT-COMP
-          while (getline (&line, &linelen, rfile) != -1)
+          if (line[0] != 's')
+            continue;
+#ifndef NDEBUG
+          if (noll_option_is_diag())
+          {
+            fprintf (stdout, "*********************%s**************\n",
+                     line);
+          }
+#endif
+          if (strncmp (line, "s UNSAT", 7) == 0)
             {
-              if (line[0] != 's')
-                continue;
 #ifndef NDEBUG
               if (noll_option_is_diag())
               {
-                fprintf (stdout, "*********************%s**************\n",
-                         line);
+                fprintf (stdout,
+                         "*******************UNSAT*******************\n");
               }
 #endif
-              if (strncmp (line, "s UNSAT", 7) == 0)
-                {
-#ifndef NDEBUG
-                  if (noll_option_is_diag())
-                  {
-                    fprintf (stdout,
-                             "*******************UNSAT*******************\n");
-                  }
-#endif
-                  result = 0;
-                }
-              break;
+              result = 0;
             }
-          if (line != NULL)
-            free (line);
+          break;
         }
+      if (line != NULL)
+        free (line);
+      if (rfile != NULL)
+        fclose (rfile);
     }
   free (command);
+  free (res_fname);
   return result;
 }
 
+int
+noll2sat_is_eq (noll_sat_t * fsat, uid_t x, uid_t y, noll_pure_op_t oper)
+{
+  assert (fsat != NULL);
+  assert (noll2sat_is_closed (fsat));
+
+  // the query is the negation of [x oper y]
+  uid_t bvar_eq_x_y = noll2sat_get_bvar_eq (fsat, x, y);
+  minisat_lit_t query = 0;
+  if (oper == NOLL_PURE_EQ)
+    query = -((minisat_lit_t) bvar_eq_x_y);
+  else if (oper == NOLL_PURE_NEQ)
+    query = (minisat_lit_t) bvar_eq_x_y;
+  else
+    return -1;
+
+#ifndef NDEBUG
+  if (noll_option_is_diag())
+  {
+    fprintf (stdout, "---- minisat query: %d with %d vars and %d clauses\n",
+             query, fsat->no_vars - 1, fsat->no_clauses);
+  }
+#endif
+
+  // unsatisfiable query means [x oper y] implied
+  return (noll2sat_solve (fsat, &query, 1) == 0) ? 1 : 0;
+}
+
+int
+noll2sat_is_sat (noll_sat_t * fsat)
+{
+  assert (fsat != NULL);
+
+#ifndef NDEBUG
+  if (noll_option_is_diag())
+  {
+    fprintf (stdout, "---- minisat query: %d vars and %d clauses\n",
+             fsat->no_vars - 1, fsat->no_clauses);
+  }
+#endif
+
+  // the unsat core for diagnosis is read from the proof of the external tool
+  if (noll_option_is_diag ())
+    return noll2sat_is_sat_drup (fsat);
+
+  return noll2sat_solve (fsat, NULL, 0);
+}
+
+int
+noll2sat_model_eq (noll_sat_t * fsat, uid_t x, uid_t y)
+{
+  assert (fsat != NULL);
+
+  if (fsat->solver == NULL)
+    return -1;
+  if (x == y)
+    return 1;
+  uid_t bvar_eq_x_y = noll2sat_get_bvar_eq (fsat, x, y);
+  if (bvar_eq_x_y == 0)
+    return -1;
+  return minisat_model_value (fsat->solver, bvar_eq_x_y);
+}
+
 /**
  * Test if the boolean abstraction fsat implies [x in alpha]
  * with x and alpha valid location resp. set variables identifiers.
@@ -2721,13 +3198,10 @@ noll2sat_is_in (noll_sat_t * fsat, uid_t x, uid_t alpha)
   assert (x < noll_vector_size (fsat->form->lvars));
   assert (alpha < noll_vector_size (fsat->form->svars));
 
-  if (fsat->file != NULL)
-    fclose (fsat->file);
-
   // Trivial cases:
   // - x or alpha not used in the formula ==> return -1
   if ((fsat->finfo->used_lvar[x] == false)
-      || (fsat->finfo->used_svar[x] == false))
+      || (fsat->finfo->used_svar[alpha] == false))
     return -1;
 
   // - x and alpha do not have compatible types ==> return 0
@@ -2740,72 +3214,24 @@ noll2sat_is_in (noll_sat_t * fsat, uid_t x, uid_t alpha)
   uid_t bvar_x_in_alpha = noll2sat_get_bvar_in (fsat, x, alpha);
   assert (bvar_x_in_alpha != 0);
 
-  // - write the query to sat
-  size_t fname_len = strlen (fsat->fname);
-
-  //     - print the prefix file with information about variables and clauses
-  char *pre_fname = (char *) malloc ((5 + fname_len) * sizeof (char));
-  memset (pre_fname, 0, (5 + fname_len) * sizeof (char));
-  sprintf (pre_fname, "pre_%s", fsat->fname);
-  FILE *out = fopen (pre_fname, "w");
-  fprintf (out, "p cnf %d %d\n", fsat->no_vars - 1, fsat->no_clauses + 1);      // -1 on no_vars ?
-#ifndef NDEBUG
-  if (noll_option_is_diag())
-  {
-    fprintf (stdout, "---- minisat query prefix: p cnf %d %d\n",
-             fsat->no_vars - 1, fsat->no_clauses + 1);
-  }
-#endif
-  free (pre_fname);
-  fclose (out);
-
   // test positive and negative case
   int res = -1;                 // unknown
-  //    - filename for test [x in alpha]
-  char *in_fname = (char *) malloc ((5 + fname_len) * sizeof (char));
-  memset (in_fname, 0, (5 + fname_len) * sizeof (char));
-  sprintf (in_fname, "in_%s", fsat->fname);
-
-  //    - filename for cat command
-  char *cat_command = (char *) calloc ((100 + 4 * fname_len), sizeof (char));
-  memset (cat_command, 0, (100 + 4 * fname_len) * sizeof (char));
-  sprintf (cat_command,
-           "cat pre_%s %s in_%s 1> full_in_%s", fsat->fname, fsat->fname,
-           fsat->fname, fsat->fname);
-
-  //    - filename for minisat command
-  char *msat_command = (char *) calloc ((100 + 4 * fname_len), sizeof (char));
-  memset (msat_command, 0, (100 + 4 * fname_len) * sizeof (char));
-  sprintf (msat_command,
-           "minisat -verb=0 full_in_%s result.txt 1> msat_in_%s", fsat->fname,
-           fsat->fname);
-  // do the two test (positive and negative)
   for (int tst = 1; tst >= 0; tst--)
     {
-      out = fopen (in_fname, "w");      // remove old content
-      // write a new clause in the in_%s file
-      fprintf (out, "%c%d 0\n", (tst == 1) ? '-' : ' ', bvar_x_in_alpha);
-      fclose (out);
-
-      // build the final file full_in_%s
-      if (system (cat_command) != -1)
-        assert (0);
-
-      // print the minisat command and read result
-      if (system (msat_command) != -1)
+      minisat_lit_t query = (minisat_lit_t) bvar_x_in_alpha;
+      if (tst == 1)
+        query = -query;
+#ifndef NDEBUG
+      if (noll_option_is_diag())
+      {
+        fprintf (stdout, "---- minisat query: %d with %d vars and %d clauses\n",
+                 query, fsat->no_vars - 1, fsat->no_clauses);
+      }
+#endif
+      if (noll2sat_solve (fsat, &query, 1) == 0)
         {
-          FILE *fres = fopen ("result.txt", "r");
-          char s[10];
-          fscanf (fres, "%s", s);
-          fclose (fres);
-          if (strcmp (s, "UNSAT") == 0)
-            {
-              res = tst;
-            }
+          res = tst;
         }
     }
-  free (in_fname);
-  free (cat_command);
-  free (msat_command);
   return res;
 }
@@ -27,6 +27,7 @@
 #include "noll_types.h"
 #include "noll_form.h"
 #include "noll_preds.h"
+#include "minisat_noll_iface.h"
 
 /* ====================================================================== */
 /* Types storing information about the boolean abstraction */
@@ -84,14 +85,40 @@ typedef struct noll_sat_in_s
 
 NOLL_VECTOR_DECLARE (noll_sat_in_array, noll_sat_in_t *);
 
+/* entry of an index of boolean variables, bvar is 0 if free */
+typedef struct noll_sat_index_slot_s
+{
+  uid_t k[3];                   /* key of the atom */
+  uint_t bvar;                  /* boolean variable of the atom */
+} noll_sat_index_slot_t;
+
+/* index by open addressing from atoms to boolean variables */
+typedef struct noll_sat_index_s
+{
+  uint_t mask;                  /* number of slots - 1, a power of 2 - 1 */
+  noll_sat_index_slot_t *slots;
+} noll_sat_index_t;
+
+/* literals of clauses, in the DIMACS convention */
+NOLL_VECTOR_DECLARE (noll_lit_array, minisat_lit_t);
+
 typedef struct noll_sat_s
 {
   noll_form_t *form;            /* formula for which the information is stored */
-  char *fname;                  /* file name used to store the formula */
-  FILE *file;                   /* if fname already open then != NULL, otherwise == NULL */
+  char *fname;                  /* file name used to dump the formula (diagnosis) */
+  noll_lit_array *lits;         /* literals of the clauses of F_sat, in order */
+  noll_uint_array *clauses;     /* start of each clause in lits, the last
+                                   element is the end of the last clause */
+  bool lazy;                    /* clauses built go to the lazy store below */
+  noll_lit_array *lazy_lits;    /* clauses of F_det and F(Lambda) not yet in
+                                   the solver, added when a model violates them */
+  noll_uint_array *lazy_clauses;        /* start of each clause in lazy_lits */
   noll_form_info_t *finfo;      /* form information used in translation */
-  uint_t no_clauses;            /* number of clauses put in the file for F_sat */
+  uint_t no_clauses;            /* number of clauses of F_sat in the stores
+                                   lits and lazy_lits */
   uint_t no_vars;               /* number of vars used */
+  minisat_solver_t *solver;     /* solver loaded with F_sat, NULL before first query */
+  noll_arena_t *arena;          /* storage of the encodings below */
 
   /* encoding of constraints [x = y] for any x, y in environment */
   uint_t start_pure;            /* id of first variable */
@@ -104,22 +131,26 @@ typedef struct noll_sat_s
   uint_t start_pto;             /* id of first variable */
   uint_t size_pto;              /* number of variables, size of the array below */
   noll_sat_space_array *var_pto;        /* sorted array of pto constraints [x,f,y] */
+  noll_sat_index_t idx_pto;     /* index of the array above by (x,f) */
 
   /* encoding of predicate atoms [P,alpha,x,y,z] in phi */
   uint_t start_pred;            /* id of first variable */
   uint_t size_pred;             /* number of variables, size of the array below */
   noll_sat_space_array *var_pred;       /* sorted array of pred atoms P_alpha(x,y,z) */
+  noll_sat_index_t idx_pred;    /* index of the array above by (x,P,alpha) */
 
   /* encoding of anonymous points-to constraints [x,f,alpha]
    * for any x,f,alpha s.t. ty(x)=ty_src(f) in ty_1(alpha), alpha bound in phi */
   uint_t start_apto;            /* id of first variable */
   uint_t size_apto;             /* number of variables, size of the array below */
   noll_sat_space_array *var_apto;       /* sorted array of pto constraints [x,f,alpha] */
+  noll_sat_index_t idx_apto;    /* index of the array above by (x,f,alpha) */
 
   /* encoding of sharing atoms [x in alpha] for any x, alpha in phi */
   uint_t start_inset;           /* id of first variable */
   uint_t size_inset;            /* number of variables, size of the array below */
   noll_sat_in_array *var_inset; /* sorted array of sharing atoms x in alpha */
+  noll_sat_index_t idx_inset;   /* index of the array above by (x,alpha) */
 
 } noll_sat_t;
 
@@ -184,6 +215,9 @@ int noll2sat_det (noll_sat_t * fsat);
 int noll2sat_share (noll_sat_t * fsat);
 /* writes the boolean abstraction of the sharing constraints of "form": F(\Lambda) */
 
+void noll2sat_fprint (FILE * f, noll_sat_t * fsat);
+/* prints the clauses of the boolean abstraction in DIMACS format */
+
 /* ====================================================================== */
 /* Calling Minisat and adding constraints */
 /* ====================================================================== */
@@ -197,6 +231,15 @@ int noll2sat_is_sat (noll_sat_t * fsat);
 /* Returns 1 if form is satisfiable using
  * the boolean abstraction in fsat */
 
+int noll2sat_solve (noll_sat_t * fsat, minisat_lit_t * assums, uint_t size);
+/* Returns 1 if the boolean abstraction in fsat is satisfiable
+ * under the "size" assumptions in "assums", 0 otherwise;
+ * the solver of fsat is built at the first call and kept */
+
+int noll2sat_model_eq (noll_sat_t * fsat, uid_t x, uid_t y);
+/* Returns the value of [x = y] in the last model found
+ * for fsat: 1 if true, 0 if false, -1 if no model */
+
 int noll2sat_is_in (noll_sat_t * fsat, uid_t x, uid_t alpha);
 /* Returns 1 if the boolean abstraction fsat
  * implies that x in alpha, otherwise return 0 */
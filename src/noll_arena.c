@@ -0,0 +1,172 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Region allocator for the objects built during a query.
+ *
+ * An arena is a list of chunks filled in order.
+ * The chunks of the standard size are kept in a pool when their arena
+ * is reset, such that the arenas of the graphs and of the boolean
+ * abstractions built for each query do not call malloc after warm-up.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "noll_arena.h"
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+/* Standard size of chunks, in bytes */
+#define NOLL_ARENA_CHUNK 4096
+
+/* Maximal number of chunks in the pool */
+#define NOLL_ARENA_POOL 256
+
+/* A chunk of an arena */
+typedef struct noll_arena_chunk_s
+{
+  struct noll_arena_chunk_s *prev;      // previously filled chunk
+  size_t used;                  // number of bytes used in data
+  size_t size;                  // number of bytes available in data
+  uint64_t data[];
+} noll_arena_chunk_t;
+
+/* ====================================================================== */
+/* Globals */
+/* ====================================================================== */
+
+/* The pool of free chunks of standard size */
+static noll_arena_chunk_t *noll_arena_pool = NULL;
+static size_t noll_arena_pool_size = 0;
+
+/* ====================================================================== */
+/* Chunks */
+/* ====================================================================== */
+
+static noll_arena_chunk_t *
+noll_arena_chunk_new (size_t size)
+{
+  noll_arena_chunk_t *c = NULL;
+  if ((size <= NOLL_ARENA_CHUNK) && (noll_arena_pool != NULL))
+    {
+      c = noll_arena_pool;
+      noll_arena_pool = c->prev;
+      noll_arena_pool_size--;
+    }
+  else
+    {
+      size_t csize = (size > NOLL_ARENA_CHUNK) ? size : NOLL_ARENA_CHUNK;
+      c = (noll_arena_chunk_t *) malloc (sizeof (noll_arena_chunk_t) + csize);
+      assert (c != NULL);
+      c->size = csize;
+    }
+  c->prev = NULL;
+  c->used = 0;
+  return c;
+}
+
+static void
+noll_arena_chunk_release (noll_arena_chunk_t * c)
+{
+  if ((c->size == NOLL_ARENA_CHUNK) && (noll_arena_pool_size < NOLL_ARENA_POOL))
+    {
+      c->prev = noll_arena_pool;
+      noll_arena_pool = c;
+      noll_arena_pool_size++;
+    }
+  else
+    free (c);
+}
+
+/* ====================================================================== */
+/* Arenas */
+/* ====================================================================== */
+
+noll_arena_t *
+noll_arena_new (void)
+{
+  noll_arena_t *a = (noll_arena_t *) malloc (sizeof (noll_arena_t));
+  a->last = NULL;
+  return a;
+}
+
+void
+noll_arena_delete (noll_arena_t * a)
+{
+  if (a == NULL)
+    return;
+  noll_arena_reset (a);
+  free (a);
+}
+
+void
+noll_arena_reset (noll_arena_t * a)
+{
+  assert (a != NULL);
+  while (a->last != NULL)
+    {
+      noll_arena_chunk_t *prev = a->last->prev;
+      noll_arena_chunk_release (a->last);
+      a->last = prev;
+    }
+}
+
+void *
+noll_arena_alloc (noll_arena_t * a, size_t size)
+{
+  assert (a != NULL);
+  // keep the alignment of pointers and 64 bits words
+  size = (size + sizeof (uint64_t) - 1) & ~(sizeof (uint64_t) - 1);
+
+  noll_arena_chunk_t *c = a->last;
+  if ((c == NULL) || (c->used + size > c->size))
+    {
+      // the space left in the last chunk is lost
+      c = noll_arena_chunk_new (size);
+      c->prev = a->last;
+      a->last = c;
+    }
+  void *res = ((char *) c->data) + c->used;
+  c->used += size;
+  return res;
+}
+
+void *
+noll_arena_calloc (noll_arena_t * a, size_t nmemb, size_t size)
+{
+  void *res = noll_arena_alloc (a, nmemb * size);
+  memset (res, 0, nmemb * size);
+  return res;
+}
+
+void
+noll_arena_free (void)
+{
+  while (noll_arena_pool != NULL)
+    {
+      noll_arena_chunk_t *prev = noll_arena_pool->prev;
+      free (noll_arena_pool);
+      noll_arena_pool = prev;
+    }
+  noll_arena_pool_size = 0;
+}
@@ -0,0 +1,66 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Region allocator for the objects built during a query.
+ */
+
+#ifndef NOLL_ARENA_H_
+#define NOLL_ARENA_H_
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+/* Type of arenas, the chunks are private to noll_arena.c */
+  typedef struct noll_arena_s
+  {
+    struct noll_arena_chunk_s *last;    // chunk being filled, NULL if none
+  } noll_arena_t;
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+  noll_arena_t *noll_arena_new (void);
+  void noll_arena_delete (noll_arena_t * a);
+/* Free the arena and all the objects allocated in it */
+
+  void noll_arena_reset (noll_arena_t * a);
+/* Free all the objects allocated in @p a, which may be reused */
+
+  void *noll_arena_alloc (noll_arena_t * a, size_t size);
+  void *noll_arena_calloc (noll_arena_t * a, size_t nmemb, size_t size);
+/* Allocate in @p a an object which is never freed alone.
+ * The result is aligned on 8 bytes. */
+
+  void noll_arena_free (void);
+/* Free the chunks kept for reuse by the arenas. Called at exit. */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NOLL_ARENA_H_ */
@@ -0,0 +1,2323 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Entailment of data constraints (integers and bags of integers).
+ *
+ * The constraints are normalized into atoms (=, <, <= and subset)
+ * identified by their canonical text. The lhs is refuted together
+ * with the negation of each atom of the rhs by a case analysis on the
+ * conditions of ite terms and implications. Each case is checked by
+ * Fourier-Motzkin elimination on the integer constraints, the bags are
+ * expanded into unions of variables and singletons using the lhs
+ * equalities, and the orders and memberships on bags are translated
+ * into integer constraints on their elements.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "noll_data.h"
+#include "noll_option.h"
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+/** Bounds of the search, the checks exceeding them are not proved */
+#define NOLL_DATA_MAX_SPLITS 8  /// nested case splits on conditions
+#define NOLL_DATA_MAX_CASES 64  /// cases of memberships and disequalities
+#define NOLL_DATA_MAX_ROWS 2048 /// rows of the Fourier-Motzkin elimination
+#define NOLL_DATA_MAX_COEF (1L << 40)   /// coefficients of the rows
+
+/** Literals are atoms with a sign bit */
+#define NOLL_DATA_LIT(a,neg) (((a) << 1) | ((neg) ? 1 : 0))
+#define NOLL_DATA_ATOM(l) ((l) >> 1)
+#define NOLL_DATA_NEG(l) (((l) & 1) == 1)
+
+/** Atoms, i.e., data formulas normalized to =, <, <= and subset */
+typedef struct noll_data_atom_s
+{
+  noll_data_op_t kind;          /// NOLL_DATA_EQ, _LT, _LE or _SUBSET
+  bool bag;                     /// the arguments are bags
+  noll_dterm_t *t1;
+  noll_dterm_t *t2;
+  char *key;                    /// canonical text of the atom
+} noll_data_atom_t;
+
+NOLL_VECTOR_DECLARE (noll_data_atom_array, noll_data_atom_t *);
+NOLL_VECTOR_DEFINE (noll_data_atom_array, noll_data_atom_t *);
+
+NOLL_VECTOR_DECLARE (noll_data_key_array, char *);
+NOLL_VECTOR_DEFINE (noll_data_key_array, char *);
+
+NOLL_VECTOR_DECLARE (noll_data_long_array, long);
+NOLL_VECTOR_DEFINE (noll_data_long_array, long);
+
+NOLL_VECTOR_DECLARE (noll_data_ptr_array, void *);
+NOLL_VECTOR_DEFINE (noll_data_ptr_array, void *);
+
+/** Context of a check */
+typedef struct noll_data_ctx_s
+{
+  uint_t nv;                    /// variables of the lhs, existentials are above
+  uint_t nvars;                 /// all variables
+  bool *ex;                     /// existentials, including the variables
+                                /// of the lhs occurring only in the rhs
+  noll_dterm_t **def;           /// definitions of existentials, NULL if none
+  noll_data_atom_array *atoms;
+  noll_uint_array *facts;       /// literals of the lhs
+  noll_uint_array *clauses;     /// binary clauses, as pairs of literals
+  noll_dterm_array *ites;       /// ite terms met ...
+  noll_uint_array *ite_lits;    /// ... and the literal of their condition
+  bool reg;                     /// register the ite terms met
+  bool opaque;                  /// a text depends on the address of a term
+  int *val;                     /// value of atoms: -1 unknown, 0 false, 1 true
+  noll_uint_array *trail;       /// atoms assigned, in order
+} noll_data_ctx_t;
+
+/** Components of bags: variables, singletons or opaque terms */
+typedef struct noll_data_elt_s
+{
+  char *key;                    /// canonical text
+  noll_dterm_t *t;              /// element of a singleton, NULL otherwise
+  noll_dterm_t *sup;            /// bag including the component, or NULL
+  struct noll_data_elt_s *whole;        /// component equal to this one plus ...
+  struct noll_data_elt_s *out;  /// ... the element out, or NULL
+} noll_data_elt_t;
+
+NOLL_VECTOR_DECLARE (noll_data_elt_array, noll_data_elt_t *);
+NOLL_VECTOR_DEFINE (noll_data_elt_array, noll_data_elt_t *);
+
+/** Relations between components, or between integer terms */
+typedef struct noll_data_pair_s
+{
+  noll_data_elt_t *a;
+  noll_data_elt_t *b;
+  bool strict;                  /// for orders
+} noll_data_pair_t;
+
+NOLL_VECTOR_DECLARE (noll_data_pair_array, noll_data_pair_t *);
+NOLL_VECTOR_DEFINE (noll_data_pair_array, noll_data_pair_t *);
+
+/** Disjunctions: the element e in one of the components of nf,
+ *  or e < f or f < e if nf is NULL */
+typedef struct noll_data_case_s
+{
+  noll_data_elt_t *e;
+  noll_data_elt_t *f;
+  noll_data_elt_array *nf;
+} noll_data_case_t;
+
+NOLL_VECTOR_DECLARE (noll_data_case_array, noll_data_case_t *);
+NOLL_VECTOR_DEFINE (noll_data_case_array, noll_data_case_t *);
+
+/** Theory of the literals assigned in a context */
+typedef struct noll_data_th_s
+{
+  noll_data_ctx_t *ctx;
+  /* integers */
+  noll_data_long_array *rows;   /// rows: size n, constant, equality, then
+                                /// n pairs column, coefficient
+  uint_t ncols;
+  int *var_col;                 /// column of integer variables, -1 if none
+  noll_data_key_array *okeys;   /// opaque integer terms ...
+  noll_uint_array *ocols;       /// ... and their columns
+  /* bags */
+  uint_t *uf;                   /// union-find of the bag variables
+  noll_dterm_t **bdef;          /// definitions of the classes
+  bool *busy;                   /// classes being expanded
+  noll_data_pair_array *ord;    /// components ordered (a < b or a <= b)
+  noll_data_pair_array *in;     /// element a in component b
+  noll_data_pair_array *notin;  /// element a not in component b
+  noll_data_case_array *cases;
+  bool unsat;                   /// contradiction found while building
+  noll_data_ptr_array *mem;     /// memory freed with the theory
+} noll_data_th_t;
+
+/** Entries of the cache of results */
+typedef struct noll_data_entry_s
+{
+  char *key;
+  uint_t hash;
+  int res;
+  struct noll_data_entry_s *next;
+} noll_data_entry_t;
+
+/* ====================================================================== */
+/* Globals */
+/* ====================================================================== */
+
+/* hash table of the results, buckets chained by next */
+static noll_data_entry_t **data_cache = NULL;
+static uint_t data_cache_buckets = 0;
+static uint_t data_cache_size = 0;
+
+/* ====================================================================== */
+/* Canonical texts */
+/* ====================================================================== */
+
+static bool noll_data_norm (noll_data_ctx_t * ctx, noll_dform_t * f,
+                            noll_data_atom_t * a, bool *neg);
+static uint_t noll_data_intern (noll_data_ctx_t * ctx, noll_data_atom_t * a);
+
+/**
+ * Follow the definitions of existentials.
+ */
+static noll_dterm_t *
+noll_data_deref (noll_data_ctx_t * ctx, noll_dterm_t * t)
+{
+  while ((t != NULL) && (t->kind == NOLL_DATA_VAR)
+         && (t->p.sid < ctx->nvars) && (ctx->def[t->p.sid] != NULL))
+    t = ctx->def[t->p.sid];
+  return t;
+}
+
+static bool
+noll_data_is_bag (noll_dterm_t * t)
+{
+  switch (t->kind)
+    {
+    case NOLL_DATA_EMPTYBAG:
+    case NOLL_DATA_BAG:
+    case NOLL_DATA_BAGUNION:
+    case NOLL_DATA_BAGMINUS:
+      return true;
+    default:
+      return (t->typ == NOLL_TYP_BAGINT);
+    }
+}
+
+static int
+noll_data_strcmp (const void *a, const void *b)
+{
+  return strcmp (*(char *const *) a, *(char *const *) b);
+}
+
+static char *noll_data_term_key (noll_data_ctx_t * ctx, noll_dterm_t * t);
+
+/**
+ * Push in @p keys the texts of the arguments of @p t,
+ * the nested terms of kind @p kind are flattened.
+ */
+static void
+noll_data_flat_keys (noll_data_ctx_t * ctx, noll_data_op_t kind,
+                     noll_dterm_t * t, noll_data_key_array * keys)
+{
+  t = noll_data_deref (ctx, t);
+  if ((t->kind == kind) && (t->args != NULL))
+    {
+      for (uint_t i = 0; i < noll_vector_size (t->args); i++)
+        noll_data_flat_keys (ctx, kind, noll_vector_at (t->args, i), keys);
+      return;
+    }
+  if ((kind == NOLL_DATA_BAGUNION) && (t->kind == NOLL_DATA_EMPTYBAG))
+    return;
+  noll_data_key_array_push (keys, noll_data_term_key (ctx, t));
+}
+
+/**
+ * Register the ite term @p t with the literal of its condition.
+ */
+static void
+noll_data_register_ite (noll_data_ctx_t * ctx, noll_dterm_t * t,
+                        noll_data_atom_t * a, bool neg)
+{
+  for (uint_t i = 0; i < noll_vector_size (ctx->ites); i++)
+    if (noll_vector_at (ctx->ites, i) == t)
+      return;
+  noll_data_atom_t c = *a;
+  c.key = strdup (a->key);
+  uint_t lit = NOLL_DATA_LIT (noll_data_intern (ctx, &c), neg);
+  noll_dterm_array_push (ctx->ites, t);
+  noll_uint_array_push (ctx->ite_lits, lit);
+}
+
+/**
+ * Canonical text of the term @p t: the variables are given by their
+ * index, the arguments of sums and unions are sorted.
+ * @return the text, to be freed
+ */
+static char *
+noll_data_term_key (noll_data_ctx_t * ctx, noll_dterm_t * t)
+{
+  t = noll_data_deref (ctx, t);
+  char *buf = NULL;
+  size_t size = 0;
+  FILE *f = open_memstream (&buf, &size);
+  uint_t nargs = (t->args == NULL) ? 0 : noll_vector_size (t->args);
+  switch (t->kind)
+    {
+    case NOLL_DATA_INT:
+      fprintf (f, "%ld", t->p.value);
+      break;
+    case NOLL_DATA_VAR:
+      fprintf (f, "%c%u", noll_data_is_bag (t) ? 'b' : 'i', t->p.sid);
+      break;
+    case NOLL_DATA_EMPTYBAG:
+      fprintf (f, "emptybag");
+      break;
+    case NOLL_DATA_PLUS:
+    case NOLL_DATA_BAGUNION:
+      {
+        noll_data_key_array *keys = noll_data_key_array_new ();
+        noll_data_flat_keys (ctx, t->kind, t, keys);
+        uint_t n = noll_vector_size (keys);
+        if (n == 0)
+          fprintf (f, (t->kind == NOLL_DATA_PLUS) ? "0" : "emptybag");
+        else if (n == 1)
+          fprintf (f, "%s", noll_vector_at (keys, 0));
+        else
+          {
+            qsort (noll_vector_array (keys), n, sizeof (char *),
+                   noll_data_strcmp);
+            fprintf (f, "(%s", (t->kind == NOLL_DATA_PLUS) ? "+" : "bagunion");
+            for (uint_t i = 0; i < n; i++)
+              fprintf (f, " %s", noll_vector_at (keys, i));
+            fprintf (f, ")");
+          }
+        for (uint_t i = 0; i < n; i++)
+          free (noll_vector_at (keys, i));
+        noll_data_key_array_delete (keys);
+        break;
+      }
+    case NOLL_DATA_ITE:
+      {
+        noll_data_atom_t a;
+        bool neg = false;
+        if ((nargs != 2) || !noll_data_norm (ctx, t->p.cond, &a, &neg))
+          {
+            /* not interpreted, the term is identified by its address */
+            fprintf (f, "(ite? %p)", (void *) t);
+            ctx->opaque = true;
+            break;
+          }
+        if (ctx->reg)
+          noll_data_register_ite (ctx, t, &a, neg);
+        char *k1 = noll_data_term_key (ctx, noll_vector_at (t->args, 0));
+        char *k2 = noll_data_term_key (ctx, noll_vector_at (t->args, 1));
+        fprintf (f, "(ite %s %s %s)", a.key, (neg) ? k2 : k1,
+                 (neg) ? k1 : k2);
+        free (a.key);
+        free (k1);
+        free (k2);
+        break;
+      }
+    default:
+      {
+        switch (t->kind)
+          {
+          case NOLL_DATA_MINUS:
+            fprintf (f, "(-");
+            break;
+          case NOLL_DATA_BAG:
+            fprintf (f, "(bag");
+            break;
+          case NOLL_DATA_BAGMINUS:
+            fprintf (f, "(bagminus");
+            break;
+          case NOLL_DATA_FIELD:
+            fprintf (f, "(f%u", t->p.sid);
+            break;
+          default:
+            fprintf (f, "(op%d", t->kind);
+            break;
+          }
+        for (uint_t i = 0; i < nargs; i++)
+          {
+            char *k = noll_data_term_key (ctx, noll_vector_at (t->args, i));
+            fprintf (f, " %s", k);
+            free (k);
+          }
+        fprintf (f, ")");
+        break;
+      }
+    }
+  fclose (f);
+  return buf;
+}
+
+/**
+ * Set the canonical text of the atom @p a, the arguments of
+ * equalities are sorted.
+ */
+static void
+noll_data_atom_key (noll_data_ctx_t * ctx, noll_data_atom_t * a)
+{
+  char *k1 = noll_data_term_key (ctx, a->t1);
+  char *k2 = noll_data_term_key (ctx, a->t2);
+  if ((a->kind == NOLL_DATA_EQ) && (strcmp (k1, k2) > 0))
+    {
+      char *k = k1;
+      k1 = k2;
+      k2 = k;
+      noll_dterm_t *t = a->t1;
+      a->t1 = a->t2;
+      a->t2 = t;
+    }
+  const char *op = "subset";
+  if (a->kind == NOLL_DATA_EQ)
+    op = "=";
+  else if (a->kind == NOLL_DATA_LT)
+    op = "<";
+  else if (a->kind == NOLL_DATA_LE)
+    op = "<=";
+  size_t len = strlen (op) + strlen (k1) + strlen (k2) + 5;
+  a->key = (char *) malloc (len);
+  snprintf (a->key, len, "(%s %s %s)", op, k1, k2);
+  free (k1);
+  free (k2);
+}
+
+/**
+ * Normalize the formula @p f into the atom @p a (with its text)
+ * and the sign @p neg.
+ * @return false if @p f is not supported
+ */
+static bool
+noll_data_norm (noll_data_ctx_t * ctx, noll_dform_t * f,
+                noll_data_atom_t * a, bool *neg)
+{
+  if ((f == NULL) || (f->kind == NOLL_DATA_IMPLIES)
+      || (f->p.targs == NULL) || (noll_vector_size (f->p.targs) != 2))
+    return false;
+  noll_dterm_t *t1 = noll_vector_at (f->p.targs, 0);
+  noll_dterm_t *t2 = noll_vector_at (f->p.targs, 1);
+  if ((t1 == NULL) || (t2 == NULL))
+    return false;
+  *neg = false;
+  a->t1 = t1;
+  a->t2 = t2;
+  switch (f->kind)
+    {
+    case NOLL_DATA_NEQ:
+      *neg = true;
+      /* fall through */
+    case NOLL_DATA_EQ:
+      a->kind = NOLL_DATA_EQ;
+      break;
+    case NOLL_DATA_GT:
+      a->t1 = t2;
+      a->t2 = t1;
+      /* fall through */
+    case NOLL_DATA_LT:
+      a->kind = NOLL_DATA_LT;
+      break;
+    case NOLL_DATA_GE:
+      a->t1 = t2;
+      a->t2 = t1;
+      /* fall through */
+    case NOLL_DATA_LE:
+      a->kind = NOLL_DATA_LE;
+      break;
+    case NOLL_DATA_SUBSET:
+      a->kind = NOLL_DATA_SUBSET;
+      break;
+    default:
+      return false;
+    }
+  a->bag = noll_data_is_bag (noll_data_deref (ctx, t1))
+    || noll_data_is_bag (noll_data_deref (ctx, t2));
+  noll_data_atom_key (ctx, a);
+  return true;
+}
+
+/**
+ * Get the atom with the text of @p a, or add a copy of @p a.
+ * @return the index of the atom
+ */
+static uint_t
+noll_data_intern (noll_data_ctx_t * ctx, noll_data_atom_t * a)
+{
+  for (uint_t i = 0; i < noll_vector_size (ctx->atoms); i++)
+    if (strcmp (noll_vector_at (ctx->atoms, i)->key, a->key) == 0)
+      {
+        free (a->key);
+        return i;
+      }
+  noll_data_atom_t *na = (noll_data_atom_t *) malloc (sizeof (noll_data_atom_t));
+  *na = *a;
+  noll_data_atom_array_push (ctx->atoms, na);
+  return noll_vector_size (ctx->atoms) - 1;
+}
+
+/**
+ * @return the literal of the formula @p f or UNDEFINED_ID
+ */
+static uint_t
+noll_data_lit_of (noll_data_ctx_t * ctx, noll_dform_t * f)
+{
+  noll_data_atom_t a;
+  bool neg;
+  if (!noll_data_norm (ctx, f, &a, &neg))
+    return UNDEFINED_ID;
+  return NOLL_DATA_LIT (noll_data_intern (ctx, &a), neg);
+}
+
+/**
+ * Print the canonical text of @p f in @p out.
+ */
+static void
+noll_data_form_key (noll_data_ctx_t * ctx, noll_dform_t * f, FILE * out)
+{
+  noll_data_atom_t a;
+  bool neg;
+  if ((f != NULL) && (f->kind == NOLL_DATA_IMPLIES) && (f->p.bargs != NULL))
+    {
+      fprintf (out, "(=>");
+      for (uint_t i = 0; i < noll_vector_size (f->p.bargs); i++)
+        {
+          fprintf (out, " ");
+          noll_data_form_key (ctx, noll_vector_at (f->p.bargs, i), out);
+        }
+      fprintf (out, ")");
+    }
+  else if (noll_data_norm (ctx, f, &a, &neg))
+    {
+      fprintf (out, "%s%s", (neg) ? "!" : "", a.key);
+      free (a.key);
+    }
+  else
+    fprintf (out, "?");
+}
+
+/* ====================================================================== */
+/* Context */
+/* ====================================================================== */
+
+static void
+noll_data_ctx_init (noll_data_ctx_t * ctx, uint_t nv, uint_t nvars)
+{
+  ctx->nv = nv;
+  ctx->nvars = nvars;
+  ctx->def = (noll_dterm_t **) calloc (nvars + 1, sizeof (noll_dterm_t *));
+  ctx->ex = (bool *) calloc (nvars + 1, sizeof (bool));
+  for (uint_t v = nv; v < nvars; v++)
+    ctx->ex[v] = true;
+  ctx->atoms = noll_data_atom_array_new ();
+  ctx->facts = noll_uint_array_new ();
+  ctx->clauses = noll_uint_array_new ();
+  ctx->ites = noll_dterm_array_new ();
+  ctx->ite_lits = noll_uint_array_new ();
+  ctx->reg = false;
+  ctx->opaque = false;
+  ctx->val = NULL;
+  ctx->trail = noll_uint_array_new ();
+}
+
+static void
+noll_data_ctx_free (noll_data_ctx_t * ctx)
+{
+  for (uint_t i = 0; i < noll_vector_size (ctx->atoms); i++)
+    {
+      free (noll_vector_at (ctx->atoms, i)->key);
+      free (noll_vector_at (ctx->atoms, i));
+    }
+  noll_data_atom_array_delete (ctx->atoms);
+  noll_uint_array_delete (ctx->facts);
+  noll_uint_array_delete (ctx->clauses);
+  noll_dterm_array_delete (ctx->ites);
+  noll_uint_array_delete (ctx->ite_lits);
+  noll_uint_array_delete (ctx->trail);
+  free (ctx->def);
+  free (ctx->ex);
+  free (ctx->val);
+}
+
+/**
+ * @return the value of the literal @p l: -1 unknown, 0 false, 1 true
+ */
+static int
+noll_data_lit_val (noll_data_ctx_t * ctx, uint_t l)
+{
+  int v = ctx->val[NOLL_DATA_ATOM (l)];
+  if (v < 0)
+    return v;
+  return (NOLL_DATA_NEG (l)) ? 1 - v : v;
+}
+
+static void
+noll_data_assign (noll_data_ctx_t * ctx, uint_t l)
+{
+  ctx->val[NOLL_DATA_ATOM (l)] = (NOLL_DATA_NEG (l)) ? 0 : 1;
+  noll_uint_array_push (ctx->trail, NOLL_DATA_ATOM (l));
+}
+
+static void
+noll_data_undo (noll_data_ctx_t * ctx, uint_t mark)
+{
+  while (noll_vector_size (ctx->trail) > mark)
+    {
+      ctx->val[noll_vector_last (ctx->trail)] = -1;
+      noll_uint_array_pop (ctx->trail);
+    }
+}
+
+/**
+ * Propagate the binary clauses.
+ * @return false if a clause is false
+ */
+static bool
+noll_data_propagate (noll_data_ctx_t * ctx)
+{
+  bool changed = true;
+  while (changed)
+    {
+      changed = false;
+      for (uint_t i = 0; i < noll_vector_size (ctx->clauses); i += 2)
+        {
+          uint_t l1 = noll_vector_at (ctx->clauses, i);
+          uint_t l2 = noll_vector_at (ctx->clauses, i + 1);
+          int v1 = noll_data_lit_val (ctx, l1);
+          int v2 = noll_data_lit_val (ctx, l2);
+          if ((v1 == 1) || (v2 == 1))
+            continue;
+          if ((v1 == 0) && (v2 == 0))
+            return false;
+          if (v1 == 0)
+            noll_data_assign (ctx, l2);
+          else if (v2 == 0)
+            noll_data_assign (ctx, l1);
+          else
+            continue;
+          changed = true;
+        }
+    }
+  return true;
+}
+
+/**
+ * @return the branch of the ite term @p t selected by the current
+ *         assignment (0 for then, 1 for else) or -1 if unknown
+ */
+static int
+noll_data_ite_branch (noll_data_ctx_t * ctx, noll_dterm_t * t)
+{
+  for (uint_t i = 0; i < noll_vector_size (ctx->ites); i++)
+    if (noll_vector_at (ctx->ites, i) == t)
+      {
+        int v = noll_data_lit_val (ctx, noll_vector_at (ctx->ite_lits, i));
+        return (v < 0) ? -1 : 1 - v;
+      }
+  return -1;
+}
+
+/**
+ * @return the atom of the condition of an ite term in @p t
+ *         not selected by the current assignment, or UNDEFINED_ID
+ */
+static uint_t
+noll_data_find_ite (noll_data_ctx_t * ctx, noll_dterm_t * t)
+{
+  t = noll_data_deref (ctx, t);
+  if (t->kind == NOLL_DATA_ITE)
+    {
+      for (uint_t i = 0; i < noll_vector_size (ctx->ites); i++)
+        if (noll_vector_at (ctx->ites, i) == t)
+          {
+            uint_t l = noll_vector_at (ctx->ite_lits, i);
+            if (noll_data_lit_val (ctx, l) < 0)
+              return NOLL_DATA_ATOM (l);
+            int b = noll_data_ite_branch (ctx, t);
+            return noll_data_find_ite (ctx, noll_vector_at (t->args, b));
+          }
+      return UNDEFINED_ID;
+    }
+  if (t->kind <= NOLL_DATA_EMPTYBAG || t->args == NULL)
+    return UNDEFINED_ID;
+  for (uint_t i = 0; i < noll_vector_size (t->args); i++)
+    {
+      uint_t a = noll_data_find_ite (ctx, noll_vector_at (t->args, i));
+      if (a != UNDEFINED_ID)
+        return a;
+    }
+  return UNDEFINED_ID;
+}
+
+/**
+ * Variables of the lhs occurring in @p t (resp. @p f) are not existentials.
+ */
+static void noll_data_mark_form (noll_data_ctx_t * ctx, noll_dform_t * f);
+
+static void
+noll_data_mark_term (noll_data_ctx_t * ctx, noll_dterm_t * t)
+{
+  if (t == NULL)
+    return;
+  if (t->kind == NOLL_DATA_VAR)
+    {
+      if (t->p.sid < ctx->nv)
+        ctx->ex[t->p.sid] = false;
+      return;
+    }
+  if ((t->kind == NOLL_DATA_ITE) && (t->p.cond != NULL))
+    noll_data_mark_form (ctx, t->p.cond);
+  if (t->args != NULL)
+    for (uint_t i = 0; i < noll_vector_size (t->args); i++)
+      noll_data_mark_term (ctx, noll_vector_at (t->args, i));
+}
+
+static void
+noll_data_mark_form (noll_data_ctx_t * ctx, noll_dform_t * f)
+{
+  if (f->kind == NOLL_DATA_IMPLIES)
+    {
+      if (f->p.bargs != NULL)
+        for (uint_t i = 0; i < noll_vector_size (f->p.bargs); i++)
+          noll_data_mark_form (ctx, noll_vector_at (f->p.bargs, i));
+    }
+  else if (f->p.targs != NULL)
+    for (uint_t i = 0; i < noll_vector_size (f->p.targs); i++)
+      noll_data_mark_term (ctx, noll_vector_at (f->p.targs, i));
+}
+
+/**
+ * @return true if the existential @p sid occurs in @p t
+ */
+static bool
+noll_data_occurs (noll_data_ctx_t * ctx, noll_dterm_t * t, uid_t sid)
+{
+  t = noll_data_deref (ctx, t);
+  if (t->kind == NOLL_DATA_VAR)
+    return (t->p.sid == sid);
+  if (t->kind <= NOLL_DATA_EMPTYBAG)
+    return false;
+  if ((t->kind == NOLL_DATA_ITE) && (t->p.cond != NULL)
+      && (t->p.cond->kind != NOLL_DATA_IMPLIES)
+      && (t->p.cond->p.targs != NULL))
+    for (uint_t i = 0; i < noll_vector_size (t->p.cond->p.targs); i++)
+      if (noll_data_occurs (ctx, noll_vector_at (t->p.cond->p.targs, i), sid))
+        return true;
+  if (t->args != NULL)
+    for (uint_t i = 0; i < noll_vector_size (t->args); i++)
+      if (noll_data_occurs (ctx, noll_vector_at (t->args, i), sid))
+        return true;
+  return false;
+}
+
+/* ====================================================================== */
+/* Integer constraints */
+/* ====================================================================== */
+
+static long
+noll_data_gcd (long a, long b)
+{
+  while (b != 0)
+    {
+      long r = a % b;
+      a = b;
+      b = r;
+    }
+  return (a < 0) ? -a : a;
+}
+
+/**
+ * Normalize the row @p r of @p nc columns (the last one is the
+ * constant) by the gcd of its coefficients, with integer tightening.
+ * @return -1 if the row is contradictory, 0 if trivial, 1 otherwise
+ */
+static int
+noll_data_fm_norm (long *r, uint_t nc, bool eq)
+{
+  long g = 0;
+  for (uint_t j = 0; j + 1 < nc; j++)
+    g = noll_data_gcd (g, r[j]);
+  long k = r[nc - 1];
+  if (g == 0)
+    return ((eq) ? (k != 0) : (k > 0)) ? -1 : 0;
+  if (g > 1)
+    {
+      if (eq && (k % g != 0))
+        return -1;
+      /* sum c x + k <= 0 iff sum (c/g) x + ceil(k/g) <= 0 on integers */
+      r[nc - 1] = (k >= 0) ? (k + g - 1) / g : -((-k) / g);
+      for (uint_t j = 0; j + 1 < nc; j++)
+        r[j] /= g;
+    }
+  return 1;
+}
+
+/**
+ * Compute a * @p r1 - b * @p r2 in @p r1.
+ * @return false on overflow
+ */
+static bool
+noll_data_fm_comb (long *r1, long a, const long *r2, long b, uint_t nc)
+{
+  for (uint_t j = 0; j < nc; j++)
+    {
+      long v = a * r1[j] - b * r2[j];
+      if ((v > NOLL_DATA_MAX_COEF) || (v < -NOLL_DATA_MAX_COEF))
+        return false;
+      r1[j] = v;
+    }
+  return true;
+}
+
+/**
+ * Fourier-Motzkin elimination on the rows @p m (freed) such that
+ * sum c x + k = 0 if @p eq, sum c x + k <= 0 otherwise.
+ * The equalities are eliminated first.
+ * @return true if the rows have no solution
+ */
+static bool
+noll_data_fm_solve (long **m, bool *eq, uint_t nr, uint_t nc)
+{
+  bool res = false;
+  uint_t i = 0;
+  /* normalize and remove the trivial rows */
+  while (i < nr)
+    {
+      int s = noll_data_fm_norm (m[i], nc, eq[i]);
+      if (s < 0)
+        {
+          res = true;
+          goto fm_solve_end;
+        }
+      if (s == 0)
+        {
+          free (m[i]);
+          m[i] = m[--nr];
+          eq[i] = eq[nr];
+        }
+      else
+        i++;
+    }
+
+  /* eliminate the equalities */
+  for (;;)
+    {
+      uint_t ie = nr;
+      uint_t je = nc;
+      for (i = 0; i < nr; i++)
+        if (eq[i])
+          {
+            for (uint_t j = 0; j + 1 < nc; j++)
+              if ((m[i][j] != 0)
+                  && ((je == nc) || (labs (m[i][j]) < labs (m[i][je]))))
+                je = j;
+            ie = i;
+            break;
+          }
+      if (ie == nr)
+        break;
+      long a = labs (m[ie][je]);
+      long sg = (m[ie][je] > 0) ? 1 : -1;
+      for (i = 0; i < nr; i++)
+        {
+          if ((i == ie) || (m[i][je] == 0))
+            continue;
+          if (!noll_data_fm_comb (m[i], a, m[ie], sg * m[i][je], nc))
+            goto fm_solve_end;
+        }
+      free (m[ie]);
+      m[ie] = m[--nr];
+      eq[ie] = eq[nr];
+      for (i = 0; i < nr;)
+        {
+          int s = noll_data_fm_norm (m[i], nc, eq[i]);
+          if (s < 0)
+            {
+              res = true;
+              goto fm_solve_end;
+            }
+          if (s == 0)
+            {
+              free (m[i]);
+              m[i] = m[--nr];
+              eq[i] = eq[nr];
+            }
+          else
+            i++;
+        }
+    }
+
+  /* eliminate the variables from the inequalities */
+  for (;;)
+    {
+      uint_t jb = nc;
+      uint_t best = 0;
+      uint_t bpos = 0, bneg = 0;
+      for (uint_t j = 0; j + 1 < nc; j++)
+        {
+          uint_t npos = 0, nneg = 0;
+          for (i = 0; i < nr; i++)
+            if (m[i][j] > 0)
+              npos++;
+            else if (m[i][j] < 0)
+              nneg++;
+          if (npos + nneg == 0)
+            continue;
+          if ((jb == nc) || (npos * nneg < best))
+            {
+              jb = j;
+              best = npos * nneg;
+              bpos = npos;
+              bneg = nneg;
+            }
+        }
+      if (jb == nc)
+        break;                  /* no variable left, no contradiction */
+      if (nr - bpos - bneg + best > NOLL_DATA_MAX_ROWS)
+        goto fm_solve_end;      /* too big, not proved */
+      uint_t nnr = nr - bpos - bneg + best;
+      long **nm = (long **) malloc ((nnr + 1) * sizeof (long *));
+      uint_t k = 0;
+      for (i = 0; i < nr; i++)
+        if (m[i][jb] == 0)
+          nm[k++] = m[i];
+      bool ovf = false;
+      for (i = 0; i < nr && !ovf; i++)
+        if (m[i][jb] > 0)
+          for (uint_t i2 = 0; i2 < nr; i2++)
+            if (m[i2][jb] < 0)
+              {
+                long *r = (long *) malloc (nc * sizeof (long));
+                memcpy (r, m[i], nc * sizeof (long));
+                if (!noll_data_fm_comb (r, -m[i2][jb], m[i2], -m[i][jb], nc))
+                  {
+                    free (r);
+                    ovf = true;
+                    break;
+                  }
+                int s = noll_data_fm_norm (r, nc, false);
+                if (s < 0)
+                  res = true;
+                if (s <= 0)
+                  free (r);
+                else
+                  nm[k++] = r;
+              }
+      for (i = 0; i < nr; i++)
+        if (m[i][jb] != 0)
+          free (m[i]);
+      free (m);
+      m = nm;
+      nr = k;
+      for (i = 0; i < nr; i++)
+        eq[i] = false;
+      if (res || ovf)
+        goto fm_solve_end;
+    }
+
+fm_solve_end:
+  for (i = 0; i < nr; i++)
+    free (m[i]);
+  free (m);
+  return res;
+}
+
+/* ====================================================================== */
+/* Theory of an assignment */
+/* ====================================================================== */
+
+static void
+noll_data_th_init (noll_data_th_t * th, noll_data_ctx_t * ctx)
+{
+  th->ctx = ctx;
+  th->rows = noll_data_long_array_new ();
+  th->ncols = 0;
+  th->var_col = (int *) malloc ((ctx->nvars + 1) * sizeof (int));
+  th->uf = (uint_t *) malloc ((ctx->nvars + 1) * sizeof (uint_t));
+  for (uint_t i = 0; i <= ctx->nvars; i++)
+    {
+      th->var_col[i] = -1;
+      th->uf[i] = i;
+    }
+  th->okeys = noll_data_key_array_new ();
+  th->ocols = noll_uint_array_new ();
+  th->bdef = (noll_dterm_t **) calloc (ctx->nvars + 1, sizeof (noll_dterm_t *));
+  th->busy = (bool *) calloc (ctx->nvars + 1, sizeof (bool));
+  th->ord = noll_data_pair_array_new ();
+  th->in = noll_data_pair_array_new ();
+  th->notin = noll_data_pair_array_new ();
+  th->cases = noll_data_case_array_new ();
+  th->unsat = false;
+  th->mem = noll_data_ptr_array_new ();
+}
+
+static void
+noll_data_th_free (noll_data_th_t * th)
+{
+  for (uint_t i = 0; i < noll_vector_size (th->cases); i++)
+    if (noll_vector_at (th->cases, i)->nf != NULL)
+      noll_data_elt_array_delete (noll_vector_at (th->cases, i)->nf);
+  noll_data_case_array_delete (th->cases);
+  for (uint_t i = 0; i < noll_vector_size (th->mem); i++)
+    free (noll_vector_at (th->mem, i));
+  noll_data_ptr_array_delete (th->mem);
+  noll_data_pair_array_delete (th->ord);
+  noll_data_pair_array_delete (th->in);
+  noll_data_pair_array_delete (th->notin);
+  noll_data_long_array_delete (th->rows);
+  noll_data_key_array_delete (th->okeys);
+  noll_uint_array_delete (th->ocols);
+  free (th->var_col);
+  free (th->uf);
+  free (th->bdef);
+  free (th->busy);
+}
+
+/**
+ * Allocate memory freed with the theory.
+ */
+static void *
+noll_data_th_alloc (noll_data_th_t * th, size_t size)
+{
+  void *p = malloc (size);
+  noll_data_ptr_array_push (th->mem, p);
+  return p;
+}
+
+static char *
+noll_data_th_key (noll_data_th_t * th, noll_dterm_t * t)
+{
+  char *k = noll_data_term_key (th->ctx, t);
+  noll_data_ptr_array_push (th->mem, k);
+  return k;
+}
+
+static noll_data_elt_t *
+noll_data_th_elt (noll_data_th_t * th, char *key, noll_dterm_t * t)
+{
+  noll_data_elt_t *e =
+    (noll_data_elt_t *) noll_data_th_alloc (th, sizeof (noll_data_elt_t));
+  e->key = key;
+  e->t = t;
+  e->sup = NULL;
+  e->whole = e->out = NULL;
+  return e;
+}
+
+static noll_data_pair_t *
+noll_data_th_pair (noll_data_th_t * th, noll_data_elt_t * a,
+                   noll_data_elt_t * b, bool strict)
+{
+  noll_data_pair_t *p =
+    (noll_data_pair_t *) noll_data_th_alloc (th, sizeof (noll_data_pair_t));
+  p->a = a;
+  p->b = b;
+  p->strict = strict;
+  return p;
+}
+
+/**
+ * Column of the variable @p sid, or of the opaque term of text @p key.
+ */
+static uint_t
+noll_data_th_col (noll_data_th_t * th, uid_t sid, noll_dterm_t * t)
+{
+  if (t == NULL)
+    {
+      if (th->var_col[sid] < 0)
+        th->var_col[sid] = th->ncols++;
+      return th->var_col[sid];
+    }
+  char *key = noll_data_term_key (th->ctx, t);
+  for (uint_t i = 0; i < noll_vector_size (th->okeys); i++)
+    if (strcmp (noll_vector_at (th->okeys, i), key) == 0)
+      {
+        free (key);
+        return noll_vector_at (th->ocols, i);
+      }
+  noll_data_ptr_array_push (th->mem, key);
+  noll_data_key_array_push (th->okeys, key);
+  noll_uint_array_push (th->ocols, th->ncols);
+  return th->ncols++;
+}
+
+/**
+ * Start a row, @return its position.
+ */
+static uint_t
+noll_data_row_begin (noll_data_th_t * th, bool eq)
+{
+  uint_t r = noll_vector_size (th->rows);
+  noll_data_long_array_push (th->rows, 0);
+  noll_data_long_array_push (th->rows, 0);
+  noll_data_long_array_push (th->rows, (eq) ? 1 : 0);
+  return r;
+}
+
+/**
+ * Add @p coef * @p t to the row at @p r, the terms not linear
+ * are opaque.
+ */
+static void
+noll_data_row_add (noll_data_th_t * th, uint_t r, noll_dterm_t * t, long coef)
+{
+  noll_data_ctx_t *ctx = th->ctx;
+  t = noll_data_deref (ctx, t);
+  uint_t nargs = (t->args == NULL) ? 0 : noll_vector_size (t->args);
+  switch (t->kind)
+    {
+    case NOLL_DATA_INT:
+      noll_vector_at (th->rows, r + 1) += coef * t->p.value;
+      return;
+    case NOLL_DATA_VAR:
+      if (t->p.sid < ctx->nvars)
+        {
+          noll_data_long_array_push (th->rows,
+                                     noll_data_th_col (th, t->p.sid, NULL));
+          noll_data_long_array_push (th->rows, coef);
+          noll_vector_at (th->rows, r)++;
+          return;
+        }
+      break;
+    case NOLL_DATA_PLUS:
+      for (uint_t i = 0; i < nargs; i++)
+        noll_data_row_add (th, r, noll_vector_at (t->args, i), coef);
+      return;
+    case NOLL_DATA_MINUS:
+      if (nargs == 1)
+        noll_data_row_add (th, r, noll_vector_at (t->args, 0), -coef);
+      else
+        for (uint_t i = 0; i < nargs; i++)
+          noll_data_row_add (th, r, noll_vector_at (t->args, i),
+                             (i == 0) ? coef : -coef);
+      return;
+    case NOLL_DATA_ITE:
+      {
+        int b = noll_data_ite_branch (ctx, t);
+        if (b >= 0)
+          {
+            noll_data_row_add (th, r, noll_vector_at (t->args, b), coef);
+            return;
+          }
+        break;
+      }
+    default:
+      break;
+    }
+  noll_data_long_array_push (th->rows, noll_data_th_col (th, 0, t));
+  noll_data_long_array_push (th->rows, coef);
+  noll_vector_at (th->rows, r)++;
+}
+
+/**
+ * Add the row @p t1 - @p t2 + @p k <= 0, or = 0 if @p eq.
+ */
+static void
+noll_data_th_cmp (noll_data_th_t * th, noll_dterm_t * t1, noll_dterm_t * t2,
+                  long k, bool eq)
+{
+  uint_t r = noll_data_row_begin (th, eq);
+  noll_data_row_add (th, r, t1, 1);
+  noll_data_row_add (th, r, t2, -1);
+  noll_vector_at (th->rows, r + 1) += k;
+}
+
+/**
+ * @return true if the rows of the theory have no solution
+ */
+static bool
+noll_data_th_unsat (noll_data_th_t * th)
+{
+  uint_t nc = th->ncols + 1;
+  uint_t nr = 0;
+  uint_t size = noll_vector_size (th->rows);
+  for (uint_t p = 0; p < size; p += 3 + 2 * noll_vector_at (th->rows, p))
+    nr++;
+  long **m = (long **) malloc ((nr + 1) * sizeof (long *));
+  bool *eq = (bool *) malloc ((nr + 1) * sizeof (bool));
+  uint_t i = 0;
+  for (uint_t p = 0; p < size; p += 3 + 2 * noll_vector_at (th->rows, p))
+    {
+      long n = noll_vector_at (th->rows, p);
+      m[i] = (long *) calloc (nc, sizeof (long));
+      m[i][nc - 1] = noll_vector_at (th->rows, p + 1);
+      eq[i] = (noll_vector_at (th->rows, p + 2) != 0);
+      for (long q = 0; q < n; q++)
+        m[i][noll_vector_at (th->rows, p + 3 + 2 * q)] +=
+          noll_vector_at (th->rows, p + 4 + 2 * q);
+      i++;
+    }
+  bool res = noll_data_fm_solve (m, eq, nr, nc);
+  free (eq);
+  return res;
+}
+
+/**
+ * @return true if the theory entails @p t1 - @p t2 + @p k <= 0
+ */
+static bool
+noll_data_th_entails (noll_data_th_t * th, noll_dterm_t * t1,
+                      noll_dterm_t * t2, long k)
+{
+  uint_t mark = noll_vector_size (th->rows);
+  /* refute t2 - t1 - k + 1 <= 0 */
+  noll_data_th_cmp (th, t2, t1, 1 - k, false);
+  bool res = noll_data_th_unsat (th);
+  noll_data_long_array_resize (th->rows, mark);
+  return res;
+}
+
+/**
+ * @return true if the theory entails @p t1 = @p t2
+ */
+static bool
+noll_data_th_entails_eq (noll_data_th_t * th, noll_dterm_t * t1,
+                         noll_dterm_t * t2)
+{
+  return noll_data_th_entails (th, t1, t2, 0)
+    && noll_data_th_entails (th, t2, t1, 0);
+}
+
+/**
+ * @return true if the theory entails @p t1 != @p t2
+ */
+static bool
+noll_data_th_entails_neq (noll_data_th_t * th, noll_dterm_t * t1,
+                          noll_dterm_t * t2)
+{
+  uint_t mark = noll_vector_size (th->rows);
+  noll_data_th_cmp (th, t1, t2, 0, true);
+  bool res = noll_data_th_unsat (th);
+  noll_data_long_array_resize (th->rows, mark);
+  return res;
+}
+
+/**
+ * @return true if the elements of singletons @p a and @p b are equal
+ */
+static bool
+noll_data_th_same (noll_data_th_t * th, noll_data_elt_t * a,
+                   noll_data_elt_t * b)
+{
+  if (strcmp (a->key, b->key) == 0)
+    return true;
+  return (a->t != NULL) && (b->t != NULL)
+    && noll_data_th_entails_eq (th, a->t, b->t);
+}
+
+/* ====================================================================== */
+/* Bags */
+/* ====================================================================== */
+
+static bool noll_data_th_member (noll_data_th_t * th, noll_data_elt_t * e,
+                                 noll_data_elt_array * nf, bool neg);
+
+static uint_t
+noll_data_th_find (noll_data_th_t * th, uint_t x)
+{
+  while (th->uf[x] != x)
+    x = th->uf[x] = th->uf[th->uf[x]];
+  return x;
+}
+
+/**
+ * Push in @p nf the components of the bag @p t, the variables
+ * are expanded by their definitions.
+ */
+static void
+noll_data_th_nf (noll_data_th_t * th, noll_dterm_t * t,
+                 noll_data_elt_array * nf)
+{
+  noll_data_ctx_t *ctx = th->ctx;
+  t = noll_data_deref (ctx, t);
+  uint_t nargs = (t->args == NULL) ? 0 : noll_vector_size (t->args);
+  switch (t->kind)
+    {
+    case NOLL_DATA_EMPTYBAG:
+      return;
+    case NOLL_DATA_VAR:
+      if (t->p.sid < ctx->nvars)
+        {
+          uint_t r = noll_data_th_find (th, t->p.sid);
+          if ((th->bdef[r] != NULL) && !th->busy[r])
+            {
+              th->busy[r] = true;
+              noll_data_th_nf (th, th->bdef[r], nf);
+              th->busy[r] = false;
+              return;
+            }
+          char *key = (char *) noll_data_th_alloc (th, 16);
+          snprintf (key, 16, "b%u", r);
+          noll_data_elt_array_push (nf, noll_data_th_elt (th, key, NULL));
+          return;
+        }
+      break;
+    case NOLL_DATA_BAG:
+      if (nargs == 1)
+        {
+          noll_data_elt_array_push (nf,
+                                    noll_data_th_elt (th,
+                                                      noll_data_th_key (th,
+                                                                        t),
+                                                      noll_vector_at
+                                                      (t->args, 0)));
+          return;
+        }
+      break;
+    case NOLL_DATA_BAGUNION:
+      for (uint_t i = 0; i < nargs; i++)
+        noll_data_th_nf (th, noll_vector_at (t->args, i), nf);
+      return;
+    case NOLL_DATA_ITE:
+      {
+        int b = noll_data_ite_branch (ctx, t);
+        if (b >= 0)
+          {
+            noll_data_th_nf (th, noll_vector_at (t->args, b), nf);
+            return;
+          }
+        break;
+      }
+    case NOLL_DATA_BAGMINUS:
+      {
+        /* (A + {k}) - {k} = A for multisets */
+        noll_dterm_t *s = (nargs == 2)
+          ? noll_data_deref (ctx, noll_vector_at (t->args, 1)) : NULL;
+        if ((s == NULL) || (s->kind != NOLL_DATA_BAG) || (s->args == NULL)
+            || (noll_vector_size (s->args) != 1))
+          break;
+        noll_data_elt_t *k = noll_data_th_elt (th, noll_data_th_key (th, s),
+                                               noll_vector_at (s->args, 0));
+        noll_data_elt_array *sub = noll_data_elt_array_new ();
+        noll_data_th_nf (th, noll_vector_at (t->args, 0), sub);
+        uint_t n = noll_vector_size (sub);
+        uint_t found = n;
+        for (uint_t i = 0; (i < n) && (found == n); i++)
+          if (strcmp (noll_vector_at (sub, i)->key, k->key) == 0)
+            found = i;
+        for (uint_t i = 0; (i < n) && (found == n); i++)
+          if ((noll_vector_at (sub, i)->t != NULL)
+              && noll_data_th_same (th, noll_vector_at (sub, i), k))
+            found = i;
+        if (found < n)
+          {
+            for (uint_t i = 0; i < n; i++)
+              if (i != found)
+                noll_data_elt_array_push (nf, noll_vector_at (sub, i));
+            noll_data_elt_array_delete (sub);
+            return;
+          }
+        /* (A + B) - {k} = A + (B - {k}) if k is not in A */
+        noll_data_elt_t *ke = noll_data_th_elt (th, noll_data_th_key (th, k->t),
+                                                k->t);
+        noll_data_elt_array *one = noll_data_elt_array_new ();
+        noll_data_key_array *keys = noll_data_key_array_new ();
+        noll_data_elt_t *whole = NULL;
+        for (uint_t i = 0; i < n; i++)
+          {
+            noll_data_elt_t *c = noll_vector_at (sub, i);
+            noll_data_elt_array_clear (one);
+            noll_data_elt_array_push (one, c);
+            if (noll_data_th_member (th, ke, one, true))
+              noll_data_elt_array_push (nf, c);
+            else
+              {
+                noll_data_key_array_push (keys, c->key);
+                whole = c;
+              }
+          }
+        /* the only component left contains k */
+        if ((noll_vector_size (keys) == 1) && (whole->t == NULL))
+          {
+            noll_data_elt_array_clear (one);
+            noll_data_elt_array_push (one, whole);
+            if (!noll_data_th_member (th, ke, one, false))
+              whole = NULL;
+          }
+        else
+          whole = NULL;
+        noll_data_elt_array_delete (one);
+        noll_data_elt_array_delete (sub);
+        if (noll_vector_size (keys) > 0)
+          {
+            /* opaque, but included in its first argument */
+            char *buf = NULL;
+            size_t size = 0;
+            FILE *f = open_memstream (&buf, &size);
+            qsort (noll_vector_array (keys), noll_vector_size (keys),
+                   sizeof (char *), noll_data_strcmp);
+            fprintf (f, "(bagminus");
+            for (uint_t i = 0; i < noll_vector_size (keys); i++)
+              fprintf (f, " %s", noll_vector_at (keys, i));
+            fprintf (f, " %s)", k->key);
+            fclose (f);
+            noll_data_ptr_array_push (th->mem, buf);
+            noll_data_elt_t *e = noll_data_th_elt (th, buf, NULL);
+            e->sup = noll_vector_at (t->args, 0);
+            if (whole != NULL)
+              {
+                e->whole = whole;
+                e->out = ke;
+              }
+            noll_data_elt_array_push (nf, e);
+          }
+        noll_data_key_array_delete (keys);
+        return;
+      }
+    default:
+      break;
+    }
+  /* opaque component */
+  noll_data_elt_array_push (nf,
+                            noll_data_th_elt (th, noll_data_th_key (th, t),
+                                              NULL));
+}
+
+static noll_data_elt_array *
+noll_data_th_nf_new (noll_data_th_t * th, noll_dterm_t * t)
+{
+  noll_data_elt_array *nf = noll_data_elt_array_new ();
+  noll_data_th_nf (th, t, nf);
+  return nf;
+}
+
+/**
+ * Define the class of bag variable @p x by @p t.
+ */
+static void
+noll_data_th_define (noll_data_th_t * th, noll_dterm_t * x, noll_dterm_t * t)
+{
+  uint_t r = noll_data_th_find (th, x->p.sid);
+  if (th->bdef[r] != NULL)
+    return;
+  /* no direct cycle */
+  noll_dterm_t *s = noll_data_deref (th->ctx, t);
+  if ((s->kind == NOLL_DATA_VAR) && (s->p.sid < th->ctx->nvars)
+      && (noll_data_th_find (th, s->p.sid) == r))
+    return;
+  if (s->args != NULL)
+    for (uint_t i = 0; i < noll_vector_size (s->args); i++)
+      {
+        noll_dterm_t *a = noll_data_deref (th->ctx, noll_vector_at (s->args, i));
+        if ((a->kind == NOLL_DATA_VAR) && (a->p.sid < th->ctx->nvars)
+            && (noll_data_th_find (th, a->p.sid) == r))
+          return;
+      }
+  th->bdef[r] = t;
+}
+
+/**
+ * Use the bag equality @p a if its kind of definition fits @p prio:
+ * 0 for variables, 1 for unions and singletons, 2 for other terms.
+ */
+static void
+noll_data_th_bag_eq (noll_data_th_t * th, noll_data_atom_t * a, int prio)
+{
+  noll_data_ctx_t *ctx = th->ctx;
+  noll_dterm_t *t1 = noll_data_deref (ctx, a->t1);
+  noll_dterm_t *t2 = noll_data_deref (ctx, a->t2);
+  bool v1 = (t1->kind == NOLL_DATA_VAR) && (t1->p.sid < ctx->nvars);
+  bool v2 = (t2->kind == NOLL_DATA_VAR) && (t2->p.sid < ctx->nvars);
+  if (v1 && v2)
+    {
+      if (prio == 0)
+        {
+          uint_t r1 = noll_data_th_find (th, t1->p.sid);
+          uint_t r2 = noll_data_th_find (th, t2->p.sid);
+          if (r1 != r2)
+            {
+              th->uf[r2] = r1;
+              if (th->bdef[r1] == NULL)
+                th->bdef[r1] = th->bdef[r2];
+            }
+        }
+      return;
+    }
+  if (!v1 && !v2)
+    return;
+  noll_dterm_t *x = (v1) ? t1 : t2;
+  noll_dterm_t *t = (v1) ? t2 : t1;
+  bool simple = (t->kind == NOLL_DATA_BAGUNION) || (t->kind == NOLL_DATA_BAG)
+    || (t->kind == NOLL_DATA_EMPTYBAG);
+  if ((prio == 1 && simple) || (prio == 2 && !simple))
+    noll_data_th_define (th, x, t);
+}
+
+/**
+ * Add the element @p e in the component @p c.
+ */
+static void
+noll_data_th_in (noll_data_th_t * th, noll_data_elt_t * e,
+                 noll_data_elt_t * c)
+{
+  if (c->t != NULL)
+    noll_data_th_cmp (th, e->t, c->t, 0, true);
+  else
+    noll_data_pair_array_push (th->in, noll_data_th_pair (th, e, c, false));
+}
+
+/**
+ * Add the literal of atom @p a and sign @p neg to the theory.
+ */
+static void
+noll_data_th_add (noll_data_th_t * th, noll_data_atom_t * a, bool neg)
+{
+  if (!a->bag)
+    {
+      switch (a->kind)
+        {
+        case NOLL_DATA_EQ:
+          if (!neg)
+            noll_data_th_cmp (th, a->t1, a->t2, 0, true);
+          else
+            {
+              noll_data_case_t *c = (noll_data_case_t *)
+                noll_data_th_alloc (th, sizeof (noll_data_case_t));
+              c->e = noll_data_th_elt (th, NULL, a->t1);
+              c->f = noll_data_th_elt (th, NULL, a->t2);
+              c->nf = NULL;
+              noll_data_case_array_push (th->cases, c);
+            }
+          break;
+        case NOLL_DATA_LT:
+          if (!neg)
+            noll_data_th_cmp (th, a->t1, a->t2, 1, false);
+          else
+            noll_data_th_cmp (th, a->t2, a->t1, 0, false);
+          break;
+        case NOLL_DATA_LE:
+          if (!neg)
+            noll_data_th_cmp (th, a->t1, a->t2, 0, false);
+          else
+            noll_data_th_cmp (th, a->t2, a->t1, 1, false);
+          break;
+        default:
+          break;
+        }
+      return;
+    }
+
+  switch (a->kind)
+    {
+    case NOLL_DATA_LT:
+    case NOLL_DATA_LE:
+      {
+        if (neg)
+          break;
+        bool strict = (a->kind == NOLL_DATA_LT);
+        noll_data_elt_array *nf1 = noll_data_th_nf_new (th, a->t1);
+        noll_data_elt_array *nf2 = noll_data_th_nf_new (th, a->t2);
+        for (uint_t i = 0; i < noll_vector_size (nf1); i++)
+          for (uint_t j = 0; j < noll_vector_size (nf2); j++)
+            {
+              noll_data_elt_t *e1 = noll_vector_at (nf1, i);
+              noll_data_elt_t *e2 = noll_vector_at (nf2, j);
+              if ((e1->t != NULL) && (e2->t != NULL))
+                noll_data_th_cmp (th, e1->t, e2->t, (strict) ? 1 : 0, false);
+              else
+                noll_data_pair_array_push (th->ord,
+                                           noll_data_th_pair (th, e1, e2,
+                                                              strict));
+            }
+        noll_data_elt_array_delete (nf1);
+        noll_data_elt_array_delete (nf2);
+        break;
+      }
+    case NOLL_DATA_SUBSET:
+      {
+        noll_dterm_t *s = noll_data_deref (th->ctx, a->t1);
+        if ((s->kind != NOLL_DATA_BAG) || (s->args == NULL)
+            || (noll_vector_size (s->args) != 1))
+          break;
+        noll_dterm_t *et = noll_vector_at (s->args, 0);
+        noll_data_elt_t *e = noll_data_th_elt (th, noll_data_th_key (th, et),
+                                               et);
+        noll_data_elt_array *nf = noll_data_th_nf_new (th, a->t2);
+        uint_t n = noll_vector_size (nf);
+        if (!neg)
+          {
+            if (n == 0)
+              th->unsat = true;
+            else if (n == 1)
+              noll_data_th_in (th, e, noll_vector_at (nf, 0));
+            else
+              {
+                noll_data_case_t *c = (noll_data_case_t *)
+                  noll_data_th_alloc (th, sizeof (noll_data_case_t));
+                c->e = e;
+                c->f = NULL;
+                c->nf = nf;
+                noll_data_case_array_push (th->cases, c);
+                return;
+              }
+          }
+        else
+          for (uint_t i = 0; i < n; i++)
+            {
+              noll_data_elt_t *ci = noll_vector_at (nf, i);
+              if (ci->t != NULL)
+                {
+                  noll_data_case_t *c = (noll_data_case_t *)
+                    noll_data_th_alloc (th, sizeof (noll_data_case_t));
+                  c->e = e;
+                  c->f = ci;
+                  c->nf = NULL;
+                  noll_data_case_array_push (th->cases, c);
+                }
+              else
+                noll_data_pair_array_push (th->notin,
+                                           noll_data_th_pair (th, e, ci,
+                                                              false));
+            }
+        noll_data_elt_array_delete (nf);
+        break;
+      }
+    default:
+      break;
+    }
+}
+
+/**
+ * Build the theory of the literals assigned in the context.
+ */
+static void
+noll_data_th_build (noll_data_th_t * th)
+{
+  noll_data_ctx_t *ctx = th->ctx;
+  uint_t na = noll_vector_size (ctx->atoms);
+  /* definitions of bags first */
+  for (int prio = 0; prio < 3; prio++)
+    for (uint_t i = 0; i < na; i++)
+      {
+        noll_data_atom_t *a = noll_vector_at (ctx->atoms, i);
+        if ((ctx->val[i] == 1) && a->bag && (a->kind == NOLL_DATA_EQ))
+          noll_data_th_bag_eq (th, a, prio);
+      }
+  /* integers, then orders on bags, then memberships which use both */
+  for (int pass = 0; pass < 3; pass++)
+    for (uint_t i = 0; i < na; i++)
+      {
+        noll_data_atom_t *a = noll_vector_at (ctx->atoms, i);
+        int p = (!a->bag) ? 0 : (a->kind == NOLL_DATA_SUBSET) ? 2 : 1;
+        if ((ctx->val[i] >= 0) && (p == pass))
+          noll_data_th_add (th, a, ctx->val[i] == 0);
+      }
+}
+
+/**
+ * Add the integer constraints entailed by the memberships.
+ * @return false if a membership contradicts a non-membership
+ */
+static bool
+noll_data_th_derive (noll_data_th_t * th)
+{
+  for (uint_t i = 0; i < noll_vector_size (th->in); i++)
+    {
+      noll_data_pair_t *in = noll_vector_at (th->in, i);
+      for (uint_t j = 0; j < noll_vector_size (th->notin); j++)
+        {
+          noll_data_pair_t *out = noll_vector_at (th->notin, j);
+          if ((strcmp (in->b->key, out->b->key) == 0)
+              && (strcmp (in->a->key, out->a->key) == 0))
+            return false;
+        }
+      for (uint_t j = 0; j < noll_vector_size (th->ord); j++)
+        {
+          noll_data_pair_t *o = noll_vector_at (th->ord, j);
+          long k = (o->strict) ? 1 : 0;
+          if ((strcmp (o->a->key, in->b->key) == 0) && (o->b->t != NULL))
+            noll_data_th_cmp (th, in->a->t, o->b->t, k, false);
+          else if ((strcmp (o->b->key, in->b->key) == 0) && (o->a->t != NULL))
+            noll_data_th_cmp (th, o->a->t, in->a->t, k, false);
+          else if (strcmp (o->a->key, in->b->key) == 0)
+            {
+              for (uint_t l = 0; l < noll_vector_size (th->in); l++)
+                {
+                  noll_data_pair_t *in2 = noll_vector_at (th->in, l);
+                  if (strcmp (o->b->key, in2->b->key) == 0)
+                    noll_data_th_cmp (th, in->a->t, in2->a->t, k, false);
+                }
+            }
+        }
+    }
+  return true;
+}
+
+/* ====================================================================== */
+/* Goals */
+/* ====================================================================== */
+
+/**
+ * Match the components c - {k} and k not marked in @p nf1 with
+ * the component c not marked in @p nf2.
+ */
+static void
+noll_data_th_nf_split (noll_data_th_t * th, noll_data_elt_array * nf1,
+                       bool *mark1, noll_data_elt_array * nf2, bool *mark2)
+{
+  uint_t n1 = noll_vector_size (nf1);
+  uint_t n2 = noll_vector_size (nf2);
+  for (uint_t i = 0; i < n1; i++)
+    {
+      noll_data_elt_t *e = noll_vector_at (nf1, i);
+      if (mark1[i] || (e->whole == NULL))
+        continue;
+      uint_t j = 0;
+      while ((j < n2) && (mark2[j] || strcmp (noll_vector_at (nf2, j)->key,
+                                              e->whole->key) != 0))
+        j++;
+      uint_t l = 0;
+      while ((l < n1) && ((l == i) || mark1[l]
+                          || (noll_vector_at (nf1, l)->t == NULL)
+                          || !noll_data_th_same (th, noll_vector_at (nf1, l),
+                                                 e->out)))
+        l++;
+      if ((j < n2) && (l < n1))
+        mark1[i] = mark1[l] = mark2[j] = true;
+    }
+}
+
+/**
+ * @return true if the multiset @p nf1 is included in @p nf2
+ *         (equal to it if @p eq)
+ */
+static bool
+noll_data_th_nf_incl (noll_data_th_t * th, noll_data_elt_array * nf1,
+                      noll_data_elt_array * nf2, bool eq)
+{
+  uint_t n1 = noll_vector_size (nf1);
+  uint_t n2 = noll_vector_size (nf2);
+  bool *used = (bool *) calloc (n2 + 1, sizeof (bool));
+  bool *done = (bool *) calloc (n1 + 1, sizeof (bool));
+  bool res = true;
+  /* same texts first, then components split by a difference,
+   * then equal singletons */
+  for (uint_t i = 0; i < n1; i++)
+    for (uint_t j = 0; j < n2; j++)
+      if (!used[j] && (strcmp (noll_vector_at (nf1, i)->key,
+                               noll_vector_at (nf2, j)->key) == 0))
+        {
+          used[j] = done[i] = true;
+          break;
+        }
+  noll_data_th_nf_split (th, nf1, done, nf2, used);
+  noll_data_th_nf_split (th, nf2, used, nf1, done);
+  for (uint_t i = 0; (i < n1) && res; i++)
+    {
+      if (done[i])
+        continue;
+      res = false;
+      noll_data_elt_t *e1 = noll_vector_at (nf1, i);
+      if (e1->t == NULL)
+        break;
+      for (uint_t j = 0; j < n2; j++)
+        if (!used[j] && (noll_vector_at (nf2, j)->t != NULL)
+            && noll_data_th_same (th, e1, noll_vector_at (nf2, j)))
+          {
+            used[j] = true;
+            res = true;
+            break;
+          }
+    }
+  for (uint_t j = 0; (j < n2) && res && eq; j++)
+    res = used[j];
+  free (used);
+  free (done);
+  return res;
+}
+
+/**
+ * @return true if the component @p a is less than (or equal if not
+ *         @p strict) the component @p b.
+ */
+static bool
+noll_data_th_ord (noll_data_th_t * th, noll_data_elt_t * a,
+                  noll_data_elt_t * b, bool strict)
+{
+  long k = (strict) ? 1 : 0;
+  if ((a->t != NULL) && (b->t != NULL))
+    return noll_data_th_entails (th, a->t, b->t, k);
+  if ((a->sup != NULL) || (b->sup != NULL))
+    {
+      /* the order holds for the bags including the components */
+      bool res = true;
+      noll_data_elt_array *nf = noll_data_th_nf_new (th,
+                                                     (a->sup != NULL) ?
+                                                     a->sup : b->sup);
+      for (uint_t i = 0; (i < noll_vector_size (nf)) && res; i++)
+        res = (a->sup != NULL)
+          ? noll_data_th_ord (th, noll_vector_at (nf, i), b, strict)
+          : noll_data_th_ord (th, a, noll_vector_at (nf, i), strict);
+      noll_data_elt_array_delete (nf);
+      if (res)
+        return true;
+    }
+  for (uint_t i = 0; i < noll_vector_size (th->ord); i++)
+    {
+      noll_data_pair_t *o = noll_vector_at (th->ord, i);
+      bool sa = (strcmp (o->a->key, a->key) == 0);
+      bool sb = (strcmp (o->b->key, b->key) == 0);
+      if (sa && sb && (o->strict || !strict))
+        return true;
+      /* a < s <= t (or a <= s < t) */
+      if (sa && (o->b->t != NULL) && (b->t != NULL)
+          && noll_data_th_entails (th, o->b->t, b->t,
+                                   (strict && !o->strict) ? 1 : 0))
+        return true;
+      /* s <= t < b */
+      if (sb && (o->a->t != NULL) && (a->t != NULL)
+          && noll_data_th_entails (th, a->t, o->a->t,
+                                   (strict && !o->strict) ? 1 : 0))
+        return true;
+      /* a < s <= t < b */
+      if (sa && (o->b->t != NULL) && (a->t == NULL) && (b->t == NULL))
+        for (uint_t j = 0; j < noll_vector_size (th->ord); j++)
+          {
+            noll_data_pair_t *o2 = noll_vector_at (th->ord, j);
+            if ((strcmp (o2->b->key, b->key) == 0) && (o2->a->t != NULL)
+                && noll_data_th_entails (th, o->b->t, o2->a->t,
+                                         (strict && !o->strict
+                                          && !o2->strict) ? 1 : 0))
+              return true;
+          }
+    }
+  return false;
+}
+
+/**
+ * @return true if the element @p e is (not if @p neg) in @p nf
+ */
+static bool
+noll_data_th_member (noll_data_th_t * th, noll_data_elt_t * e,
+                     noll_data_elt_array * nf, bool neg)
+{
+  for (uint_t i = 0; i < noll_vector_size (nf); i++)
+    {
+      noll_data_elt_t *c = noll_vector_at (nf, i);
+      bool res = false;
+      if (c->t != NULL)
+        res = (neg) ? noll_data_th_entails_neq (th, e->t, c->t)
+          : noll_data_th_same (th, e,
+                               noll_data_th_elt (th,
+                                                 noll_data_th_key (th, c->t),
+                                                 c->t));
+      else if (!neg)
+        {
+          for (uint_t j = 0; (j < noll_vector_size (th->in)) && !res; j++)
+            {
+              noll_data_pair_t *in = noll_vector_at (th->in, j);
+              res = (strcmp (in->b->key, c->key) == 0)
+                && noll_data_th_same (th, in->a, e);
+            }
+        }
+      else
+        {
+          for (uint_t j = 0; (j < noll_vector_size (th->notin)) && !res; j++)
+            {
+              noll_data_pair_t *out = noll_vector_at (th->notin, j);
+              res = (strcmp (out->b->key, c->key) == 0)
+                && (strcmp (out->a->key, e->key) == 0);
+            }
+          /* c < s <= e or e <= s < c */
+          for (uint_t j = 0; (j < noll_vector_size (th->ord)) && !res; j++)
+            {
+              noll_data_pair_t *o = noll_vector_at (th->ord, j);
+              long k = (o->strict) ? 0 : 1;
+              if ((strcmp (o->a->key, c->key) == 0) && (o->b->t != NULL))
+                res = noll_data_th_entails (th, o->b->t, e->t, k);
+              else if ((strcmp (o->b->key, c->key) == 0)
+                       && (o->a->t != NULL))
+                res = noll_data_th_entails (th, e->t, o->a->t, k);
+            }
+        }
+      if (neg && !res && (c->sup != NULL))
+        {
+          noll_data_elt_array *nf2 = noll_data_th_nf_new (th, c->sup);
+          res = noll_data_th_member (th, e, nf2, true);
+          noll_data_elt_array_delete (nf2);
+        }
+      if (neg && !res)
+        return false;
+      if (!neg && res)
+        return true;
+    }
+  return neg;
+}
+
+/**
+ * @return true if the theory entails the literal of atom @p a
+ *         and sign @p neg
+ */
+static bool
+noll_data_th_goal (noll_data_th_t * th, noll_data_atom_t * a, bool neg)
+{
+  if (!a->bag)
+    switch (a->kind)
+      {
+      case NOLL_DATA_EQ:
+        return (neg) ? noll_data_th_entails_neq (th, a->t1, a->t2)
+          : noll_data_th_entails_eq (th, a->t1, a->t2);
+      case NOLL_DATA_LT:
+        return (neg) ? noll_data_th_entails (th, a->t2, a->t1, 0)
+          : noll_data_th_entails (th, a->t1, a->t2, 1);
+      case NOLL_DATA_LE:
+        return (neg) ? noll_data_th_entails (th, a->t2, a->t1, 1)
+          : noll_data_th_entails (th, a->t1, a->t2, 0);
+      default:
+        return false;
+      }
+
+  bool res = false;
+  noll_dterm_t *s = noll_data_deref (th->ctx, a->t1);
+  bool single = (a->kind == NOLL_DATA_SUBSET) && (s->kind == NOLL_DATA_BAG)
+    && (s->args != NULL) && (noll_vector_size (s->args) == 1);
+  if (neg && !single)
+    return false;
+  noll_data_elt_array *nf2 = noll_data_th_nf_new (th, a->t2);
+  if (single)
+    {
+      noll_dterm_t *et = noll_vector_at (s->args, 0);
+      res = noll_data_th_member (th,
+                                 noll_data_th_elt (th,
+                                                   noll_data_th_key (th, et),
+                                                   et), nf2, neg);
+      noll_data_elt_array_delete (nf2);
+      return res;
+    }
+  noll_data_elt_array *nf1 = noll_data_th_nf_new (th, a->t1);
+  switch (a->kind)
+    {
+    case NOLL_DATA_EQ:
+    case NOLL_DATA_SUBSET:
+      res = noll_data_th_nf_incl (th, nf1, nf2, a->kind == NOLL_DATA_EQ);
+      break;
+    case NOLL_DATA_LT:
+    case NOLL_DATA_LE:
+      res = true;
+      for (uint_t i = 0; (i < noll_vector_size (nf1)) && res; i++)
+        for (uint_t j = 0; (j < noll_vector_size (nf2)) && res; j++)
+          res = noll_data_th_ord (th, noll_vector_at (nf1, i),
+                                  noll_vector_at (nf2, j),
+                                  a->kind == NOLL_DATA_LT);
+      break;
+    default:
+      break;
+    }
+  noll_data_elt_array_delete (nf1);
+  noll_data_elt_array_delete (nf2);
+  return res;
+}
+
+/**
+ * Check that each case of the disjunctions of the theory
+ * is contradictory or entails the literal @p goal.
+ */
+static bool
+noll_data_th_check (noll_data_th_t * th, uint_t goal)
+{
+  if (th->unsat)
+    return true;
+  noll_data_atom_t *a = noll_vector_at (th->ctx->atoms, NOLL_DATA_ATOM (goal));
+  bool neg = NOLL_DATA_NEG (goal);
+
+  /* number of cases */
+  uint_t nc = noll_vector_size (th->cases);
+  uint_t total = 1;
+  for (uint_t i = 0; (i < nc) && (total <= NOLL_DATA_MAX_CASES); i++)
+    {
+      noll_data_case_t *c = noll_vector_at (th->cases, i);
+      total *= (c->nf == NULL) ? 2 : noll_vector_size (c->nf);
+    }
+  if (total > NOLL_DATA_MAX_CASES)
+    nc = 0;                     /* the disjunctions are ignored */
+
+  uint_t *idx = (uint_t *) calloc (nc + 1, sizeof (uint_t));
+  uint_t rmark = noll_vector_size (th->rows);
+  uint_t imark = noll_vector_size (th->in);
+  bool res = true;
+  for (;;)
+    {
+      for (uint_t i = 0; i < nc; i++)
+        {
+          noll_data_case_t *c = noll_vector_at (th->cases, i);
+          if (c->nf != NULL)
+            noll_data_th_in (th, c->e, noll_vector_at (c->nf, idx[i]));
+          else if (idx[i] == 0)
+            noll_data_th_cmp (th, c->e->t, c->f->t, 1, false);
+          else
+            noll_data_th_cmp (th, c->f->t, c->e->t, 1, false);
+        }
+      bool unsat = !noll_data_th_derive (th) || noll_data_th_unsat (th);
+      if (!unsat && !noll_data_th_goal (th, a, neg))
+        res = false;
+      noll_data_long_array_resize (th->rows, rmark);
+      noll_data_pair_array_resize (th->in, imark);
+      if (!res)
+        break;
+      /* next case */
+      uint_t i = 0;
+      for (; i < nc; i++)
+        {
+          noll_data_case_t *c = noll_vector_at (th->cases, i);
+          uint_t n = (c->nf == NULL) ? 2 : noll_vector_size (c->nf);
+          if (++idx[i] < n)
+            break;
+          idx[i] = 0;
+        }
+      if (i == nc)
+        break;
+    }
+  free (idx);
+  return res;
+}
+
+/* ====================================================================== */
+/* Search */
+/* ====================================================================== */
+
+/**
+ * @return the atom of a condition to split in order to prove @p goal,
+ *         or UNDEFINED_ID
+ */
+static uint_t
+noll_data_pick (noll_data_ctx_t * ctx, uint_t goal)
+{
+  noll_data_atom_t *g = noll_vector_at (ctx->atoms, NOLL_DATA_ATOM (goal));
+  uint_t a = noll_data_find_ite (ctx, g->t1);
+  if (a == UNDEFINED_ID)
+    a = noll_data_find_ite (ctx, g->t2);
+  for (uint_t i = 0; (i < noll_vector_size (ctx->clauses))
+       && (a == UNDEFINED_ID); i += 2)
+    {
+      uint_t l1 = noll_vector_at (ctx->clauses, i);
+      uint_t l2 = noll_vector_at (ctx->clauses, i + 1);
+      if ((noll_data_lit_val (ctx, l1) < 0)
+          && (noll_data_lit_val (ctx, l2) < 0))
+        a = NOLL_DATA_ATOM (l1);
+    }
+  for (uint_t i = 0; (i < noll_vector_size (ctx->atoms))
+       && (a == UNDEFINED_ID); i++)
+    if (ctx->val[i] >= 0)
+      {
+        noll_data_atom_t *f = noll_vector_at (ctx->atoms, i);
+        a = noll_data_find_ite (ctx, f->t1);
+        if (a == UNDEFINED_ID)
+          a = noll_data_find_ite (ctx, f->t2);
+      }
+  return a;
+}
+
+/**
+ * Prove the literal @p goal from the current assignment,
+ * by splitting the conditions up to NOLL_DATA_MAX_SPLITS.
+ */
+static bool
+noll_data_prove (noll_data_ctx_t * ctx, uint_t goal, uint_t depth)
+{
+  uint_t mark = noll_vector_size (ctx->trail);
+  bool res;
+  if (!noll_data_propagate (ctx) || (noll_data_lit_val (ctx, goal) == 1))
+    res = true;
+  else
+    {
+      noll_data_th_t th;
+      noll_data_th_init (&th, ctx);
+      noll_data_th_build (&th);
+      res = noll_data_th_check (&th, goal);
+      noll_data_th_free (&th);
+      if (!res && (depth < NOLL_DATA_MAX_SPLITS))
+        {
+          uint_t a = noll_data_pick (ctx, goal);
+          if (a != UNDEFINED_ID)
+            {
+              uint_t m2 = noll_vector_size (ctx->trail);
+              noll_data_assign (ctx, NOLL_DATA_LIT (a, false));
+              res = noll_data_prove (ctx, goal, depth + 1);
+              noll_data_undo (ctx, m2);
+              if (res)
+                {
+                  noll_data_assign (ctx, NOLL_DATA_LIT (a, true));
+                  res = noll_data_prove (ctx, goal, depth + 1);
+                  noll_data_undo (ctx, m2);
+                }
+            }
+        }
+    }
+  noll_data_undo (ctx, mark);
+  return res;
+}
+
+/**
+ * Eliminate the existentials of @p df2 defined by an equality,
+ * such equalities are marked in @p used.
+ */
+static void
+noll_data_elim (noll_data_ctx_t * ctx, noll_dform_array * df2, bool *used)
+{
+  for (uint_t i = 0; i < noll_vector_size (df2); i++)
+    {
+      noll_dform_t *f = noll_vector_at (df2, i);
+      if ((f->kind != NOLL_DATA_EQ) || (f->p.targs == NULL)
+          || (noll_vector_size (f->p.targs) != 2))
+        continue;
+      for (uint_t s = 0; s < 2; s++)
+        {
+          noll_dterm_t *x =
+            noll_data_deref (ctx, noll_vector_at (f->p.targs, s));
+          noll_dterm_t *t = noll_vector_at (f->p.targs, 1 - s);
+          if ((x->kind == NOLL_DATA_VAR) && (x->p.sid < ctx->nvars)
+              && ctx->ex[x->p.sid]
+              && !noll_data_occurs (ctx, t, x->p.sid))
+            {
+              ctx->def[x->p.sid] = t;
+              used[i] = true;
+              break;
+            }
+        }
+    }
+}
+
+/**
+ * Check the entailment in the context, @return 1 if proved, -1 otherwise.
+ */
+static int
+noll_data_solve (noll_data_ctx_t * ctx, noll_dform_array * df1,
+                 noll_dform_array * df2)
+{
+  uint_t n2 = noll_vector_size (df2);
+  bool *used = (bool *) calloc (n2 + 1, sizeof (bool));
+  noll_data_elim (ctx, df2, used);
+
+  /* atoms of the lhs and of the rhs */
+  ctx->reg = true;
+  for (uint_t i = 0; i < noll_vector_size (df1); i++)
+    {
+      noll_dform_t *f = noll_vector_at (df1, i);
+      if ((f->kind == NOLL_DATA_IMPLIES) && (f->p.bargs != NULL)
+          && (noll_vector_size (f->p.bargs) == 2))
+        {
+          uint_t l1 = noll_data_lit_of (ctx, noll_vector_at (f->p.bargs, 0));
+          uint_t l2 = noll_data_lit_of (ctx, noll_vector_at (f->p.bargs, 1));
+          if ((l1 != UNDEFINED_ID) && (l2 != UNDEFINED_ID))
+            {
+              noll_uint_array_push (ctx->clauses, l1 ^ 1);
+              noll_uint_array_push (ctx->clauses, l2);
+            }
+          continue;
+        }
+      uint_t l = noll_data_lit_of (ctx, f);
+      if (l != UNDEFINED_ID)
+        noll_uint_array_push (ctx->facts, l);
+    }
+  int res = 1;
+  noll_uint_array *goals = noll_uint_array_new ();      /// pairs hyp, goal
+  for (uint_t i = 0; (i < n2) && (res == 1); i++)
+    {
+      noll_dform_t *f = noll_vector_at (df2, i);
+      if (used[i])
+        continue;
+      uint_t hyp = UNDEFINED_ID;
+      if ((f->kind == NOLL_DATA_IMPLIES) && (f->p.bargs != NULL)
+          && (noll_vector_size (f->p.bargs) == 2))
+        {
+          hyp = noll_data_lit_of (ctx, noll_vector_at (f->p.bargs, 0));
+          f = noll_vector_at (f->p.bargs, 1);
+        }
+      uint_t l = noll_data_lit_of (ctx, f);
+      if (l == UNDEFINED_ID)
+        res = -1;
+      noll_uint_array_push (goals, hyp);
+      noll_uint_array_push (goals, l);
+    }
+  ctx->reg = false;
+  free (used);
+
+  uint_t na = noll_vector_size (ctx->atoms);
+  ctx->val = (int *) malloc ((na + 1) * sizeof (int));
+  for (uint_t i = 0; i < na; i++)
+    ctx->val[i] = -1;
+  for (uint_t i = 0; i < noll_vector_size (ctx->facts); i++)
+    {
+      uint_t l = noll_vector_at (ctx->facts, i);
+      if (noll_data_lit_val (ctx, l) == 0)
+        {
+          /* contradictory lhs */
+          noll_uint_array_delete (goals);
+          return 1;
+        }
+      if (noll_data_lit_val (ctx, l) < 0)
+        noll_data_assign (ctx, l);
+    }
+
+  for (uint_t i = 0; (i < noll_vector_size (goals)) && (res == 1); i += 2)
+    {
+      uint_t hyp = noll_vector_at (goals, i);
+      uint_t goal = noll_vector_at (goals, i + 1);
+      uint_t mark = noll_vector_size (ctx->trail);
+      bool proved;
+      if ((hyp != UNDEFINED_ID) && (noll_data_lit_val (ctx, hyp) == 0))
+        proved = true;
+      else
+        {
+          if ((hyp != UNDEFINED_ID) && (noll_data_lit_val (ctx, hyp) < 0))
+            noll_data_assign (ctx, hyp);
+          proved = noll_data_prove (ctx, goal, 0);
+        }
+      noll_data_undo (ctx, mark);
+      if (!proved)
+        {
+          res = -1;
+#ifndef NDEBUG
+          if (noll_option_is_diag ())
+            fprintf (stdout, "\ndata_check_entl: not proved %s%s\n",
+                     NOLL_DATA_NEG (goal) ? "!" : "",
+                     noll_vector_at (ctx->atoms, NOLL_DATA_ATOM (goal))->key);
+#endif
+        }
+    }
+  noll_uint_array_delete (goals);
+  return res;
+}
+
+/* ====================================================================== */
+/* Cache */
+/* ====================================================================== */
+
+static uint_t
+noll_data_hash (const char *s)
+{
+  uint_t h = 2166136261u;
+  for (; *s != '\0'; s++)
+    h = (h ^ (unsigned char) *s) * 16777619u;
+  return h;
+}
+
+static noll_data_entry_t *
+noll_data_cache_find (const char *key, uint_t hash)
+{
+  if (data_cache == NULL)
+    return NULL;
+  for (noll_data_entry_t * e = data_cache[hash & (data_cache_buckets - 1)];
+       e != NULL; e = e->next)
+    if ((e->hash == hash) && (strcmp (e->key, key) == 0))
+      return e;
+  return NULL;
+}
+
+static void
+noll_data_cache_add (char *key, uint_t hash, int res)
+{
+  if (data_cache_size >= data_cache_buckets)
+    {
+      /* grow the table */
+      uint_t nb = (data_cache_buckets == 0) ? 64 : 2 * data_cache_buckets;
+      noll_data_entry_t **nt =
+        (noll_data_entry_t **) calloc (nb, sizeof (noll_data_entry_t *));
+      for (uint_t i = 0; i < data_cache_buckets; i++)
+        while (data_cache[i] != NULL)
+          {
+            noll_data_entry_t *e = data_cache[i];
+            data_cache[i] = e->next;
+            e->next = nt[e->hash & (nb - 1)];
+            nt[e->hash & (nb - 1)] = e;
+          }
+      free (data_cache);
+      data_cache = nt;
+      data_cache_buckets = nb;
+    }
+  noll_data_entry_t *e =
+    (noll_data_entry_t *) malloc (sizeof (noll_data_entry_t));
+  e->key = key;
+  e->hash = hash;
+  e->res = res;
+  e->next = data_cache[hash & (data_cache_buckets - 1)];
+  data_cache[hash & (data_cache_buckets - 1)] = e;
+  data_cache_size++;
+}
+
+void
+noll_data_free (void)
+{
+  for (uint_t i = 0; i < data_cache_buckets; i++)
+    while (data_cache[i] != NULL)
+      {
+        noll_data_entry_t *e = data_cache[i];
+        data_cache[i] = e->next;
+        free (e->key);
+        free (e);
+      }
+  free (data_cache);
+  data_cache = NULL;
+  data_cache_buckets = 0;
+  data_cache_size = 0;
+}
+
+/* ====================================================================== */
+/* Entailment */
+/* ====================================================================== */
+
+int
+noll_data_check_entl (noll_var_array * lv1, noll_dform_array * df1,
+                      noll_var_array * lv2, noll_dform_array * df2,
+                      const bool *lhs)
+{
+  if ((df2 == NULL) || (noll_vector_size (df2) == 0))
+    return 1;
+
+  uint_t nv = (lv1 == NULL) ? 0 : noll_vector_size (lv1);
+  uint_t nvars = (lv2 == NULL) ? 0 : noll_vector_size (lv2);
+  if (nvars < nv)
+    nvars = nv;
+  noll_data_ctx_t ctx;
+  noll_data_ctx_init (&ctx, nv, nvars);
+  /* the variables occurring only in the rhs are existentials */
+  if (lhs != NULL)
+    {
+      for (uint_t v = 0; v < nv; v++)
+        ctx.ex[v] = !lhs[v];
+      for (uint_t i = 0; (df1 != NULL) && (i < noll_vector_size (df1)); i++)
+        noll_data_mark_form (&ctx, noll_vector_at (df1, i));
+    }
+
+  /* text of the obligation, before any elimination */
+  char *key = NULL;
+  size_t size = 0;
+  FILE *f = open_memstream (&key, &size);
+  fprintf (f, "%u", nv);
+  for (uint_t v = 0; v < nv; v++)
+    if (ctx.ex[v])
+      fprintf (f, " ?%u", v);
+  for (uint_t i = 0; (df1 != NULL) && (i < noll_vector_size (df1)); i++)
+    {
+      fprintf (f, "\n");
+      noll_data_form_key (&ctx, noll_vector_at (df1, i), f);
+    }
+  fprintf (f, "\n|");
+  for (uint_t i = 0; i < noll_vector_size (df2); i++)
+    {
+      fprintf (f, "\n");
+      noll_data_form_key (&ctx, noll_vector_at (df2, i), f);
+    }
+  fclose (f);
+
+  uint_t hash = noll_data_hash (key);
+  noll_data_entry_t *e = noll_data_cache_find (key, hash);
+  if ((e != NULL) && !ctx.opaque)
+    {
+      free (key);
+      noll_data_ctx_free (&ctx);
+      return e->res;
+    }
+
+  noll_dform_array *empty = noll_dform_array_new ();
+  int res = noll_data_solve (&ctx, (df1 == NULL) ? empty : df1, df2);
+  noll_dform_array_delete (empty);
+  bool opaque = ctx.opaque;
+  noll_data_ctx_free (&ctx);
+  if (opaque)
+    free (key);
+  else
+    noll_data_cache_add (key, hash, res);
+  return res;
+}
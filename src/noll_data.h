@@ -0,0 +1,51 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Entailment of data constraints (integers and bags of integers).
+ */
+
+#ifndef NOLL_DATA_H_
+#define NOLL_DATA_H_
+
+#include "noll_form.h"
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+int noll_data_check_entl (noll_var_array * lv1, noll_dform_array * df1,
+                          noll_var_array * lv2, noll_dform_array * df2,
+                          const bool *lhs);
+/* Check that @p df1 entails exists lv2. @p df2, where the variables of
+ * @p df2 not in @p lv1 (their index is not less than its size) are the
+ * existentials of @p lv2.
+ * If @p lhs is not NULL, the variables v of @p lv1 with lhs[v] false
+ * and not occurring in @p df1 occur only in the rhs of the problem,
+ * they are existentials too.
+ * The check is sound but incomplete: the bags are multisets, the
+ * integers are solved by Fourier-Motzkin elimination, the conditions
+ * of ite terms and implications are split up to some depth.
+ * The results are cached by the text of the normalized constraints.
+ * @return 1 if the entailment is proved, -1 otherwise
+ */
+
+void noll_data_free (void);
+/* Free the cache of the results. */
+
+#endif /* NOLL_DATA_H_ */
@@ -21,6 +21,11 @@
  */
 
 #include <sys/time.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
 #include <stdio.h>
 
 #include "noll.h"
@@ -32,6 +37,8 @@
 #include "noll2graph.h"
 #include "noll_hom.h"
 #include "noll_pred2ta.h"
+#include "noll_scratch.h"
+#include "noll_entl_cache.h"
 
 /* ====================================================================== */
 /* Globals */
@@ -496,24 +503,27 @@ noll_share_check (noll_var_array * lvars, noll_var_array * svars,
                   noll_share_array * pos_share, noll_share_array * neg_share)
 {
   int isvalid = 0;
-  FILE *out = fopen ("sharing.smt", "w");
+  char *smt_fname = noll_scratch_path ("sharing", ".smt");
+  char *log_fname = noll_scratch_path ("smt", ".log");
+  FILE *out = fopen (smt_fname, "w");
   fprintf (out, "\n");
   fclose (out);
-  noll_share_check_euf_decl (lvars, svars, "sharing.smt");
-  noll_share_check_euf_asserts (lvars, svars, pos_share, "sharing.smt", 1);
-  noll_share_check_euf_asserts (lvars, svars, neg_share, "sharing.smt", 0);
-  out = fopen ("sharing.smt", "a");
+  noll_share_check_euf_decl (lvars, svars, smt_fname);
+  noll_share_check_euf_asserts (lvars, svars, pos_share, smt_fname, 1);
+  noll_share_check_euf_asserts (lvars, svars, neg_share, smt_fname, 0);
+  out = fopen (smt_fname, "a");
   fprintf (out, "(check-sat)\n");
   fclose (out);
 
-  char *command = (char *) malloc (100 * sizeof (char));
-  memset (command, 0, 100 * sizeof (char));
-  sprintf (command, "z3 -smt2 sharing.smt 1> smt.log");
+  char *command = (char *) malloc ((100 + strlen (smt_fname)
+                                    + strlen (log_fname)) * sizeof (char));
+  sprintf (command, "z3 -smt2 %s 1> %s", smt_fname, log_fname);
+  free (smt_fname);
 
   //call z3
   if (system (command) != -1)
     {
-      FILE *res = fopen ("smt.log", "r");
+      FILE *res = fopen (log_fname, "r");
       char s[10];
       s[9] = '\0';
       fgets (s, 10, res);
@@ -527,6 +537,7 @@ noll_share_check (noll_var_array * lvars, noll_var_array * svars,
         printf ("*******************SAT*******************\n");
     }
   free (command);
+  free (log_fname);
   return isvalid;
 }
 
@@ -573,6 +584,186 @@ noll_entl_type ()
   return 1;
 }
 
+/**
+ * Size of the buffer shared with the child normalizing @p form:
+ * a flag set at the end, the kind of the formula and the relation
+ * between each pair of variables.
+ */
+static size_t
+noll_entl_normalize_size (noll_form_t * form)
+{
+  uint_t n = (form->pure == NULL) ? 0 : form->pure->size;
+  return 2 + (size_t) n * n;
+}
+
+/**
+ * Normalize @p form in a child and write the result in @p buf.
+ */
+static void
+noll_entl_normalize_child (noll_form_t * form, char *fname,
+                           unsigned char *buf)
+{
+  noll_normalize (form, fname, true, true);
+  buf[1] = (unsigned char) form->kind;
+  if (form->kind != NOLL_FORM_UNSAT && form->pure != NULL)
+    {
+      uint_t n = form->pure->size;
+      for (uid_t i = 0; i < n; i++)
+        for (uid_t j = i + 1; j < n; j++)
+          buf[2 + i * n + j] =
+            (unsigned char) noll_pure_get (form->pure, i, j);
+    }
+  __atomic_store_n (&buf[0], 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy in @p form the normal form computed by a child in @p buf.
+ * Equalities are added first, such that the classes have the same
+ * representatives as in the child.
+ */
+static void
+noll_entl_normalize_apply (noll_form_t * form, unsigned char *buf)
+{
+  uint_t n = (form->pure == NULL) ? 0 : form->pure->size;
+  if ((noll_form_kind_t) buf[1] != NOLL_FORM_UNSAT)
+    {
+      for (uid_t i = 0; i < n; i++)
+        for (uid_t j = i + 1; j < n; j++)
+          if ((noll_pure_op_t) buf[2 + i * n + j] == NOLL_PURE_EQ)
+            noll_form_add_eq (form, i, j);
+      for (uid_t i = 0; i < n; i++)
+        for (uid_t j = i + 1; j < n; j++)
+          if ((noll_pure_op_t) buf[2 + i * n + j] == NOLL_PURE_NEQ)
+            noll_form_add_neq (form, i, j);
+    }
+  /* the kind is the one of the sequential normalization */
+  form->kind = (noll_form_kind_t) buf[1];
+}
+
+/**
+ * Normalize the positive formula and the negative formulae
+ * with @p jobs parallel processes.
+ * The children share with the parent only the inferred (in)equalities,
+ * thus the boolean abstractions are not kept.
+ * A formula is normalized here if its child failed.
+ */
+static void
+noll_entl_normalize_par (uint_t jobs)
+{
+  noll_form_t *pform = noll_entl_get_pform ();
+  noll_form_array *nform = noll_entl_get_nform ();
+  size_t nsize = (nform == NULL) ? 0 : noll_vector_size (nform);
+  size_t size = nsize + 1;      // position 0 is the positive formula
+  noll_form_t **forms = (noll_form_t **) malloc (size * sizeof (noll_form_t *));
+  unsigned char **bufs =
+    (unsigned char **) malloc (size * sizeof (unsigned char *));
+  pid_t *pids = (pid_t *) malloc (size * sizeof (pid_t));
+  size_t next = 0;              // next formula to be normalized
+  uint_t running = 0;
+
+  forms[0] = pform;
+  for (size_t i = 0; i < nsize; i++)
+    forms[i + 1] = noll_vector_at (nform, i);
+  for (size_t i = 0; i < size; i++)
+    {
+      bufs[i] = NULL;
+      pids[i] = 0;
+      /* nothing to infer for unsatisfiable or empty formulae */
+      if (forms[i] == NULL || forms[i]->kind == NOLL_FORM_UNSAT)
+        continue;
+      /* the pure part gets the size it has after the normalization */
+      uint_t nv = noll_vector_size (forms[i]->lvars);
+      if ((forms[i]->pure != NULL) && (forms[i]->pure->size != nv))
+        {
+          noll_pure_free (forms[i]->pure);
+          forms[i]->pure = NULL;
+        }
+      if (forms[i]->pure == NULL)
+        forms[i]->pure = noll_pure_new (nv);
+      void *b = mmap (NULL, noll_entl_normalize_size (forms[i]),
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                      -1, 0);
+      if (b != MAP_FAILED)
+        {
+          bufs[i] = (unsigned char *) b;
+          bufs[i][0] = 0;
+        }
+    }
+
+  /* the children shall not print again the buffered output */
+  fflush (stdout);
+  fflush (stderr);
+  while ((next < size) || (running > 0))
+    {
+      /* start a child for the next formulae */
+      while ((next < size) && (running < jobs))
+        {
+          if (bufs[next] == NULL)
+            {
+              next++;
+              continue;
+            }
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              noll_entl_normalize_child (forms[next],
+                                         (next == 0) ? "p-out.txt" :
+                                         "n-out.txt", bufs[next]);
+              fflush (stdout);
+              /* _exit skips the atexit cleanup of the scratch files */
+              noll_scratch_free ();
+              _exit (0);
+            }
+          if (pid < 0)
+            break;
+          pids[next++] = pid;
+          running++;
+        }
+      if (running == 0)
+        break;                  // fork failed, normalize the rest here
+
+      /* wait the end of a child */
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          break;
+        }
+      size_t i = 0;
+      while ((i < next) && (pids[i] != pid))
+        i++;
+      if (i == next)
+        continue;               // not a child of this normalization
+      pids[i] = 0;
+      running--;
+    }
+
+  /* stop the children not waited */
+  for (size_t i = 0; i < next; i++)
+    if (pids[i] > 0)
+      {
+        kill (pids[i], SIGKILL);
+        waitpid (pids[i], NULL, 0);
+      }
+
+  for (size_t i = 0; i < size; i++)
+    {
+      if (bufs[i] != NULL
+          && __atomic_load_n (&bufs[i][0], __ATOMIC_ACQUIRE) == 1)
+        noll_entl_normalize_apply (forms[i], bufs[i]);
+      else if (forms[i] != NULL)
+        noll_normalize (forms[i], (i == 0) ? "p-out.txt" : "n-out.txt",
+                        true, true);
+      if (bufs[i] != NULL)
+        munmap (bufs[i], noll_entl_normalize_size (forms[i]));
+    }
+  free (forms);
+  free (bufs);
+  free (pids);
+}
+
 /**
  * Normalize the formulae.
  * @return 1 if ok, 0 otherwise
@@ -583,8 +774,22 @@ noll_entl_normalize ()
 
   noll_form_t *pform = noll_entl_get_pform ();
   noll_form_array *nform = noll_entl_get_nform ();
+  uint_t jobs = noll_option_get_jobs ();
+  size_t nsize = (nform == NULL) ? 0 : noll_vector_size (nform);
 
-  if (pform)
+  /* the formulae are independent problems */
+  bool par = (jobs > 1) && (noll_option_is_tosat (0) == false)
+    && (nsize + ((pform != NULL) ? 1 : 0) > 1);
+  if (par)
+    {
+      if (noll_option_get_verb () > 0)
+        fprintf (stdout, "    o normalize formulae with %d processes\n",
+                 jobs);
+      noll_prob->pabstr = NULL;
+      noll_entl_normalize_par (jobs);
+    }
+
+  if (pform && !par)
     {
       if (noll_option_get_verb () > 0)
         fprintf (stdout, "    o normalize positive formula\n");
@@ -621,14 +826,18 @@ noll_entl_normalize ()
         {
           noll_form_t *nform_i = noll_vector_at (nform, i);
           noll_sat_t *nform_i_abstr = NULL;
-          if (noll_option_get_verb () > 0)
-            fprintf (stdout, "    o normalize negative formula %zu\n", i);
-
-          if (noll_option_is_tosat (0) == true)
-            normalize_incremental (nform_i, "n-out.txt");
-          else
-            nform_i_abstr = noll_normalize (nform_i, "n-out.txt", true,
-                                            false);
+          if (!par)
+            {
+              if (noll_option_get_verb () > 0)
+                fprintf (stdout, "    o normalize negative formula %zu\n",
+                         i);
+
+              if (noll_option_is_tosat (0) == true)
+                normalize_incremental (nform_i, "n-out.txt");
+              else
+                nform_i_abstr = noll_normalize (nform_i, "n-out.txt", true,
+                                                false);
+            }
           if (noll_option_is_diag () == true)
             {
               FILE *f_norm = fopen ("form-neg-norm.txt", "w");
@@ -880,6 +1089,23 @@ noll_entl_solve (void)
 
   noll_entl_type ();
 
+  /*
+   * Result of a previous run on the same problem
+   */
+  noll_entl_cache_key_t key;
+  bool cached = noll_entl_cache_key (&key);
+  if (cached)
+    {
+      res = noll_entl_cache_get (&key);
+      if (res != -1)
+        {
+          if (noll_option_get_verb () > 0)
+            fprintf (stdout, "  > result found in the cache\n");
+          cached = false;       // nothing to store
+          goto check_end;
+        }
+    }
+
 #ifndef NDEBUG
   if (noll_option_is_diag())
   {
@@ -960,6 +1186,9 @@ noll_entl_solve (void)
    */
 check_end:
 
+  if (cached)
+    noll_entl_cache_put (&key, res);
+
   gettimeofday (&tvEnd, NULL);
   time_difference (&tvDiff, &tvEnd, &tvBegin);
   printf ("\nTotal time (sec): %ld.%06ld\n\n", (long int) tvDiff.tv_sec,
@@ -0,0 +1,474 @@
+/**************************************************************************
+ *
+ *  SPEN decision procedure
+ *
+ *  you can redistribute it and/or modify it under the terms of the GNU
+ *  Lesser General Public License as published by the Free Software
+ *  Foundation, version 3.
+ *
+ *  It is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  See the GNU Lesser General Public License version 3.
+ *  for more details (enclosed in the file LICENSE).
+ *
+ **************************************************************************/
+
+/**
+ * Results of entailment problems kept on disk across runs.
+ *
+ * The index is a file of the cache directory mapped in memory: a header
+ * followed by a table of slots addressed by the hash of the problem,
+ * with linear probing. Writers lock the file, readers only check that
+ * the slot is marked used after its content has been written.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "noll_option.h"
+#include "noll_entl.h"
+#include "noll_preds.h"
+#include "noll_entl_cache.h"
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+#define NOLL_ENTL_CACHE_MAGIC 0x4e50534eu       // "SPEN"
+#define NOLL_ENTL_CACHE_VERSION 1u
+#define NOLL_ENTL_CACHE_SLOTS (1u << 16)        // a power of 2
+#define NOLL_ENTL_CACHE_PROBE 32u       // slots searched for a key
+#define NOLL_ENTL_CACHE_FILE "spen-entl.idx"
+
+typedef struct noll_entl_cache_slot_t
+{
+  uint64_t h[2];                // key
+  int32_t res;                  // result of noll_entl_solve
+  uint32_t used;                // set when h and res are written
+} noll_entl_cache_slot_t;
+
+typedef struct noll_entl_cache_index_t
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slots;
+  uint32_t unused;
+  noll_entl_cache_slot_t slot[];
+} noll_entl_cache_index_t;
+
+/* ====================================================================== */
+/* Globals */
+/* ====================================================================== */
+
+static int cache_fd = -1;
+static noll_entl_cache_index_t *cache_index = NULL;
+static size_t cache_length = 0;
+
+/* ====================================================================== */
+/* Canonical form of problems */
+/* ====================================================================== */
+
+static void
+noll_entl_cache_write_uids (FILE * f, noll_uid_array * a)
+{
+  if (a == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  fprintf (f, "[");
+  for (uint_t i = 0; i < noll_vector_size (a); i++)
+    fprintf (f, "%u,", noll_vector_at (a, i));
+  fprintf (f, "]");
+}
+
+static void
+noll_entl_cache_write_vars (FILE * f, noll_var_array * a)
+{
+  if (a == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  /* the names are ignored */
+  fprintf (f, "[");
+  for (uint_t i = 0; i < noll_vector_size (a); i++)
+    {
+      noll_var_t *v = noll_vector_at (a, i);
+      fprintf (f, "%d:", v->scope);
+      if (v->vty != NULL)
+        {
+          fprintf (f, "%d", v->vty->kind);
+          noll_entl_cache_write_uids (f, v->vty->args);
+        }
+      fprintf (f, ",");
+    }
+  fprintf (f, "]");
+}
+
+static void noll_entl_cache_write_dform (FILE * f, noll_dform_t * df);
+
+static void
+noll_entl_cache_write_dterm (FILE * f, noll_dterm_t * dt)
+{
+  if (dt == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  fprintf (f, "(%d:%d:", dt->kind, dt->typ);
+  switch (dt->kind)
+    {
+    case NOLL_DATA_INT:
+      fprintf (f, "%ld", dt->p.value);
+      break;
+    case NOLL_DATA_VAR:
+    case NOLL_DATA_FIELD:
+      fprintf (f, "%u", dt->p.sid);
+      break;
+    case NOLL_DATA_ITE:
+      noll_entl_cache_write_dform (f, dt->p.cond);
+      break;
+    default:
+      break;
+    }
+  if (dt->args != NULL)
+    for (uint_t i = 0; i < noll_vector_size (dt->args); i++)
+      noll_entl_cache_write_dterm (f, noll_vector_at (dt->args, i));
+  fprintf (f, ")");
+}
+
+static void
+noll_entl_cache_write_dform (FILE * f, noll_dform_t * df)
+{
+  if (df == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  fprintf (f, "(%d:%d:", df->kind, df->typ);
+  if (df->kind == NOLL_DATA_IMPLIES)
+    {
+      if (df->p.bargs != NULL)
+        for (uint_t i = 0; i < noll_vector_size (df->p.bargs); i++)
+          noll_entl_cache_write_dform (f, noll_vector_at (df->p.bargs, i));
+    }
+  else if (df->p.targs != NULL)
+    for (uint_t i = 0; i < noll_vector_size (df->p.targs); i++)
+      noll_entl_cache_write_dterm (f, noll_vector_at (df->p.targs, i));
+  fprintf (f, ")");
+}
+
+static void
+noll_entl_cache_write_pure (FILE * f, noll_pure_t * p)
+{
+  if (p == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  /* the relation between variables, not the union-find */
+  fprintf (f, "(%u:", p->size);
+  for (uid_t i = 0; i < p->size; i++)
+    for (uid_t j = i + 1; j < p->size; j++)
+      fprintf (f, "%d", noll_pure_get (p, i, j));
+  if (p->data != NULL)
+    for (uint_t i = 0; i < noll_vector_size (p->data); i++)
+      noll_entl_cache_write_dform (f, noll_vector_at (p->data, i));
+  fprintf (f, ")");
+}
+
+static void
+noll_entl_cache_write_space (FILE * f, noll_space_t * s)
+{
+  if (s == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  fprintf (f, "(%d:%d:", s->kind, s->is_precise);
+  switch (s->kind)
+    {
+    case NOLL_SPACE_PTO:
+      fprintf (f, "%u", s->m.pto.sid);
+      noll_entl_cache_write_uids (f, s->m.pto.fields);
+      noll_entl_cache_write_uids (f, s->m.pto.dest);
+      break;
+    case NOLL_SPACE_LS:
+      fprintf (f, "%u:%u:%d", s->m.ls.pid, s->m.ls.sid, s->m.ls.is_loop);
+      noll_entl_cache_write_uids (f, s->m.ls.args);
+      break;
+    case NOLL_SPACE_WSEP:
+    case NOLL_SPACE_SSEP:
+      if (s->m.sep != NULL)
+        for (uint_t i = 0; i < noll_vector_size (s->m.sep); i++)
+          noll_entl_cache_write_space (f, noll_vector_at (s->m.sep, i));
+      break;
+    default:
+      break;
+    }
+  fprintf (f, ")");
+}
+
+static void
+noll_entl_cache_write_sterm (FILE * f, noll_sterm_t * t)
+{
+  if (t == NULL)
+    fprintf (f, "_");
+  else
+    fprintf (f, "%d:%u:%u,", t->kind, t->lvar, t->svar);
+}
+
+static void
+noll_entl_cache_write_share (FILE * f, noll_share_array * a)
+{
+  if (a == NULL)
+    {
+      fprintf (f, "_");
+      return;
+    }
+  fprintf (f, "[");
+  for (uint_t i = 0; i < noll_vector_size (a); i++)
+    {
+      noll_atom_share_t *s = noll_vector_at (a, i);
+      fprintf (f, "(%d:", s->kind);
+      noll_entl_cache_write_sterm (f, s->t_left);
+      if (s->t_right != NULL)
+        for (uint_t j = 0; j < noll_vector_size (s->t_right); j++)
+          noll_entl_cache_write_sterm (f, noll_vector_at (s->t_right, j));
+      fprintf (f, ")");
+    }
+  fprintf (f, "]");
+}
+
+static void
+noll_entl_cache_write_form (FILE * f, noll_form_t * phi)
+{
+  if (phi == NULL)
+    {
+      fprintf (f, "_\n");
+      return;
+    }
+  fprintf (f, "%d", phi->kind);
+  noll_entl_cache_write_vars (f, phi->lvars);
+  noll_entl_cache_write_vars (f, phi->svars);
+  noll_entl_cache_write_pure (f, phi->pure);
+  noll_entl_cache_write_space (f, phi->space);
+  noll_entl_cache_write_share (f, phi->share);
+  fprintf (f, "\n");
+}
+
+/**
+ * Hash the @p len bytes of @p buf in @p key.
+ * Two functions (FNV-1a and a multiply-rotate) are combined to make
+ * collisions negligible for the size of the index.
+ */
+static void
+noll_entl_cache_hash (const char *buf, size_t len,
+                      noll_entl_cache_key_t * key)
+{
+  uint64_t h0 = 14695981039346656037ull;
+  uint64_t h1 = 0x9e3779b97f4a7c15ull;
+  for (size_t i = 0; i < len; i++)
+    {
+      uint64_t c = (unsigned char) buf[i];
+      h0 = (h0 ^ c) * 1099511628211ull;
+      h1 = ((h1 ^ c) * 0xff51afd7ed558ccdull);
+      h1 = (h1 << 31) | (h1 >> 33);
+    }
+  key->h[0] = h0;
+  key->h[1] = h1;
+}
+
+bool
+noll_entl_cache_key (noll_entl_cache_key_t * key)
+{
+  if (noll_option_get_cache () == NULL)
+    return false;
+
+  char *buf = NULL;
+  size_t len = 0;
+  FILE *f = open_memstream (&buf, &len);
+  if (f == NULL)
+    return false;
+
+  /* options changing the result */
+  fprintf (f, "%u:%d:%d%d%d%d%d\n", NOLL_ENTL_CACHE_VERSION,
+           noll_prob->cmd, noll_option_is_checkTA (),
+           noll_option_is_checkSY (), noll_option_is_checkLS (0),
+           noll_option_is_tosat (0), noll_option_is_preds_builtin ());
+  /* declarations, printed after typing */
+  noll_records_array_fprint (f, "records");
+  noll_fields_array_fprint (f, "fields");
+  noll_pred_array_fprint (f, preds_array, "preds");
+  fprintf (f, "\n");
+  /* formulas */
+  noll_entl_cache_write_form (f, noll_prob->pform);
+  if (noll_prob->nform != NULL)
+    for (uint_t i = 0; i < noll_vector_size (noll_prob->nform); i++)
+      noll_entl_cache_write_form (f, noll_vector_at (noll_prob->nform, i));
+  fclose (f);
+
+  noll_entl_cache_hash (buf, len, key);
+  free (buf);
+  return true;
+}
+
+/* ====================================================================== */
+/* Index */
+/* ====================================================================== */
+
+/**
+ * Map the index of the cache directory, create it if needed.
+ * @return true if the index is mapped
+ */
+static bool
+noll_entl_cache_open (void)
+{
+  if (cache_index != NULL)
+    return true;
+  if (cache_fd == -2)
+    return false;               // failed before, do not retry
+  const char *dir = noll_option_get_cache ();
+  if (dir == NULL)
+    return false;
+
+  char *path = (char *) malloc (strlen (dir) + sizeof (NOLL_ENTL_CACHE_FILE)
+                                + 2);
+  sprintf (path, "%s/%s", dir, NOLL_ENTL_CACHE_FILE);
+  mkdir (dir, 0777);
+  cache_fd = open (path, O_RDWR | O_CREAT, 0666);
+  free (path);
+  if (cache_fd < 0)
+    goto open_fail;
+
+  cache_length = sizeof (noll_entl_cache_index_t)
+    + NOLL_ENTL_CACHE_SLOTS * sizeof (noll_entl_cache_slot_t);
+
+  /* the first process initializes the header */
+  flock (cache_fd, LOCK_EX);
+  struct stat st;
+  if (fstat (cache_fd, &st) != 0)
+    {
+      flock (cache_fd, LOCK_UN);
+      goto open_fail;
+    }
+  bool fresh = ((size_t) st.st_size != cache_length);
+  if (fresh && (ftruncate (cache_fd, 0) != 0
+                || ftruncate (cache_fd, cache_length) != 0))
+    {
+      flock (cache_fd, LOCK_UN);
+      goto open_fail;
+    }
+  void *m = mmap (NULL, cache_length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                  cache_fd, 0);
+  if (m == MAP_FAILED)
+    {
+      flock (cache_fd, LOCK_UN);
+      goto open_fail;
+    }
+  cache_index = (noll_entl_cache_index_t *) m;
+  if (fresh || cache_index->magic != NOLL_ENTL_CACHE_MAGIC
+      || cache_index->version != NOLL_ENTL_CACHE_VERSION
+      || cache_index->slots != NOLL_ENTL_CACHE_SLOTS)
+    {
+      memset (cache_index, 0, cache_length);
+      cache_index->magic = NOLL_ENTL_CACHE_MAGIC;
+      cache_index->version = NOLL_ENTL_CACHE_VERSION;
+      cache_index->slots = NOLL_ENTL_CACHE_SLOTS;
+    }
+  flock (cache_fd, LOCK_UN);
+
+  static bool registered = false;
+  if (!registered)
+    {
+      atexit (noll_entl_cache_free);
+      registered = true;
+    }
+  return true;
+
+open_fail:
+  if (noll_option_get_verb () > 0)
+    fprintf (stdout, "    cache directory %s not usable, ignored\n", dir);
+  if (cache_fd >= 0)
+    close (cache_fd);
+  cache_fd = -2;
+  return false;
+}
+
+int
+noll_entl_cache_get (const noll_entl_cache_key_t * key)
+{
+  if (!noll_entl_cache_open ())
+    return -1;
+
+  uint32_t mask = NOLL_ENTL_CACHE_SLOTS - 1;
+  for (uint32_t i = 0; i < NOLL_ENTL_CACHE_PROBE; i++)
+    {
+      noll_entl_cache_slot_t *s =
+        &cache_index->slot[(key->h[0] + i) & mask];
+      if (__atomic_load_n (&s->used, __ATOMIC_ACQUIRE) == 0)
+        return -1;
+      if (s->h[0] == key->h[0] && s->h[1] == key->h[1])
+        {
+          int res = s->res;
+          /* the slot may have been rewritten while reading */
+          if (__atomic_load_n (&s->used, __ATOMIC_ACQUIRE) == 0
+              || s->h[1] != key->h[1])
+            return -1;
+          return res;
+        }
+    }
+  return -1;
+}
+
+void
+noll_entl_cache_put (const noll_entl_cache_key_t * key, int res)
+{
+  if ((res != 0 && res != 1) || !noll_entl_cache_open ())
+    return;
+
+  flock (cache_fd, LOCK_EX);
+  uint32_t mask = NOLL_ENTL_CACHE_SLOTS - 1;
+  noll_entl_cache_slot_t *s = NULL;
+  for (uint32_t i = 0; i < NOLL_ENTL_CACHE_PROBE && s == NULL; i++)
+    {
+      noll_entl_cache_slot_t *si =
+        &cache_index->slot[(key->h[0] + i) & mask];
+      if (si->used == 0
+          || (si->h[0] == key->h[0] && si->h[1] == key->h[1]))
+        s = si;
+    }
+  /* full window: replace a slot chosen by the second half of the key,
+   * such that the keys of a window do not all evict the same entry */
+  if (s == NULL)
+    s = &cache_index->slot[(key->h[0] + key->h[1] % NOLL_ENTL_CACHE_PROBE)
+                           & mask];
+
+  __atomic_store_n (&s->used, 0, __ATOMIC_RELEASE);
+  s->h[0] = key->h[0];
+  s->h[1] = key->h[1];
+  s->res = res;
+  __atomic_store_n (&s->used, 1, __ATOMIC_RELEASE);
+  flock (cache_fd, LOCK_UN);
+}
+
+void
+noll_entl_cache_free (void)
+{
+  if (cache_index != NULL)
+    munmap (cache_index, cache_length);
+  cache_index = NULL;
+  if (cache_fd >= 0)
+    close (cache_fd);
+  cache_fd = -1;
+}
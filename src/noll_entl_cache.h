@@ -0,0 +1,60 @@
+/**************************************************************************
+ *
+ *  SPEN decision procedure
+ *
+ *  you can redistribute it and/or modify it under the terms of the GNU
+ *  Lesser General Public License as published by the Free Software
+ *  Foundation, version 3.
+ *
+ *  It is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  See the GNU Lesser General Public License version 3.
+ *  for more details (enclosed in the file LICENSE).
+ *
+ **************************************************************************/
+
+/**
+ * Results of entailment problems kept on disk across runs.
+ */
+
+#ifndef NOLL_ENTL_CACHE_H_
+#define NOLL_ENTL_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+/** Canonical hash of a typed problem. */
+typedef struct noll_entl_cache_key_t
+{
+  uint64_t h[2];
+} noll_entl_cache_key_t;
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+bool noll_entl_cache_key (noll_entl_cache_key_t * key);
+/* Compute in @p key the hash of noll_prob, after typing.
+ * The hash is built from the structure of the formulas, where variables
+ * are given by their position, the predicate definitions, the fields
+ * and the options changing the result.
+ * Returns false if no cache directory is given by the option -C.
+ */
+
+int noll_entl_cache_get (const noll_entl_cache_key_t * key);
+/* Result stored for @p key, -1 if none. */
+
+void noll_entl_cache_put (const noll_entl_cache_key_t * key, int res);
+/* Store the result @p res (0 or 1) for @p key. */
+
+void noll_entl_cache_free (void);
+/* Unmap the index of the cache. Called at exit. */
+
+#endif /* NOLL_ENTL_CACHE_H_ */
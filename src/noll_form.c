@@ -23,6 +23,7 @@
 #include<sys/time.h>
 
 #include "noll_form.h"
+#include "noll_data.h"
 #include "noll_preds.h"
 #include "noll2bool.h"
 #include "noll2sat.h"
@@ -41,6 +42,10 @@ NOLL_VECTOR_DEFINE (noll_sterm_array, noll_sterm_t *);
 
 NOLL_VECTOR_DEFINE (noll_form_array, noll_form_t *);
 
+/** Word and bit of variable @p v in the bitsets of pure formulas */
+#define NOLL_PURE_WORD(v) ((v) >> 6)
+#define NOLL_PURE_BIT(v) (((uint64_t) 1) << ((v) & 63))
+
 /* ====================================================================== */
 /* Globals */
 /* ====================================================================== */
@@ -198,21 +203,23 @@ noll_pure_t *
 noll_pure_new (uint_t size)
 {
   noll_pure_t *ret = (noll_pure_t *) malloc (sizeof (struct noll_pure_t));
-  ret->m = NULL;
+  ret->uf = NULL;
+  ret->eq = NULL;
+  ret->neq = NULL;
   ret->size = size;
+  ret->words = (size + 63) / 64;
   if (ret->size > 0)
     {
-      ret->m =
-        (noll_pure_op_t **) malloc (ret->size * sizeof (noll_pure_op_t *));
+      ret->uf = (uid_t *) malloc (ret->size * sizeof (uid_t));
+      ret->eq =
+        (uint64_t *) calloc (ret->size * ret->words, sizeof (uint64_t));
+      ret->neq =
+        (uint64_t *) calloc (ret->size * ret->words, sizeof (uint64_t));
       for (uid_t i = 0; i < ret->size; i++)
         {
-          uid_t sz = ret->size - i;
-          ret->m[i] =
-            (noll_pure_op_t *) malloc (sz * sizeof (noll_pure_op_t));
-          // set the diagonal
-          ret->m[i][0] = NOLL_PURE_EQ;
-          for (uid_t j = 1; j < sz; j++)
-            ret->m[i][j] = NOLL_PURE_OTHER;
+          // each variable is alone in its class
+          ret->uf[i] = i;
+          ret->eq[i * ret->words + NOLL_PURE_WORD (i)] = NOLL_PURE_BIT (i);
         }
     }
   ret->data = NULL;
@@ -224,14 +231,12 @@ noll_pure_free (noll_pure_t * p)
 {
   if (!p)
     return;
-  if (p->m)
-    {
-      for (uid_t i = 0; i < p->size; i++)
-        if (p->m[i])
-          free (p->m[i]);
-
-      free (p->m);
-    }
+  if (p->uf)
+    free (p->uf);
+  if (p->eq)
+    free (p->eq);
+  if (p->neq)
+    free (p->neq);
   if (p->data)
     {
       noll_dform_array_delete (p->data);
@@ -345,6 +350,80 @@ noll_space_sub (noll_space_t * a, noll_uid_array * sub)
   return r;
 }
 
+static void
+noll_dterm_mark_vars (noll_dterm_t * t, bool * used);
+
+static void
+noll_dform_mark_vars (noll_dform_t * f, bool * used)
+{
+  if (f->kind == NOLL_DATA_IMPLIES)
+    {
+      if (f->p.bargs != NULL)
+        for (uint_t i = 0; i < noll_vector_size (f->p.bargs); i++)
+          noll_dform_mark_vars (noll_vector_at (f->p.bargs, i), used);
+    }
+  else if (f->p.targs != NULL)
+    for (uint_t i = 0; i < noll_vector_size (f->p.targs); i++)
+      noll_dterm_mark_vars (noll_vector_at (f->p.targs, i), used);
+}
+
+static void
+noll_dterm_mark_vars (noll_dterm_t * t, bool * used)
+{
+  if (t == NULL)
+    return;
+  if (t->kind == NOLL_DATA_VAR)
+    used[t->p.sid] = true;
+  if ((t->kind == NOLL_DATA_ITE) && (t->p.cond != NULL))
+    noll_dform_mark_vars (t->p.cond, used);
+  if (t->args != NULL)
+    for (uint_t i = 0; i < noll_vector_size (t->args); i++)
+      noll_dterm_mark_vars (noll_vector_at (t->args, i), used);
+}
+
+static void
+noll_space_mark_vars (noll_space_t * a, bool * used)
+{
+  if (NULL == a)
+    return;
+  switch (a->kind)
+    {
+    case NOLL_SPACE_PTO:
+      {
+        used[a->m.pto.sid] = true;
+        for (uint_t i = 0; i < noll_vector_size (a->m.pto.dest); i++)
+          used[noll_vector_at (a->m.pto.dest, i)] = true;
+        break;
+      }
+    case NOLL_SPACE_LS:
+      {
+        for (uint_t i = 0; i < noll_vector_size (a->m.ls.args); i++)
+          used[noll_vector_at (a->m.ls.args, i)] = true;
+        break;
+      }
+    case NOLL_SPACE_WSEP:
+    case NOLL_SPACE_SSEP:
+      {
+        for (uint_t i = 0; i < noll_vector_size (a->m.sep); i++)
+          noll_space_mark_vars (noll_vector_at (a->m.sep, i), used);
+        break;
+      }
+    default:
+      break;
+    }
+}
+
+void
+noll_form_mark_vars (noll_form_t * f, bool * used)
+{
+  if (f == NULL)
+    return;
+  noll_space_mark_vars (f->space, used);
+  if ((f->pure != NULL) && (f->pure->data != NULL))
+    for (uint_t i = 0; i < noll_vector_size (f->pure->data); i++)
+      noll_dform_mark_vars (noll_vector_at (f->pure->data, i), used);
+}
+
 noll_sterm_t *
 noll_sterm_new_var (uid_t v, noll_sterm_kind_t kind)
 {
@@ -404,145 +483,135 @@ noll_pure_add_dform (noll_pure_t * form, noll_dform_t * df)
   return 1;
 }
 
-noll_form_kind_t
-noll_pure_update_eq (noll_pure_t * f, uid_t l, uid_t c)
+uid_t
+noll_pure_find (noll_pure_t * f, uid_t v)
 {
-  assert (f);
-  assert (l < c);
-
-  if (noll_pure_matrix_at (f, l, c) == NOLL_PURE_NEQ)
+  assert (f && f->uf);
+  assert (v < f->size);
+  while (f->uf[v] != v)
     {
-#ifndef NDEBUG
-      fprintf (stdout, "noll_pure_update_eq(%d,%d): set unsat!\n", l, c);
-#endif
-      return NOLL_FORM_UNSAT;
+      f->uf[v] = f->uf[f->uf[v]];
+      v = f->uf[v];
     }
-  noll_pure_matrix_at (f, l, c) = NOLL_PURE_EQ;
-  return NOLL_FORM_SAT;
+  return v;
 }
 
-noll_form_kind_t
-noll_pure_update_neq (noll_pure_t * f, uid_t l, uid_t c)
+noll_pure_op_t
+noll_pure_get (noll_pure_t * f, uid_t v1, uid_t v2)
 {
-  assert (f);
-  assert (l < c);
+  if (v1 == v2)
+    return NOLL_PURE_EQ;
+  uid_t r1 = noll_pure_find (f, v1);
+  if (r1 == noll_pure_find (f, v2))
+    return NOLL_PURE_EQ;
+  if (f->neq[r1 * f->words + NOLL_PURE_WORD (v2)] & NOLL_PURE_BIT (v2))
+    return NOLL_PURE_NEQ;
+  return NOLL_PURE_OTHER;
+}
 
-  if (noll_pure_matrix_at (f, l, c) == NOLL_PURE_EQ)
-    {
-#ifndef NDEBUG
-      fprintf (stdout, "noll_pure_update_neq(%d,%d): set unsat!\n", l, c);
-#endif
-      return NOLL_FORM_UNSAT;
-    }
-  noll_pure_matrix_at (f, l, c) = NOLL_PURE_NEQ;
-  return NOLL_FORM_SAT;
+/**
+ * Add the members of class @p r to the classes different from
+ * the members of @p vars.
+ */
+static void
+noll_pure_spread_neq (noll_pure_t * f, uint64_t * vars, uid_t r)
+{
+  uint64_t *members = f->eq + r * f->words;
+  for (uint_t w = 0; w < f->words; w++)
+    for (uint64_t bits = vars[w]; bits != 0; bits &= bits - 1)
+      {
+        uid_t x = w * 64 + __builtin_ctzll (bits);
+        if (f->uf[x] != x)
+          continue;             // the root of the class is also in vars
+        uint64_t *nx = f->neq + x * f->words;
+        for (uint_t k = 0; k < f->words; k++)
+          nx[k] |= members[k];
+      }
 }
 
 noll_form_kind_t
-noll_pure_close_eq (noll_pure_t * pure, uid_t l, uid_t c)
+noll_pure_add_eq (noll_pure_t * f, uid_t v1, uid_t v2)
 {
-  assert (pure->size > l && pure->size > c);
-  assert (l < c);
-
-  noll_form_kind_t res = NOLL_FORM_SAT;
-  // close with entries < c-1
-  for (uid_t j = l + 1; (j < c) && (res != NOLL_FORM_UNSAT); j++)
+  assert (f && f->uf);
+  if (v1 == v2)
+    return NOLL_FORM_SAT;
+  uid_t l = noll_pure_find (f, v1);
+  uid_t c = noll_pure_find (f, v2);
+  if (l == c)
+    return NOLL_FORM_SAT;
+  if (c < l)
     {
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, l, j) == NOLL_PURE_EQ))
-        /* l = c && l = j => j = c */
-        res = noll_pure_update_eq (pure, j, c);
-
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, l, j) == NOLL_PURE_NEQ))
-        /* l = c && l != j => j != c */
-        res = noll_pure_update_neq (pure, j, c);
+      uid_t t = l;
+      l = c;
+      c = t;
     }
-
-  // close with entries > vcol
-  for (uid_t j = c + 1; (j < pure->size) && (res != NOLL_FORM_UNSAT); j++)
+  uint64_t *nl = f->neq + l * f->words;
+  if (nl[NOLL_PURE_WORD (c)] & NOLL_PURE_BIT (c))
     {
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, l, j) == NOLL_PURE_EQ))
-        /* v_lin = v_col && v_lin = j =>  v_col = j */
-        res = noll_pure_update_eq (pure, c, j);
-
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, l, j) == NOLL_PURE_NEQ))
-        /* v_lin = v_col && v_lin != j => j != v_col */
-        res = noll_pure_update_neq (pure, c, j);
-
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, c, j) == NOLL_PURE_EQ))
-        /* v_lin = v_col && v_col = j =>  v_lin = j */
-        res = noll_pure_update_eq (pure, l, j);
-
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, c, j) == NOLL_PURE_NEQ))
-        /* v_lin = v_col && v_col != j => v_lin != j */
-        res = noll_pure_update_neq (pure, l, j);
+#ifndef NDEBUG
+      fprintf (stdout, "noll_pure_add_eq(%d,%d): set unsat!\n", v1, v2);
+#endif
+      return NOLL_FORM_UNSAT;
     }
-  return res;
+  /// closure: the classes different from one class
+  /// become different from the other one
+  uint64_t *nc = f->neq + c * f->words;
+  noll_pure_spread_neq (f, nl, c);
+  noll_pure_spread_neq (f, nc, l);
+  /// merge c into l, the least variable stays the root
+  uint64_t *el = f->eq + l * f->words;
+  uint64_t *ec = f->eq + c * f->words;
+  for (uint_t k = 0; k < f->words; k++)
+    {
+      el[k] |= ec[k];
+      nl[k] |= nc[k];
+      ec[k] = 0;
+      nc[k] = 0;
+    }
+  f->uf[c] = l;
+  return NOLL_FORM_SAT;
 }
 
 noll_form_kind_t
-noll_pure_close_neq (noll_pure_t * pure, uid_t l, uid_t c)
+noll_pure_add_neq (noll_pure_t * f, uid_t v1, uid_t v2)
 {
-  assert (pure->size > l && pure->size > c);
-  assert (l < c);
-
-  noll_form_kind_t res = NOLL_FORM_SAT;
-  // close with entries < vcol-1
-  for (uid_t j = l + 1; (res != NOLL_FORM_UNSAT) && (j < c); j++)
+  assert (f && f->uf);
+  if (v1 == v2)
+    return NOLL_FORM_UNSAT;
+  uid_t l = noll_pure_find (f, v1);
+  uid_t c = noll_pure_find (f, v2);
+  if (l == c)
     {
-      if (noll_pure_matrix_at (pure, l, j) == NOLL_PURE_EQ)
-        /* v_lin != v_col && v_lin = j => j != v_col */
-        res = noll_pure_update_neq (pure, j, c);
+#ifndef NDEBUG
+      fprintf (stdout, "noll_pure_add_neq(%d,%d): set unsat!\n", v1, v2);
+#endif
+      return NOLL_FORM_UNSAT;
     }
-  // close with entries > vcol
-  for (uid_t j = c + 1; (res != NOLL_FORM_UNSAT) && (j < pure->size); j++)
+  /// closure: all the members of the classes are different
+  uint64_t *nl = f->neq + l * f->words;
+  uint64_t *nc = f->neq + c * f->words;
+  uint64_t *el = f->eq + l * f->words;
+  uint64_t *ec = f->eq + c * f->words;
+  for (uint_t k = 0; k < f->words; k++)
     {
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, l, j) == NOLL_PURE_EQ))
-        /* v_lin != v_col && v_lin = j =>  v_col != j */
-        res = noll_pure_update_neq (pure, c, j);
-
-      if ((res == NOLL_FORM_SAT) &&
-          (noll_pure_matrix_at (pure, c, j) == NOLL_PURE_EQ))
-        /* v_lin != v_col && v_col = j =>  v_lin != j */
-        res = noll_pure_update_neq (pure, l, j);
+      nl[k] |= ec[k];
+      nc[k] |= el[k];
     }
-  return res;
-}
-
-noll_form_kind_t
-noll_pure_add_eq (noll_pure_t * f, uid_t v1, uid_t v2)
-{
-  assert (f && f->m);
-  if (v1 == v2)
-    return NOLL_FORM_SAT;
-  uid_t l = (v1 < v2) ? v1 : v2;
-  uid_t c = (v1 < v2) ? v2 : v1;
-
-  noll_form_kind_t status = noll_pure_update_eq (f, l, c);
-  /// call closure 
-  status = noll_pure_close_eq (f, l, c);
-  return status;
+  return NOLL_FORM_SAT;
 }
 
-noll_form_kind_t
-noll_pure_add_neq (noll_pure_t * f, uid_t v1, uid_t v2)
+/**
+ * Record the relation @p op between @p v1 and @p v2, with closure.
+ * A relation already known is never forgotten, i.e., NOLL_PURE_OTHER
+ * and contradictory relations are ignored.
+ */
+void
+noll_pure_matrix_set (noll_pure_t * f, uid_t v1, uid_t v2, noll_pure_op_t op)
 {
-  assert (f && f->m);
-  if (v1 == v2)
-    return NOLL_FORM_UNSAT;
-  uid_t l = (v1 < v2) ? v1 : v2;
-  uid_t c = (v1 < v2) ? v2 : v1;
-
-  noll_form_kind_t status = noll_pure_update_neq (f, l, c);
-  /// call closure
-  status = noll_pure_close_neq (f, l, c);
-  return status;
+  if (op == NOLL_PURE_EQ)
+    noll_pure_add_eq (f, v1, v2);
+  else if (op == NOLL_PURE_NEQ)
+    noll_pure_add_neq (f, v1, v2);
 }
 
 void
@@ -823,10 +892,12 @@ noll_dform_array_compose (noll_uid_array * mg2, noll_dform_array * f1,
 /**
  * @brief Check that @p diff entails @p f->m[@p m].
  * 
+ * The rows of the bit matrix @p diff have (@p dsize + 63) / 64 words.
+ *
  * @return 0 if some constraint not entailed, 1 otherwise
  */
 int
-noll_pure_check_entl (bool ** diff, uint_t dsize, noll_pure_t * f,
+noll_pure_check_entl (const uint64_t * diff, uint_t dsize, noll_pure_t * f,
                       noll_uid_array * lmap,
                       noll_var_array * exvars, noll_uid_array * map,
                       noll_dform_array * df)
@@ -896,11 +967,9 @@ noll_pure_check_entl (bool ** diff, uint_t dsize, noll_pure_t * f,
           else if ((nv1 < dsize) && (nv2 < dsize))
             {
               assert (rhs_op == NOLL_PURE_NEQ);
-              bool lhs_isDiff = (nv1 != nv2);
-              if (nv1 < nv2)
-                lhs_isDiff = diff[nv2][nv1];
-              else if (nv2 < nv1)
-                lhs_isDiff = diff[nv1][nv2];
+              uint_t dwords = NOLL_PURE_WORD (dsize + 63);
+              bool lhs_isDiff = (diff[nv1 * dwords + NOLL_PURE_WORD (nv2)]
+                                 & NOLL_PURE_BIT (nv2)) ? true : false;
               res = (lhs_isDiff) ? 1 : 0;
             }
           else
@@ -932,33 +1001,15 @@ noll_pure_check_entl (bool ** diff, uint_t dsize, noll_pure_t * f,
 /**
  * @brief Check that constraints on data variables from @p df1 entail @p df2 .
  */
-uint ndform = 0;
 int
 noll_dform_array_check_entl (noll_var_array * lv1, noll_dform_array * df1,
                              noll_var_array * lv2, noll_uid_array * m,
-                             noll_dform_array * df2)
+                             noll_dform_array * df2, const bool *lhs)
 {
-  // TODO: for the moment prited out into a file
-  char *fname = (char *) malloc (20 * sizeof (char));
-  fname[0] = '\0';
-  snprintf (fname, 20, "df-%d.txt", ndform);
-  ndform++;
-  FILE *f = fopen (fname, "w");
-  fprintf (f, "lhs = (");
-  noll_var_array_fprint (f, lv1, "[");
-  fprintf (f, "] ");
-  noll_dform_array_fprint (f, lv1, df1);
-  fprintf (f, ") \n==>\nrhs = (");
-  noll_var_array_fprint (f, lv2, "[");
-  fprintf (f, "] x  [");
-  for (uint_t i = 0; i < noll_vector_size (m); i++)
-    fprintf (f, "%d -> %d,", i, noll_vector_at (m, i));
-  fprintf (f, "] ");
-  noll_dform_array_fprint (f, lv2, df2);
-  fprintf (f, ") \n");
-  fclose (f);
-  free (fname);
-  return 1;
+  /// @p df2 is already renamed by @p m, the variables not mapped
+  /// to @p lv1 are the existentials of @p lv2
+  (void) m;
+  return noll_data_check_entl (lv1, df1, lv2, df2, lhs);
 }
 
 /* ====================================================================== */
@@ -1099,7 +1150,7 @@ noll_dform_array_fprint (FILE * f,
 void
 noll_pure_fprint (FILE * f, noll_var_array * lvars, noll_pure_t * phi)
 {
-  if (!phi || !phi->m)
+  if (!phi || (phi->size == 0))
     {
       fprintf (f, "null\n");
       return;
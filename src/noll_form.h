@@ -112,11 +112,13 @@ extern "C"
 
 
 /** Pure formulas.
- *  Encoded as an upper diagonal matrix of size = nb location variables:
- *  for (v1(id) < v2(id))
- *    m[v1][v2] = NOLL_PURE_EQ if v1=v2,
- *                NOLL_PURE_NEQ if v1!=v2,
- *                NOLL_PURE_OTHER (-1) if unknown
+ *  Encoded by a union-find over the location variables:
+ *  each class keeps the bitset of its members and the bitset of the
+ *  variables known different from it, both packed in words of 64 bits.
+ *  The relation between v1 and v2 is read by noll_pure_matrix_at:
+ *    NOLL_PURE_EQ if v1=v2,
+ *    NOLL_PURE_NEQ if v1!=v2,
+ *    NOLL_PURE_OTHER (-1) if unknown
  */
   typedef enum noll_pure_op_t
   {
@@ -125,15 +127,18 @@ extern "C"
 
   typedef struct noll_pure_t
   {
-    noll_pure_op_t **m;         // matrix of equality and inequality constraints
+    uid_t *uf;                  // parent of each variable, the root of a class is its least member
+    uint64_t *eq;               // for each root, bitset of the members of its class
+    uint64_t *neq;              // for each root, bitset of the variables different from its class
+    uint_t words;               // number of words of a bitset
     uint_t size;                // allocated size for the matrix, 0 if empty or == locs_array size
     noll_dform_array *data;     // set (conjunction of) pure constraints on data
   } noll_pure_t;
 
 /**
- * For variable i <= j, the matrix p->m stores an array of size-i cells!
+ * Relation between variables @p i and @p j, computed from their classes.
  */
-#define noll_pure_matrix_at(p,i,j) p->m[i][j-i]
+#define noll_pure_matrix_at(p,i,j) noll_pure_get(p,i,j)
 
 /**
  * Spatial formulas.
@@ -289,13 +294,23 @@ extern "C"
   noll_space_t *noll_space_sub (noll_space_t * a, noll_uid_array * sub);
 /* Apply variable substitution and provide a copy */
 
+  void noll_form_mark_vars (noll_form_t * f, bool * used);
+/* Set used[v] for the variables v occurring in the space or the data
+ * constraints of f */
+
   int noll_pure_add_dform (noll_pure_t * form, noll_dform_t * df);
   noll_form_kind_t noll_pure_add_eq (noll_pure_t * form, uid_t v1, uid_t v2);
   noll_form_kind_t noll_pure_add_neq (noll_pure_t * form, uid_t v1, uid_t v2);
+  void noll_pure_matrix_set (noll_pure_t * form, uid_t v1, uid_t v2,
+                             noll_pure_op_t op);
   void noll_form_add_eq (noll_form_t * form, uid_t v1, uid_t v2);
   void noll_form_add_neq (noll_form_t * form, uid_t v1, uid_t v2);
 /* Add equality/inequality pure formula */
 
+  uid_t noll_pure_find (noll_pure_t * form, uid_t v);
+  noll_pure_op_t noll_pure_get (noll_pure_t * form, uid_t v1, uid_t v2);
+/* Least variable equal to @p v and relation between variables */
+
 /* ====================================================================== */
 /* Typing */
 /* ====================================================================== */
@@ -337,7 +352,8 @@ extern "C"
 /* Solvers */
 /* ====================================================================== */
 
-  int noll_pure_check_entl (bool ** diff, uint_t dsize, noll_pure_t * f,
+  int noll_pure_check_entl (const uint64_t * diff, uint_t dsize,
+                            noll_pure_t * f,
                             noll_uid_array * args,
                             noll_var_array * lv, noll_uid_array * map,
                             noll_dform_array * df);
@@ -346,8 +362,9 @@ extern "C"
   int noll_dform_array_check_entl (noll_var_array * lv1,
                                    noll_dform_array * df1,
                                    noll_var_array * lv2, noll_uid_array * m,
-                                   noll_dform_array * df2);
-/* Check that constraints on data variables from @p df1 entail @p df2 */
+                                   noll_dform_array * df2, const bool *lhs);
+/* Check that constraints on data variables from @p df1 entail @p df2,
+ * the variables v of lv1 with lhs[v] false occur only in the rhs */
 
 /* ====================================================================== */
 /* Printing */
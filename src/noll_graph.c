@@ -33,19 +33,21 @@ NOLL_VECTOR_DEFINE (noll_graph_array, noll_graph_t *);
 /* ====================================================================== */
 
 noll_edge_t *
-noll_edge_alloc (noll_edge_e kind, uint_t src, uint_t dst, uint_t label)
+noll_edge_alloc (noll_arena_t * a, noll_edge_e kind, uint_t src, uint_t dst,
+                 uint_t label)
 {
-  noll_edge_t *e = (noll_edge_t *) malloc (sizeof (noll_edge_t));
+  noll_edge_t *e = (a == NULL) ? (noll_edge_t *) malloc (sizeof (noll_edge_t))
+    : (noll_edge_t *) noll_arena_alloc (a, sizeof (noll_edge_t));
   e->kind = kind;
   e->label = label;
-  e->args = noll_uid_array_new ();
+  e->args = (a == NULL) ? noll_uid_array_new () : noll_uid_array_new_in (a);
   noll_uid_array_push (e->args, src);
   noll_uid_array_push (e->args, dst);
   e->id = UNDEFINED_ID;
   e->bound_svar = UNDEFINED_ID;
   ;                             // index of the set variable in slocs_array bounded to the edge, or UNDEFINED_ID
   e->impl = NULL;
-  e->ssep = noll_uid_array_new ();
+  e->ssep = (a == NULL) ? noll_uid_array_new () : noll_uid_array_new_in (a);
   return e;
 }
 
@@ -73,14 +75,14 @@ noll_edge_free (noll_edge_t * e)
 }
 
 noll_edge_t *
-noll_edge_copy (noll_edge_t * e)
+noll_edge_copy (noll_arena_t * a, noll_edge_t * e)
 {
   /* pre-conditions */
   assert (e != NULL);
 
   uint_t src = noll_vector_at (e->args, 0);
   uint_t dst = noll_vector_at (e->args, 1);
-  noll_edge_t *re = noll_edge_alloc (e->kind, src, dst, e->label);
+  noll_edge_t *re = noll_edge_alloc (a, e->kind, src, dst, e->label);
   /* push the other arguments if there exists */
   for (uint_t i = 2; i < noll_vector_size (e->args); i++)
     noll_uid_array_push (re->args, noll_vector_at (e->args, i));
@@ -106,9 +108,13 @@ noll_graph_alloc (noll_var_array * lvars, noll_var_array * svars,
     noll_var_array_fprint (stdout, lvars, "Vars of the graph: ");
   }
 #endif
-  res->lvars = noll_var_array_new ();
+  /*
+   * the graph is freed with its arena
+   */
+  res->arena = noll_arena_new ();
+  res->lvars = noll_var_array_new_in (res->arena);
   noll_var_array_copy (res->lvars, lvars);
-  res->svars = noll_var_array_new ();
+  res->svars = noll_var_array_new_in (res->arena);
   noll_var_array_copy (res->svars, svars);
   // size of the adj matrices
   res->nodes_size = nodes;
@@ -127,46 +133,40 @@ noll_graph_alloc (noll_var_array * lvars, noll_var_array * svars,
   /*
    * allocate the array of edges
    */
-  res->edges = noll_edge_array_new ();
+  res->edges = noll_edge_array_new_in (res->arena);
   if (edges > 0)
     noll_edge_array_reserve (res->edges, edges);
 
   /*
-   * allocate the adjacency matrices
+   * the adjacency is built by noll_graph_freeze
    */
-  res->mat = (noll_uid_array **) malloc (res->nodes_size
-                                         * sizeof (noll_uid_array *));
-  res->rmat = (noll_uid_array **) malloc (res->nodes_size
-                                          * sizeof (noll_uid_array *));
-  for (uint_t i = 0; i < res->nodes_size; i++)
-    {
-      res->mat[i] = NULL;
-      res->rmat[i] = NULL;
-    }
+  res->adj_off = NULL;
+  res->adj = NULL;
+  res->radj_off = NULL;
+  res->radj = NULL;
 
   /*
-   * allocate the difference edges, a low-diagonal matrix
+   * allocate the difference edges, a bit matrix
    */
-  res->diff = (bool **) malloc (res->nodes_size * sizeof (bool *));
-  for (uint_t i = 0; i < res->nodes_size; i++)
-    {
-      res->diff[i] = (bool *) malloc ((i + 1) * sizeof (bool));
-      for (uint_t j = 0; j <= i; j++)
-        res->diff[i][j] = false;
-    }
+  res->diff_words = NOLL_GRAPH_WORD (res->nodes_size + 63);
+  res->diff = (uint64_t *) noll_arena_calloc (res->arena,
+                                              res->nodes_size *
+                                              res->diff_words,
+                                              sizeof (uint64_t));
   res->data = NULL;
   res->isDataComplete = false;
   /*
    *  allocate the mapping of set variables to edges
    */
   res->sloc2edge =
-    (uint_t *) malloc (noll_vector_size (svars) * sizeof (uint_t));
+    (uint_t *) noll_arena_alloc (res->arena,
+                                 noll_vector_size (svars) * sizeof (uint_t));
   for (uint_t i = 0; i < noll_vector_size (svars); i++)
     {
       res->sloc2edge[i] = UNDEFINED_ID;
     }
   // allocate the sharing array
-  res->share = noll_share_array_new ();
+  res->share = noll_share_array_new_in (res->arena);
 
   res->isComplete = false;
   return res;
@@ -175,34 +175,11 @@ noll_graph_alloc (noll_var_array * lvars, noll_var_array * svars,
 void
 noll_graph_free (noll_graph_t * g)
 {
-
-  noll_var_array_delete (g->lvars);
-  g->lvars = NULL;
-  noll_var_array_delete (g->svars);
-  g->svars = NULL;
   if (g->var2node != NULL)
     free (g->var2node);
-  for (uint_t i = 0; i < g->nodes_size; i++)
-    {
-      if (g->mat[i] != NULL)
-        noll_uid_array_delete (g->mat[i]);
-      if (g->rmat[i] != NULL)
-        noll_uid_array_delete (g->rmat[i]);
-    }
-  free (g->mat);
-  free (g->rmat);
-  noll_edge_array_delete (g->edges);
-  if (g->diff != NULL)
-    for (uint_t i = 0; i < g->nodes_size; i++)
-      {
-        free (g->diff[i]);
-      }
-  free (g->diff);
   /// g->data freed in formulas
-  if (g->sloc2edge != NULL)
-    free (g->sloc2edge);
-  if (g->share != NULL)
-    noll_share_array_delete (g->share);
+  /// the edges, adjacency, differences and arrays are in the arena
+  noll_arena_delete (g->arena);
   free (g);
 }
 
@@ -222,7 +199,6 @@ noll_graph_copy_nodes (noll_graph_t * g)
                                        e_sz, NULL);
 
   /* copy var2nodes */
-  uint_t *v2n = (uint_t *) malloc (sizeof (uint_t) * v_sz);
   for (uint_t i = 0; i < v_sz; i++)
     rg->var2node[i] = g->var2node[i];
 
@@ -232,6 +208,62 @@ noll_graph_copy_nodes (noll_graph_t * g)
   return rg;
 }
 
+/**
+ * Build the adjacency of @p g in CSR form from the array of edges.
+ * The edges from (resp. to) a node are stored in increasing order
+ * of their identifiers, as they were added to the graph.
+ */
+void
+noll_graph_freeze (noll_graph_t * g)
+{
+  assert (g != NULL);
+
+  uint_t n_sz = g->nodes_size;
+  uint_t e_sz = noll_vector_size (g->edges);
+
+  /* one block for the offsets, one block for the edges,
+   * the previous blocks are left in the arena */
+  g->adj_off = (uint_t *) noll_arena_calloc (g->arena, 2 * (n_sz + 1),
+                                             sizeof (uint_t));
+  g->radj_off = g->adj_off + n_sz + 1;
+  g->adj = (uid_t *) noll_arena_alloc (g->arena,
+                                       (2 * e_sz + 1) * sizeof (uid_t));
+  g->radj = g->adj + e_sz;
+
+  /* count the edges from and to each node */
+  for (uint_t ei = 0; ei < e_sz; ei++)
+    {
+      noll_edge_t *e = noll_vector_at (g->edges, ei);
+      uint_t nsrc = noll_vector_at (e->args, 0);
+      uint_t ndst = noll_vector_at (e->args, 1);
+      assert (nsrc < n_sz && ndst < n_sz);
+      g->adj_off[nsrc + 1]++;
+      g->radj_off[ndst + 1]++;
+    }
+  for (uint_t i = 0; i < n_sz; i++)
+    {
+      g->adj_off[i + 1] += g->adj_off[i];
+      g->radj_off[i + 1] += g->radj_off[i];
+    }
+
+  /* fill the rows, using the end of the previous row as cursor */
+  for (uint_t ei = 0; ei < e_sz; ei++)
+    {
+      noll_edge_t *e = noll_vector_at (g->edges, ei);
+      uint_t nsrc = noll_vector_at (e->args, 0);
+      uint_t ndst = noll_vector_at (e->args, 1);
+      g->adj[g->adj_off[nsrc]++] = ei;
+      g->radj[g->radj_off[ndst]++] = ei;
+    }
+  for (uint_t i = n_sz; i > 0; i--)
+    {
+      g->adj_off[i] = g->adj_off[i - 1];
+      g->radj_off[i] = g->radj_off[i - 1];
+    }
+  g->adj_off[0] = 0;
+  g->radj_off[0] = 0;
+}
+
 
 /* ====================================================================== */
 /* Getters/setters */
@@ -295,13 +327,13 @@ noll_graph_get_edge (noll_graph_t * g, noll_edge_e kind, uint_t label,
   }
 #endif
 
-  if (g->mat[nroot] != NULL)
+  if (noll_graph_out_size (g, nroot) > 0)
     {
       for (uint_t i = 0;
-           (i < noll_vector_size (g->mat[nroot])) &&
+           (i < noll_graph_out_size (g, nroot)) &&
            (uid_res == UNDEFINED_ID); i++)
         {
-          uint_t ei = noll_vector_at (g->mat[nroot], i);
+          uint_t ei = noll_graph_out_at (g, nroot, i);
           noll_edge_t *edge_i = noll_vector_at (g->edges, ei);
           if ((edge_i->kind == kind) && (edge_i->label == label)
               && (noll_vector_size (edge_i->args) == fargs))
@@ -447,15 +479,26 @@ noll_graph_sat_dform (noll_graph_t * g)
  * @brief Return true if difference edge between nodes.
  */
 bool
-noll_graph_is_diff (noll_graph_t * g, uint_t n1, uint_t n2)
+noll_graph_is_diff (const noll_graph_t * g, uint_t n1, uint_t n2)
+{
+  assert (n1 < g->nodes_size);
+  assert (n2 < g->nodes_size);
+  return (g->diff[n1 * g->diff_words + NOLL_GRAPH_WORD (n2)]
+          & NOLL_GRAPH_BIT (n2)) ? true : false;
+}
+
+/**
+ * @brief Add a difference edge between nodes.
+ */
+void
+noll_graph_set_diff (noll_graph_t * g, uint_t n1, uint_t n2)
 {
   assert (n1 < g->nodes_size);
   assert (n2 < g->nodes_size);
   if (n1 == n2)
-    return false;
-  uint_t nmin = (n1 < n2) ? n1 : n2;
-  uint_t nmax = (n1 < n2) ? n2 : n1;
-  return g->diff[nmax][nmin];
+    return;
+  g->diff[n1 * g->diff_words + NOLL_GRAPH_WORD (n2)] |= NOLL_GRAPH_BIT (n2);
+  g->diff[n2 * g->diff_words + NOLL_GRAPH_WORD (n1)] |= NOLL_GRAPH_BIT (n1);
 }
 
 /**
@@ -477,12 +520,9 @@ noll_graph_is_ptosrc (noll_graph_t * g, uint_t n)
   assert (g != NULL);
   assert (n < g->nodes_size);
 
-  noll_uid_array *n_edges = g->mat[n];
-  if (n_edges == NULL)
-    return false;
-  for (uint i = 0; i < noll_vector_size (n_edges); i++)
+  for (uint i = 0; i < noll_graph_out_size (g, n); i++)
     {
-      uid_t eid = noll_vector_at (n_edges, i);
+      uid_t eid = noll_graph_out_at (g, n, i);
       noll_edge_t *ei = noll_vector_at (g->edges, eid);
       assert (ei != NULL);
       if (ei->kind == NOLL_EDGE_PTO)
@@ -612,46 +652,17 @@ noll_graph_dll (noll_graph_t * g, uid_t pid)
       uint_t nprv = noll_vector_at (e->args, 2);
       uint_t nfwd = noll_vector_at (e->args, 3);
       /* edge nlst --next-->nfwd */
-      noll_edge_t *enext = noll_edge_alloc (NOLL_EDGE_PTO, nlst, nfwd,
-                                            fid_next);
+      noll_edge_t *enext = noll_edge_alloc (g->arena, NOLL_EDGE_PTO, nlst,
+                                            nfwd, fid_next);
       enext->id = lst_eid;
       lst_eid++;
       noll_edge_array_push (e1_en, enext);
-      // update matrices of g
-      // push the edge enext in the matrix at entry nlst
-      noll_uid_array *lst_edges = g->mat[nlst];
-      if (lst_edges == NULL)
-        {
-          lst_edges = g->mat[nlst] = noll_uid_array_new ();
-        }
-      noll_uid_array_push (lst_edges, enext->id);
-      // push the edge enext in the reverse matrix at entry nfwd
-      noll_uid_array *fwd_edges = g->rmat[nfwd];
-      if (fwd_edges == NULL)
-        {
-          fwd_edges = g->rmat[nfwd] = noll_uid_array_new ();
-        }
-      noll_uid_array_push (fwd_edges, enext->id);
       /* edge nfst --prev-->nprev */
-      noll_edge_t *eprev = noll_edge_alloc (NOLL_EDGE_PTO, nfst, nprv,
-                                            fid_prev);
+      noll_edge_t *eprev = noll_edge_alloc (g->arena, NOLL_EDGE_PTO, nfst,
+                                            nprv, fid_prev);
       eprev->id = lst_eid;
       lst_eid++;
       noll_edge_array_push (e1_en, eprev);
-      // push the edge eprev in the matrix at entry nfst
-      noll_uid_array *fst_edges = g->mat[nfst];
-      if (fst_edges == NULL)
-        {
-          fst_edges = g->mat[nfst] = noll_uid_array_new ();
-        }
-      noll_uid_array_push (fst_edges, eprev->id);
-      // push the edge eprev in the reverse matrix at entry nprv
-      noll_uid_array *prv_edges = g->rmat[nprv];
-      if (prv_edges == NULL)
-        {
-          prv_edges = g->rmat[nprv] = noll_uid_array_new ();
-        }
-      noll_uid_array_push (prv_edges, eprev->id);
     }
   // push all the added edges in g
   for (uint ei = 0; ei < noll_vector_size (e1_en); ei++)
@@ -661,6 +672,8 @@ noll_graph_dll (noll_graph_t * g, uid_t pid)
       noll_vector_at (e1_en, ei) = NULL;
     }
   noll_edge_array_delete (e1_en);
+  // update the adjacency of g
+  noll_graph_freeze (g);
 }
 
 /* ====================================================================== */
@@ -753,10 +766,10 @@ noll_graph_fprint (FILE * f, noll_graph_t * g)
   fprintf (f, "\n");
   fprintf (f, "Graph difference edges: \n");
   assert (g->diff != NULL);
-  // low-diagonal matrix
+  // low-diagonal part of the matrix
   for (uint_t i = 0; i < g->nodes_size; i++)
-    for (uint_t j = 0; j <= i; j++)
-      if (g->diff[i][j] == true)
+    for (uint_t j = 0; j < i; j++)
+      if (noll_graph_is_diff (g, i, j) == true)
         fprintf (f, "\t\tn%d != n%d\n", i, j);
   fprintf (f, "Graph edges: \n");
   assert (g->edges);
@@ -769,19 +782,19 @@ noll_graph_fprint (FILE * f, noll_graph_t * g)
   if (noll_option_is_diag())
   {
     fprintf (f, "Matrices: mat = [");
-    for (uint_t vi = 0; vi < g->nodes_size; vi++)
+    for (uint_t vi = 0; (g->adj_off != NULL) && (vi < g->nodes_size); vi++)
       {
-        if (g->mat[vi] != NULL)
+        if (noll_graph_out_size (g, vi) > 0)
           {
             fprintf (f, "\n\tn%d --> ", vi);
-            for (uint_t i = 0; i < noll_vector_size (g->mat[vi]); i++)
-              fprintf (f, "e%d, ", noll_vector_at (g->mat[vi], i));
+            for (uint_t i = 0; i < noll_graph_out_size (g, vi); i++)
+              fprintf (f, "e%d, ", noll_graph_out_at (g, vi, i));
           }
-        if (g->rmat[vi] != NULL)
+        if (noll_graph_in_size (g, vi) > 0)
           {
             fprintf (f, "\n\tn%d <-- ", vi);
-            for (uint_t i = 0; i < noll_vector_size (g->rmat[vi]); i++)
-              fprintf (f, "e%d, ", noll_vector_at (g->rmat[vi], i));
+            for (uint_t i = 0; i < noll_graph_in_size (g, vi); i++)
+              fprintf (f, "e%d, ", noll_graph_in_at (g, vi, i));
           }
       }
     fprintf (f, "\n");
@@ -826,10 +839,10 @@ noll_graph_fprint_dot (char *fname, noll_graph_t * g)
 
   // fprintf(f, "Graph difference edges: \n");
   assert (g->diff != NULL);
-  // low-diagonal matrix
+  // low-diagonal part of the matrix
   for (uint_t i = 0; i < g->nodes_size; i++)
-    for (uint_t j = 0; j <= i; j++)
-      if (g->diff[i][j] == true)
+    for (uint_t j = 0; j < i; j++)
+      if (noll_graph_is_diff (g, i, j) == true)
         fprintf (f, "n%d -> n%d [style=dotted];\n", i, j);
   //fprintf(f, "Graph edges: \n");
   assert (g->edges);
@@ -898,10 +911,10 @@ noll_graph_fprint_sl (char *fname, noll_graph_t * g)
 
   // fprintf(f, "Pure difference atoms: \n");
   assert (g->diff != NULL);
-  // low-diagonal matrix
+  // low-diagonal part of the matrix
   for (uint_t i = 0; i < g->nodes_size; i++)
-    for (uint_t j = 0; j <= i; j++)
-      if (g->diff[i][j] == true)
+    for (uint_t j = 0; j < i; j++)
+      if (noll_graph_is_diff (g, i, j) == true)
         {
           fprintf (f, "%s <> %s and ", node2var[i], node2var[j]);
           isempty = false;
@@ -913,16 +926,15 @@ noll_graph_fprint_sl (char *fname, noll_graph_t * g)
   for (uint_t n = 0; n < g->nodes_size; n++)
     {
       char *vname = node2var[n];
-      if (g->mat[n] == NULL)
+      if (noll_graph_out_size (g, n) == 0)
         continue;
       /// print all edges, if any
       /// notice that there is no predicate + pto edge from the same node
       bool isempty_pto = true;
-      for (uint_t ei = 0; ei < noll_vector_size (g->mat[n]); ei++)
+      for (uint_t ei = 0; ei < noll_graph_out_size (g, n); ei++)
         {
           noll_edge_t *e = noll_vector_at (g->edges,
-                                           noll_vector_at (g->mat[n],
-                                                           ei));
+                                           noll_graph_out_at (g, n, ei));
           assert (e != NULL);
           if (e->kind == NOLL_EDGE_PTO)
             {
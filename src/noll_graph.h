@@ -51,13 +51,17 @@ NOLL_VECTOR_DECLARE (noll_edge_array, noll_edge_t *);
 typedef struct noll_graph_t
 {
   uint_t nodes_size;            // the number of nodes in the graph
+  noll_arena_t *arena;          // storage of the edges, the adjacency and the differences
   noll_var_array *lvars;        // graph environment
   noll_var_array *svars;
   uint_t *var2node;             // variables to node labels, array of size of lvars
   noll_edge_array *edges;       // the set of edges in the graph, excluding difference
-  noll_uid_array **mat;         // adjacency matrix, mat[i] is the list of edge identifiers from node i
-  noll_uid_array **rmat;        // reverse adjacency matrix, rmat[i] is the list of edge identifiers to node i
-  bool **diff;                  // low-diagonal matrix, diff[n1][n2] = true iff n1 != n2 and n1 > n2
+  uint_t *adj_off;              // adjacency (CSR), the edges from node i are adj[adj_off[i]..adj_off[i+1]-1]
+  uid_t *adj;                   // edge identifiers ordered by source node
+  uint_t *radj_off;             // reverse adjacency (CSR), the edges to node i are radj[radj_off[i]..radj_off[i+1]-1]
+  uid_t *radj;                  // edge identifiers ordered by destination node
+  uint64_t *diff;               // difference edges, bit n2 of row n1 is set iff n1 != n2 (symmetric)
+  uint_t diff_words;            // number of words in a row of diff
   noll_dform_array *data;       // data constraints over lvars
   bool isDataComplete;          // all diff and quality constraints are pushed in data ?
   uint_t *sloc2edge;            // mapping set variables to edges in graph
@@ -72,10 +76,12 @@ NOLL_VECTOR_DECLARE (noll_graph_array, noll_graph_t *);
 /* Constructors/destructors */
 /* ====================================================================== */
 
-noll_edge_t *noll_edge_alloc (noll_edge_e kind, uint_t src, uint_t dst,
-                              uint_t label);
+noll_edge_t *noll_edge_alloc (noll_arena_t * a, noll_edge_e kind,
+                              uint_t src, uint_t dst, uint_t label);
+noll_edge_t *noll_edge_copy (noll_arena_t * a, noll_edge_t * e);
+/* Allocate an edge in @p a, or in the heap if @p a is NULL */
 void noll_edge_free (noll_edge_t * e);
-noll_edge_t *noll_edge_copy (noll_edge_t * e);
+/* Free an edge allocated in the heap */
 
 noll_graph_t *noll_graph_alloc (noll_var_array * lvars,
                                 noll_var_array * svars, uint_t nodes,
@@ -84,10 +90,24 @@ void noll_graph_free (noll_graph_t * g);
 
 noll_graph_t *noll_graph_copy_nodes (noll_graph_t * g);
 
+void noll_graph_freeze (noll_graph_t * g);
+/* Build the adjacency of @p g from its edges.
+ * Shall be called again after the edges are changed. */
+
 /* ====================================================================== */
 /* Getters/setters */
 /* ====================================================================== */
 
+#define NOLL_GRAPH_WORD(n) ((n) >> 6)
+#define NOLL_GRAPH_BIT(n) (((uint64_t) 1) << ((n) & 63))
+
+#define noll_graph_out_size(g,n) ((g)->adj_off[(n) + 1] - (g)->adj_off[n])
+#define noll_graph_out_at(g,n,i) ((g)->adj[(g)->adj_off[n] + (i)])
+/* Number and identifiers of the edges from node @p n of a frozen graph */
+#define noll_graph_in_size(g,n) ((g)->radj_off[(n) + 1] - (g)->radj_off[n])
+#define noll_graph_in_at(g,n,i) ((g)->radj[(g)->radj_off[n] + (i)])
+/* Number and identifiers of the edges to node @p n of a frozen graph */
+
 uint_t noll_graph_get_var (const noll_graph_t * g, uint_t n);
 /* Get the first location variable labeling this node */
 
@@ -105,9 +125,12 @@ noll_typ_t noll_graph_get_node_type (noll_graph_t * g, uint_t n);
 void noll_graph_sat_dform (noll_graph_t * g);
 /* Update the data constraints in @g with eq constraints */
 
-bool noll_graph_is_diff (noll_graph_t * g, uint_t n1, uint_t n2);
+bool noll_graph_is_diff (const noll_graph_t * g, uint_t n1, uint_t n2);
 /* Return true if difference edge between nodes */
 
+void noll_graph_set_diff (noll_graph_t * g, uint_t n1, uint_t n2);
+/* Add a difference edge between nodes */
+
 bool noll_graph_is_node_data (noll_graph_t * g, uint_t n);
 /* Return true if @p n is a node represeting some data var */
 
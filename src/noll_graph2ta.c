@@ -36,9 +36,71 @@
 // a list of markings (associated to very node)
 NOLL_VECTOR_DECLARE (noll_marking_list, noll_uid_array *)
 NOLL_VECTOR_DEFINE (noll_marking_list, noll_uid_array *)
-// mapping of nodes to lists of paths
-  NOLL_VECTOR_DECLARE (noll_nodes_to_paths, noll_marking_list *)
-NOLL_VECTOR_DEFINE (noll_nodes_to_paths, noll_marking_list *)
+
+/**
+ * @brief  A hash table mapping pairs of identifiers to identifiers
+ *
+ * Open addressing with linear probing, the number of buckets is a power of 2.
+ */
+typedef struct noll_mark_table
+{
+  /// The keys, two per bucket, UNDEFINED_ID for empty buckets
+  uid_t *keys;
+
+  /// The values
+  uid_t *vals;
+
+  /// The number of buckets
+  uint_t buckets;
+
+  /// The number of keys stored
+  uint_t size;
+} noll_mark_table_t;
+
+/**
+ * @brief  The trie of markings built for a graph
+ *
+ * Every marking is interned as an identifier; the marking is the sequence of
+ * fields on the path from the root (epsilon) to it.
+ */
+typedef struct noll_mark_trie
+{
+  /// The parent of each marking, UNDEFINED_ID for epsilon
+  noll_uid_array *parent;
+
+  /// The last field of each marking
+  noll_uid_array *field;
+
+  /// Maps (marking, field) to the extended marking
+  noll_mark_table_t children;
+} noll_mark_trie_t;
+
+/**
+ * @brief  The output of the translation of a graph
+ *
+ * Either the tree encoding the graph, or the transitions of the TA accepting
+ * this tree, in the format of vata_add_transitions().
+ */
+typedef struct noll_graph2ta_out
+{
+  /// The tree built, NULL if only the transitions are built
+  noll_tree_t *tree;
+
+  /// The root state
+  uid_t root;
+
+  /// The parent state of each transition
+  noll_uid_array *parents;
+
+  /// The symbol of each transition
+  noll_ta_symbol_array *symbols;
+
+  /// The children of all transitions
+  noll_uid_array *children;
+
+  /// The start of the children of each transition, then the end
+  noll_uid_array *offsets;
+} noll_graph2ta_out_t;
 /* ====================================================================== */
 /* Macros */
 /* ====================================================================== */
@@ -361,220 +423,254 @@ noll_marking_is_prefix_or_equal (const noll_uid_array * pred,
 }
 
 
+/* ====================================================================== */
+/* Interned markings */
+/* ====================================================================== */
+
 /**
- * @brief  Updates the marking of a node
- *
- * Updates the marking of @p node according to the marking of the node @p src
- * according to the @p edge_lab. The markings are stored in @p markings_list.
- * Returns @p true if something has been changed, @p false otherwise.
- *
- * @param[in]      node           The node to have updated marking
- * @param[in]      src            The source according to which the marking to
- *                                be computed
- * @param[in]      edge_lab       The label to update the marking with
- * @param[in,out]  markings_list  The list of markings
+ * @brief  Initializes a table mapping pairs of identifiers to identifiers
  *
- * @returns  @p true if the marking has changed, @p false otherwise
+ * @param[out]  t  The table
  */
-static bool
-update_marking_from (uint_t node,
-                     uint_t src,
-                     uid_t edge_lab, noll_nodes_to_paths * markings_list)
+static void
+noll_mark_table_init (noll_mark_table_t * t)
 {
-  assert (NULL != markings_list);
-  assert (noll_vector_size (markings_list) > src);
-  assert (noll_vector_size (markings_list) > node);
+  assert (NULL != t);
+
+  t->buckets = 64;
+  t->size = 0;
+  t->keys = (uid_t *) malloc (2 * t->buckets * sizeof (uid_t));
+  t->vals = (uid_t *) malloc (t->buckets * sizeof (uid_t));
+  assert ((NULL != t->keys) && (NULL != t->vals));
+  for (uint_t i = 0; i < 2 * t->buckets; ++i)
+    {
+      t->keys[i] = UNDEFINED_ID;
+    }
+}
 
-  bool changed = false;
 
-  if (noll_option_is_diag())
-  {
-    NOLL_DEBUG ("Updating the marking of %u \"", node);
-    NOLL_DEBUG ("{");
-    for (size_t j = 0;
-         j < noll_vector_size (noll_vector_at (markings_list, node)); ++j)
-      {
-        noll_debug_print_one_mark (noll_vector_at
-                                   (noll_vector_at (markings_list, node), j));
-        NOLL_DEBUG (", ");
-      }
-    NOLL_DEBUG ("}");
-    NOLL_DEBUG ("\" from the marking of %u \"", src);
-    NOLL_DEBUG ("{");
-    for (size_t j = 0;
-         j < noll_vector_size (noll_vector_at (markings_list, src)); ++j)
-      {
-        noll_debug_print_one_mark (noll_vector_at
-                                   (noll_vector_at (markings_list, src), j));
-        NOLL_DEBUG (", ");
-      }
-    NOLL_DEBUG ("}");
-    NOLL_DEBUG ("\" over %s.\n", noll_field_name (edge_lab));
-  }
+static void
+noll_mark_table_fini (noll_mark_table_t * t)
+{
+  free (t->keys);
+  free (t->vals);
+  t->keys = NULL;
+  t->vals = NULL;
+}
 
-  // get markings of the source and destination nodes
-  const noll_marking_list *src_markings = noll_vector_at (markings_list, src);
-  noll_marking_list *node_markings = noll_vector_at (markings_list, node);
-  for (size_t j = 0; j < noll_vector_size (src_markings); ++j)
-    {
-      noll_uid_array *new_marking = noll_uid_array_new ();
-      noll_uid_array_copy (new_marking, noll_vector_at (src_markings, j));
-      assert (0 < noll_vector_size (new_marking));
-      /* if ((noll_vector_last(new_marking) == edge_lab) */
-      /*      && noll_fields_is_main_backbone(edge_lab)) */
-      /* { */
-      /*      // we keep the same marking */
-      /* } */
-      /* else if (noll_fields_order_lt(noll_vector_last(new_marking), edge_lab)) */
-      /* { */
-      // we add the field at the end of the marking
-      noll_uid_array_push (new_marking, edge_lab);
-      /* } */
-      /* else */
-      /* {    // in the case the 'edge_lab' is greater than the last of */
-      /*      // new_marking, this marking will surely be removed so we do not need */
-      /*      // to add it */
-      /*      noll_uid_array_delete(new_marking); */
-      /*      continue; */
-      /* } */
-
-      bool found = false;
-      for (size_t k = 0; k < noll_vector_size (node_markings); ++k)
-        {                       // check whether the marking is not already there
-          const noll_uid_array *dst_mark = noll_vector_at (node_markings, k);
-          assert (NULL != dst_mark);
-          if (noll_uid_array_equal (new_marking, dst_mark))
-            {
-              found = true;
-              break;
-            }
-        }
 
-      if (!found)
+static inline uint_t
+noll_mark_table_slot (const noll_mark_table_t * t, uid_t a, uid_t b)
+{
+  uint_t h = (a * 0x9E3779B1u) ^ (b * 0x85EBCA77u);
+  h ^= h >> 15;
+  uint_t mask = t->buckets - 1;
+  uint_t i = h & mask;
+  while ((t->keys[2 * i] != UNDEFINED_ID)
+         && ((t->keys[2 * i] != a) || (t->keys[2 * i + 1] != b)))
+    {                           // linear probing
+      i = (i + 1) & mask;
+    }
+
+  return i;
+}
+
+
+/**
+ * @brief  Looks up the pair (@p a, @p b) in the table @p t
+ *
+ * @returns  The value of the pair or UNDEFINED_ID if it is not in @p t
+ */
+static uid_t
+noll_mark_table_get (const noll_mark_table_t * t, uid_t a, uid_t b)
+{
+  assert (UNDEFINED_ID != a);
+
+  uint_t i = noll_mark_table_slot (t, a, b);
+  return (t->keys[2 * i] == UNDEFINED_ID) ? UNDEFINED_ID : t->vals[i];
+}
+
+
+/**
+ * @brief  Maps the pair (@p a, @p b), not in @p t, to @p v
+ */
+static void
+noll_mark_table_put (noll_mark_table_t * t, uid_t a, uid_t b, uid_t v)
+{
+  assert (UNDEFINED_ID != a);
+
+  if (2 * (t->size + 1) > t->buckets)
+    {                           // keep the load under 1/2
+      noll_mark_table_t old = *t;
+      t->buckets = 2 * old.buckets;
+      t->keys = (uid_t *) malloc (2 * t->buckets * sizeof (uid_t));
+      t->vals = (uid_t *) malloc (t->buckets * sizeof (uid_t));
+      assert ((NULL != t->keys) && (NULL != t->vals));
+      for (uint_t i = 0; i < 2 * t->buckets; ++i)
         {
-          changed = true;
-          noll_marking_list_push (node_markings, new_marking);
+          t->keys[i] = UNDEFINED_ID;
         }
-      else
+      for (uint_t i = 0; i < old.buckets; ++i)
         {
-          noll_uid_array_delete (new_marking);
+          if (old.keys[2 * i] != UNDEFINED_ID)
+            {
+              uint_t j =
+                noll_mark_table_slot (t, old.keys[2 * i], old.keys[2 * i + 1]);
+              t->keys[2 * j] = old.keys[2 * i];
+              t->keys[2 * j + 1] = old.keys[2 * i + 1];
+              t->vals[j] = old.vals[i];
+            }
         }
+      noll_mark_table_fini (&old);
     }
 
-  if (changed)
-    {
-      if (noll_option_is_diag())
-      {
-        NOLL_DEBUG ("Changed markings to\n");
-        // print the computed markings
-        for (size_t i = 0; i < noll_vector_size (markings_list); ++i)
-          {
-            const noll_marking_list *list = noll_vector_at (markings_list, i);
-            assert (NULL != list);
-            NOLL_DEBUG ("Node %zu: {", i);
-            for (size_t j = 0; j < noll_vector_size (list); ++j)
-              {
-                noll_debug_print_one_mark (noll_vector_at (list, j));
-                NOLL_DEBUG (", ");
-              }
-            NOLL_DEBUG ("}\n");
-          }
-      }
+  uint_t i = noll_mark_table_slot (t, a, b);
+  assert (t->keys[2 * i] == UNDEFINED_ID);
+  t->keys[2 * i] = a;
+  t->keys[2 * i + 1] = b;
+  t->vals[i] = v;
+  t->size++;
+}
+
+
+/**
+ * @brief  Initializes a trie of markings containing only epsilon
+ *
+ * The marking of identifier 0 is epsilon.
+ *
+ * @param[out]  trie  The trie
+ */
+static void
+noll_mark_trie_init (noll_mark_trie_t * trie)
+{
+  assert (NULL != trie);
+
+  trie->parent = noll_uid_array_new ();
+  trie->field = noll_uid_array_new ();
+  noll_mark_table_init (&trie->children);
+
+  noll_uid_array_push (trie->parent, UNDEFINED_ID);
+  noll_uid_array_push (trie->field, NOLL_MARKINGS_EPSILON);
+}
+
+
+static void
+noll_mark_trie_fini (noll_mark_trie_t * trie)
+{
+  noll_uid_array_delete (trie->parent);
+  noll_uid_array_delete (trie->field);
+  noll_mark_table_fini (&trie->children);
+}
+
+
+/**
+ * @brief  Interns the marking @p mark extended with the field @p edge_lab
+ *
+ * @returns  The identifier of the extended marking
+ */
+static uid_t
+noll_mark_trie_child (noll_mark_trie_t * trie, uid_t mark, uid_t edge_lab)
+{
+  assert (mark < noll_vector_size (trie->field));
+
+  uid_t res = noll_mark_table_get (&trie->children, mark, edge_lab);
+  if (UNDEFINED_ID == res)
+    {                           // a new marking
+      res = noll_vector_size (trie->field);
+      noll_uid_array_push (trie->parent, mark);
+      noll_uid_array_push (trie->field, edge_lab);
+      noll_mark_table_put (&trie->children, mark, edge_lab, res);
     }
 
-  return changed;
+  return res;
 }
 
 
-/// TODO
+/**
+ * @brief  Stores in @p out the sequence of fields of the marking @p mark
+ */
 static void
-rec_compute_paths (uint_t node,
-                   const noll_graph_t * graph,
-                   noll_uid_array * workstack,
-                   noll_nodes_to_paths * nodes_to_paths)
+noll_mark_trie_get (const noll_mark_trie_t * trie, uid_t mark,
+                    noll_uid_array * out)
 {
-  assert (NULL != graph);
-  assert (node < graph->nodes_size);
-  assert (NULL != workstack);
-  assert (NULL != nodes_to_paths);
-  assert (noll_vector_size (nodes_to_paths) == graph->nodes_size);
-  assert (noll_vector_size (workstack) > 0);
+  assert (mark < noll_vector_size (trie->field));
+  assert (NULL != out);
 
-  const noll_uid_array *edges_from_node = graph->mat[node];
-  if (NULL == edges_from_node)
-    {                           // in the case 'node' has no outgoing edges
-      return;
+  uint_t len = 0;
+  for (uid_t m = mark; m != UNDEFINED_ID; m = noll_vector_at (trie->parent, m))
+    {
+      ++len;
     }
 
-  for (size_t i = 0; i < noll_vector_size (edges_from_node); ++i)
+  noll_uid_array_resize (out, len);
+  for (uid_t m = mark; m != UNDEFINED_ID; m = noll_vector_at (trie->parent, m))
     {
-      uid_t edge_id = noll_vector_at (edges_from_node, i);
-      if (noll_option_is_diag())
-      {
-        NOLL_DEBUG ("Found edge %u\n", edge_id);
-      }
+      noll_vector_at (out, --len) = noll_vector_at (trie->field, m);
+    }
+}
 
-      const noll_edge_t *ed = noll_vector_at (graph->edges, edge_id);
-      assert (NULL != ed);
-      assert (2 <= noll_vector_size (ed->args));
-      if (noll_option_is_diag())
-      {
-        NOLL_DEBUG ("  src = %u\n", noll_vector_at (ed->args, 0));
-        NOLL_DEBUG ("  dst = %u\n", noll_vector_at (ed->args, 1));
-      }
-      assert (noll_vector_at (ed->args, 0) == node);
-      uid_t post_node = noll_vector_at (ed->args, 1);
-      assert (post_node < graph->nodes_size);
-      if (!noll_uid_array_contains (workstack, post_node))
-        {                       // if 'post_node' is not already on this path from initial node (this
-          // would create a cycle), call recursively
-          uid_t edge_lab;
-          if (NOLL_EDGE_PTO == ed->kind)
-            {                   // for points-to edges
-              edge_lab = ed->label;
-            }
-          else
-            {                   // for higher-order predicate edges
-              assert (NOLL_EDGE_PRED == ed->kind);
-              edge_lab = noll_pred_get_minfield (ed->label);
-            }
 
-          noll_uid_array_push (workstack, post_node);
-          update_marking_from (post_node, node, edge_lab, nodes_to_paths);
-          rec_compute_paths (post_node, graph, workstack, nodes_to_paths);
-          assert (!noll_vector_empty (workstack)
-                  && (noll_vector_last (workstack) == post_node));
-          noll_uid_array_pop (workstack);
-          assert (!noll_vector_empty (workstack)
-                  && (noll_vector_last (workstack) == node));
+/**
+ * @brief  Debugging output of the markings of paths to nodes
+ *
+ * @param[in]  trie            The trie of markings
+ * @param[in]  nodes_to_paths  The identifiers of markings of every node
+ */
+static void
+noll_debug_print_paths (const noll_mark_trie_t * trie,
+                        const noll_marking_list * nodes_to_paths)
+{
+  noll_uid_array *mark = noll_uid_array_new ();
+  for (size_t i = 0; i < noll_vector_size (nodes_to_paths); ++i)
+    {
+      const noll_uid_array *list = noll_vector_at (nodes_to_paths, i);
+      assert (NULL != list);
+      NOLL_DEBUG ("Node %zu: {", i);
+      for (size_t j = 0; j < noll_vector_size (list); ++j)
+        {
+          noll_mark_trie_get (trie, noll_vector_at (list, j), mark);
+          noll_debug_print_one_mark (mark);
+          NOLL_DEBUG (", ");
         }
+      NOLL_DEBUG ("}\n");
     }
+  noll_uid_array_delete (mark);
 }
 
 
 /**
- * @brief  Computes simple paths to nodes of graphs
+ * @brief  Computes the markings of simple paths to nodes of graphs
  *
- * Given a @p graph, this function computes all simple paths from @p initial_node to all nodes
- * of @p graph, which is stored into @p paths.
+ * Given a @p graph, this function explores the simple paths from
+ * @p initial_node depth first. When an edge from @p n to @p p is followed,
+ * the markings found so far for @p n, extended with the label of the edge,
+ * are added to the markings of @p p. The markings are interned in @p trie,
+ * and the identifiers of the markings of every node are stored into
+ * @p nodes_to_paths in the order they are found.
+ *
+ * The DFS uses an explicit stack of frames (node, next edge), and the pairs
+ * (node, marking) already found are kept in a hash table.
  *
  * @param[in]   graph           The input graph
  * @param[in]   initial_node    The initial node of @p graph
- * @param[out]  nodes_to_paths  The computed paths
+ * @param[in]   trie            The trie of markings
+ * @param[out]  nodes_to_paths  The computed markings
  */
 static void
 compute_simple_paths (const noll_graph_t * graph,
                       uint_t initial_node,
-                      noll_nodes_to_paths * nodes_to_paths)
+                      noll_mark_trie_t * trie,
+                      noll_marking_list * nodes_to_paths)
 {
   assert (NULL != graph);
   assert (initial_node < graph->nodes_size);
+  assert (NULL != trie);
   assert (NULL != nodes_to_paths);
 
-  noll_nodes_to_paths_resize (nodes_to_paths, graph->nodes_size);       // resize should allocate enough mem
+  noll_marking_list_resize (nodes_to_paths, graph->nodes_size);
   for (size_t i = 0; i < noll_vector_size (nodes_to_paths); ++i)
     {                           // we allocate empty list of markings for every node now
-      noll_vector_at (nodes_to_paths, i) = noll_marking_list_new ();
+      noll_vector_at (nodes_to_paths, i) = noll_uid_array_new ();
       assert (NULL != noll_vector_at (nodes_to_paths, i));
     }
 
@@ -583,23 +679,93 @@ compute_simple_paths (const noll_graph_t * graph,
     NOLL_DEBUG ("Computing simple paths of nodes of the graph\n");
   }
 
+  // the pairs (node, marking) found
+  noll_mark_table_t found;
+  noll_mark_table_init (&found);
+  // the nodes on the current path
+  bool *on_path = (bool *) calloc (graph->nodes_size, sizeof (bool));
+  assert (NULL != on_path);
+
   // initialize the marking of the initial node to be 'epsilon'
   // TODO: the NOLL_MARKINGS_EPSILON symbol is useless here, but it makes some
   // things easier (such as that *_last() will not fail)
-  noll_uid_array *epsilon_marking = noll_uid_array_new ();
-  assert (NULL != epsilon_marking);
-  noll_uid_array_push (epsilon_marking, NOLL_MARKINGS_EPSILON);
-  noll_marking_list *initial_node_markings =
-    noll_vector_at (nodes_to_paths, initial_node);
-  assert (NULL != initial_node_markings);
-  noll_marking_list_push (initial_node_markings, epsilon_marking);
-
-  // now, we start a DFS
-  noll_uid_array *workstack = noll_uid_array_new ();
-  assert (NULL != workstack);
-  noll_uid_array_push (workstack, initial_node);
-
-  rec_compute_paths (initial_node, graph, workstack, nodes_to_paths);
+  noll_uid_array_push (noll_vector_at (nodes_to_paths, initial_node), 0);
+  noll_mark_table_put (&found, initial_node, 0, 0);
+
+  // the stack of frames of the DFS
+  noll_uid_array *stack_node = noll_uid_array_new ();
+  noll_uid_array *stack_next = noll_uid_array_new ();
+  noll_uid_array_push (stack_node, initial_node);
+  noll_uid_array_push (stack_next, 0);
+  on_path[initial_node] = true;
+
+  while (!noll_vector_empty (stack_node))
+    {
+      uid_t node = noll_vector_last (stack_node);
+      uint_t i = noll_vector_last (stack_next);
+      if (i >= noll_graph_out_size (graph, node))
+        {                       // all edges from 'node' explored
+          on_path[node] = false;
+          noll_uid_array_pop (stack_node);
+          noll_uid_array_pop (stack_next);
+          continue;
+        }
+      noll_vector_last (stack_next) = i + 1;
+
+      uid_t edge_id = noll_graph_out_at (graph, node, i);
+      if (noll_option_is_diag())
+      {
+        NOLL_DEBUG ("Found edge %u\n", edge_id);
+      }
+
+      const noll_edge_t *ed = noll_vector_at (graph->edges, edge_id);
+      assert (NULL != ed);
+      assert (2 <= noll_vector_size (ed->args));
+      assert (noll_vector_at (ed->args, 0) == node);
+      uid_t post_node = noll_vector_at (ed->args, 1);
+      assert (post_node < graph->nodes_size);
+      if (on_path[post_node])
+        {                       // 'post_node' is already on this path from
+          // initial node (this would create a cycle)
+          continue;
+        }
+
+      uid_t edge_lab;
+      if (NOLL_EDGE_PTO == ed->kind)
+        {                       // for points-to edges
+          edge_lab = ed->label;
+        }
+      else
+        {                       // for higher-order predicate edges
+          assert (NOLL_EDGE_PRED == ed->kind);
+          edge_lab = noll_pred_get_minfield (ed->label);
+        }
+
+      // update the markings of 'post_node' from the ones of 'node'
+      const noll_uid_array *src_marks = noll_vector_at (nodes_to_paths, node);
+      noll_uid_array *post_marks = noll_vector_at (nodes_to_paths, post_node);
+      for (uint_t j = 0; j < noll_vector_size (src_marks); ++j)
+        {
+          uid_t post_mark =
+            noll_mark_trie_child (trie, noll_vector_at (src_marks, j),
+                                  edge_lab);
+          if (UNDEFINED_ID ==
+              noll_mark_table_get (&found, post_node, post_mark))
+            {                   // a new marking for 'post_node'
+              noll_mark_table_put (&found, post_node, post_mark, 0);
+              noll_uid_array_push (post_marks, post_mark);
+            }
+        }
+
+      on_path[post_node] = true;
+      noll_uid_array_push (stack_node, post_node);
+      noll_uid_array_push (stack_next, 0);
+    }
+
+  noll_uid_array_delete (stack_node);
+  noll_uid_array_delete (stack_next);
+  free (on_path);
+  noll_mark_table_fini (&found);
 }
 
 /**
@@ -620,9 +786,11 @@ compute_markings (const noll_graph_t * graph,
   assert (NULL != markings);
   assert (initial_node < graph->nodes_size);
 
-  noll_nodes_to_paths *nodes_to_paths = noll_nodes_to_paths_new ();
+  noll_mark_trie_t trie;
+  noll_mark_trie_init (&trie);
+  noll_marking_list *nodes_to_paths = noll_marking_list_new ();
   assert (NULL != nodes_to_paths);
-  compute_simple_paths (graph, initial_node, nodes_to_paths);
+  compute_simple_paths (graph, initial_node, &trie, nodes_to_paths);
 
   size_t num_nodes = graph->nodes_size;
   assert (0 < num_nodes);
@@ -634,28 +802,18 @@ compute_markings (const noll_graph_t * graph,
     NOLL_DEBUG ("Paths:\n");
 
     // print the computed markings
-    for (size_t i = 0; i < noll_vector_size (nodes_to_paths); ++i)
-      {
-        const noll_marking_list *list = noll_vector_at (nodes_to_paths, i);
-        assert (NULL != list);
-        NOLL_DEBUG ("Node %zu: {", i);
-        for (size_t j = 0; j < noll_vector_size (list); ++j)
-          {
-            noll_debug_print_one_mark (noll_vector_at (list, j));
-            NOLL_DEBUG (", ");
-          }
-        NOLL_DEBUG ("}\n");
-      }
+    noll_debug_print_paths (&trie, nodes_to_paths);
   }
 
   // compute the least marking for every node
+  noll_uid_array *mark = noll_uid_array_new ();
   for (size_t i = 0; i < noll_vector_size (nodes_to_paths); ++i)
     {
       if (noll_option_is_diag())
       {
         NOLL_DEBUG ("Going over node %zu\n", i);
       }
-      const noll_marking_list *list = noll_vector_at (nodes_to_paths, i);
+      const noll_uid_array *list = noll_vector_at (nodes_to_paths, i);
       assert (NULL != list);
       if (0 == noll_vector_size (list))
         {                       // if there is a node with no marking, this means that it is not reachable
@@ -664,57 +822,28 @@ compute_markings (const noll_graph_t * graph,
         }
 
       assert (noll_vector_size (list) > 0);
-      noll_uid_array **ptr_least_marking = &noll_vector_at (list, 0);
-      assert (NULL != ptr_least_marking);
-      assert (NULL != *ptr_least_marking);
+      noll_uid_array *least_marking = noll_uid_array_new ();
+      noll_mark_trie_get (&trie, noll_vector_at (list, 0), least_marking);
       for (size_t j = 1; j < noll_vector_size (list); ++j)
         {
-          noll_uid_array **mark = &noll_vector_at (list, j);
-          assert (NULL != mark);
-          assert (NULL != *mark);
-          if (noll_marking_order_lt (*mark, *ptr_least_marking))
+          noll_mark_trie_get (&trie, noll_vector_at (list, j), mark);
+          if (noll_marking_order_lt (mark, least_marking))
             {
-              ptr_least_marking = mark;
+              noll_uid_array_swap (mark, least_marking);
             }
         }
 
-      noll_vector_at (markings, i) = *ptr_least_marking;
-      *ptr_least_marking = NULL;
+      noll_vector_at (markings, i) = least_marking;
     }
-
-  if (noll_option_is_diag())
-  {
-    NOLL_DEBUG ("Before killing\n");
-    // print the computed markings
-    for (size_t i = 0; i < noll_vector_size (nodes_to_paths); ++i)
-      {
-        const noll_marking_list *list = noll_vector_at (nodes_to_paths, i);
-        assert (NULL != list);
-        NOLL_DEBUG ("Node %zu: {", i);
-        for (size_t j = 0; j < noll_vector_size (list); ++j)
-          {
-            noll_debug_print_one_mark (noll_vector_at (list, j));
-            NOLL_DEBUG (", ");
-          }
-        NOLL_DEBUG ("}\n");
-      }
-  }
+  noll_uid_array_delete (mark);
 
   // delete markings
   for (size_t i = 0; i < noll_vector_size (nodes_to_paths); ++i)
-    {                           // we allocate empty markings for every node now
-      noll_marking_list *list = noll_vector_at (nodes_to_paths, i);
-      assert (NULL != list);
-      for (size_t j = 0; j < noll_vector_size (list); ++j)
-        {
-          if (NULL != noll_vector_at (list, j))
-            {
-              noll_uid_array_delete (noll_vector_at (list, j));
-            }
-        }
-      noll_marking_list_delete (list);
+    {
+      noll_uid_array_delete (noll_vector_at (nodes_to_paths, i));
     }
-  noll_nodes_to_paths_delete (nodes_to_paths);
+  noll_marking_list_delete (nodes_to_paths);
+  noll_mark_trie_fini (&trie);
 
   // as the last step, remove duplicities from the paths to obtain real markings
   for (size_t i = 0; i < noll_vector_size (markings); ++i)
@@ -841,12 +970,12 @@ reachable_from_through_path_wo_marker (const noll_graph_t * graph,
   assert (src < graph->nodes_size);
   assert (dst < graph->nodes_size);
 
-  noll_uid_array *workstack = noll_uid_array_new ();
-  assert (NULL != workstack);
+  noll_uid_inline_array workstack_buf;
+  noll_uid_array *workstack = noll_uid_inline_array_init (&workstack_buf);
 
-  // an ordinary array for processed nodes
-  noll_uid_array *processed = noll_uid_array_new ();
-  assert (NULL != processed);
+  // a sorted set of processed nodes
+  noll_uid_inline_array processed_buf;
+  noll_uid_array *processed = noll_uid_inline_array_init (&processed_buf);
 
   noll_uid_array_push (workstack, src);
 
@@ -856,18 +985,17 @@ reachable_from_through_path_wo_marker (const noll_graph_t * graph,
       uid_t node = noll_vector_last (workstack);
       noll_uid_array_pop (workstack);
       assert (node < graph->nodes_size);
-      assert (!noll_uid_array_contains (processed, node));
-      noll_uid_array_push (processed, node);
+      assert (!noll_uid_array_scontains (processed, node));
+      noll_uid_array_scup (processed, node);
 
-      const noll_uid_array *edges_from_node = graph->mat[node];
-      if (NULL == edges_from_node)
+      if (0 == noll_graph_out_size (graph, node))
         {                       // in the case 'node' has no outgoing edges
           continue;
         }
 
-      for (size_t i = 0; i < noll_vector_size (edges_from_node); ++i)
+      for (size_t i = 0; i < noll_graph_out_size (graph, node); ++i)
         {
-          uid_t edge_id = noll_vector_at (edges_from_node, i);
+          uid_t edge_id = noll_graph_out_at (graph, node, i);
           if (noll_option_is_diag())
           {
             NOLL_DEBUG ("Found edge %u\n", edge_id);
@@ -896,15 +1024,15 @@ reachable_from_through_path_wo_marker (const noll_graph_t * graph,
               continue;
             }
 
-          if (!noll_uid_array_contains (processed, post_node) &&
+          if (!noll_uid_array_scontains (processed, post_node) &&
               !noll_uid_array_contains (workstack, post_node))
             {                   // if it has sense to add 'post_node' to processing
               noll_uid_array_push (workstack, post_node);
             }
         }
     }
-  noll_uid_array_delete (workstack);
-  noll_uid_array_delete (processed);
+  noll_uid_inline_array_fini (&workstack_buf);
+  noll_uid_inline_array_fini (&processed_buf);
 
   return found_dst;
 }
@@ -940,18 +1068,18 @@ find_first_ancestor_with_marking (uid_t node,
     noll_vector_at (marking_list, parent_node);
   while (!noll_uid_array_equal (marking, parent_node_mark))
     {
-      const noll_uid_array *rev_edges = graph->rmat[parent_node];
-      assert (NULL != rev_edges);
+      assert (0 < noll_graph_in_size (graph, parent_node));
 
       NOLL_DEBUG ("Node %u, parent edges: %u\n", parent_node,
-                  noll_vector_size (rev_edges));
+                  noll_graph_in_size (graph, parent_node));
 
       uid_t parent_edge_id = (uid_t) - 1;
       const noll_edge_t *parent_edge = NULL;
       // now, we pick the main backbone parent edge
-      for (size_t rev_i = 0; rev_i < noll_vector_size (rev_edges); ++rev_i)
+      for (size_t rev_i = 0;
+           rev_i < noll_graph_in_size (graph, parent_node); ++rev_i)
         {
-          uid_t rev_edge_id = noll_vector_at (rev_edges, rev_i);
+          uid_t rev_edge_id = noll_graph_in_at (graph, parent_node, rev_i);
           const noll_edge_t *edge_candid =
             noll_vector_at (graph->edges, rev_edge_id);
           assert (NULL != edge_candid);
@@ -1068,12 +1196,11 @@ is_the_first_successor_of_with_marking (uid_t dst,
 
   uint_t continuation_field = noll_vector_last (marking);
 
-  const noll_uid_array *mat_src = graph->mat[src];
-  assert (NULL != mat_src);
+  assert (0 < noll_graph_out_size (graph, src));
   for (size_t mat_src_i = 0;
-       mat_src_i < noll_vector_size (mat_src); ++mat_src_i)
+       mat_src_i < noll_graph_out_size (graph, src); ++mat_src_i)
     {
-      uint_t par_edge_id = noll_vector_at (mat_src, mat_src_i);
+      uint_t par_edge_id = noll_graph_out_at (graph, src, mat_src_i);
       assert (par_edge_id < noll_vector_size (graph->edges));
 
       const noll_edge_t *edge_from_par =
@@ -1325,11 +1452,47 @@ get_marking_symbol_of_node_wrt_base (uint_t node,
 /* ====================================================================== */
 
 /**
- *  Translates g into a tree automaton.
- *  @return TA built or NULL
+ * @brief  Emits the node @p node_index of the tree encoding a graph
+ *
+ * The node is created in the tree of @p out if any, otherwise the transition
+ * @p node_index -> @p symbol(@p children) is appended to the transitions of
+ * @p out.
  */
-noll_tree_t *
-noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
+static void
+noll_graph2ta_emit (noll_graph2ta_out_t * out,
+                    uid_t node_index,
+                    const noll_ta_symbol_t * symbol,
+                    const noll_uid_array * children)
+{
+  assert (NULL != out);
+  assert (NULL != symbol);
+
+  if (NULL != out->tree)
+    {
+      noll_tree_create_node (out->tree, node_index, symbol, children);
+      return;
+    }
+
+  noll_uid_array_push (out->parents, node_index);
+  noll_ta_symbol_array_push (out->symbols, symbol);
+  if (NULL != children)
+    {
+      for (uint_t i = 0; i < noll_vector_size (children); ++i)
+        {
+          noll_uid_array_push (out->children, noll_vector_at (children, i));
+        }
+    }
+  noll_uid_array_push (out->offsets, noll_vector_size (out->children));
+}
+
+
+/**
+ *  Translates g into a tree automaton, emitted into @p out.
+ *  @return true if the tree has been built, false otherwise
+ */
+static bool
+noll_graph2ta_build (const noll_graph_t * graph, const noll_uid_array * homo,
+                     noll_graph2ta_out_t * out)
 {
   // check sanity of input parameters
   assert (NULL != graph);
@@ -1337,6 +1500,7 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
   assert (NULL != graph->svars);
   assert (NULL != graph->var2node);
   assert (NULL != graph->edges);
+  assert (NULL != graph->adj_off);
   assert (NULL != homo);
   assert (2 <= noll_vector_size (homo));
 
@@ -1411,11 +1575,12 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
 
     NOLL_DEBUG ("Generating the tree for the graph\n");
   }
-  noll_tree_t* tree = noll_tree_new();
-  assert(NULL != tree);
-
   // set the initial node as the root state
-  noll_tree_set_root(tree, initial_node);
+  out->root = initial_node;
+  if (NULL != out->tree)
+    {
+      noll_tree_set_root (out->tree, initial_node);
+    }
 
   // we transform the graph into a TA representing a tree (i.e. the language of
   // the TA is a singleton set) such that node 'i' is represented by the TA
@@ -1424,8 +1589,8 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
   uint_t last_leaf = graph->nodes_size;
   for (size_t i = 0; i < graph->nodes_size; ++i)
     {
-      const noll_uid_array *edges = graph->mat[i];
-      if (NULL == edges)
+      const uint_t edges_size = noll_graph_out_size (graph, i);
+      if (0 == edges_size)
         {                       // if there are no edges leaving 'i'
           if (noll_uid_array_contains (homo, i))
             {                   // in the case 'i' is a boundary node on some tree branch
@@ -1436,8 +1601,8 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
 
               const noll_ta_symbol_t *symbol =
                 noll_ta_symbol_get_unique_aliased_var (noll_graph_get_var(graph,i));
-              noll_tree_create_node(
-                tree,        // the tree
+              noll_graph2ta_emit(
+                out,         // the output
                 i,           // the node index
                 symbol,      // the symbol
                 NULL);       // the children
@@ -1455,12 +1620,13 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
           continue;
         }
 
-      noll_uid_array *children = noll_uid_array_new ();
-      assert (NULL != children);
-      noll_uid_array *selectors = noll_uid_array_new ();
-      assert (NULL != selectors);
-      noll_uid_array *vars = noll_uid_array_new ();
-      assert (NULL != vars);
+      // short arrays, copied by the tree and the symbol database
+      noll_uid_inline_array children_buf;
+      noll_uid_array *children = noll_uid_inline_array_init (&children_buf);
+      noll_uid_inline_array selectors_buf;
+      noll_uid_array *selectors = noll_uid_inline_array_init (&selectors_buf);
+      noll_uid_inline_array vars_buf;
+      noll_uid_array *vars = noll_uid_inline_array_init (&vars_buf);
 
       if (noll_uid_array_contains (homo, i))
         {                       // in the case 'i' is pointed by a variable
@@ -1477,10 +1643,10 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
       bool is_pred_edge = false;
       uid_t pred_id = (uid_t) - 1;
       const noll_edge_t *pred_edge = NULL;
-      for (size_t j = 0; j < noll_vector_size (edges); ++j)
+      for (size_t j = 0; j < edges_size; ++j)
         {
           const noll_edge_t *ed =
-            noll_vector_at (graph->edges, noll_vector_at (edges, j));
+            noll_vector_at (graph->edges, noll_graph_out_at (graph, i, j));
           assert (NULL != ed);
 
           const char *field_name = noll_field_name (ed->label);
@@ -1508,9 +1674,8 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
               // two-dir => args >= 4
               assert (!edge_pred->typ->isTwoDir
                       || (4 <= noll_vector_size (ed->args)));
-              assert (1 == noll_vector_size (edges)
-                      || (edge_pred->typ->isTwoDir
-                          && (2 == noll_vector_size (edges))));
+              assert (1 == edges_size
+                      || (edge_pred->typ->isTwoDir && (2 == edges_size)));
 
               field_name = noll_pred_name (ed->label);
               assert (NULL != field_name);
@@ -1583,7 +1748,9 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
 
               if (NULL == alias_symb)
                 {               // in the case the marking could not be deduced, we are out of power
-                  noll_tree_free (tree);
+                  noll_uid_inline_array_fini (&children_buf);
+                  noll_uid_inline_array_fini (&selectors_buf);
+                  noll_uid_inline_array_fini (&vars_buf);
 
                   if (noll_option_is_diag())
                   {
@@ -1592,12 +1759,12 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
                     NOLL_DEBUG ("() without cleaning up!\n");
                   }
 
-                  return NULL;
+                  return false;
                 }
 
               size_t leaf_node = last_leaf++; // noll_get_unique ();
-              noll_tree_create_node(
-                tree,        // the tree
+              noll_graph2ta_emit(
+                out,         // the output
                 leaf_node,   // the node index
                 alias_symb,  // the symbol
                 NULL);       // the children
@@ -1672,8 +1839,8 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
                             noll_ta_symbol_get_str (param_symb));
               }
               size_t leaf_node = last_leaf++; // noll_get_unique ();
-              noll_tree_create_node(
-                tree,        // the tree
+              noll_graph2ta_emit(
+                out,         // the output
                 leaf_node,   // the node index
                 param_symb,  // the symbol
                 NULL);       // the children
@@ -1707,18 +1874,76 @@ noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
                     noll_ta_symbol_get_str (symbol));
       }
 
-      noll_tree_create_node(
-        tree,        // the tree
+      noll_graph2ta_emit(
+        out,         // the output
         i,           // the node index
         symbol,      // the symbol
         children);   // the children
 
-      noll_uid_array_delete (children);
-      noll_uid_array_delete (selectors);
-      noll_uid_array_delete (vars);
+      noll_uid_inline_array_fini (&children_buf);
+      noll_uid_inline_array_fini (&selectors_buf);
+      noll_uid_inline_array_fini (&vars_buf);
     }
 
   noll_marking_list_delete (markings);
 
-  return tree;
+  return true;
+}
+
+
+/**
+ *  Translates g into a tree.
+ *  @return tree built or NULL
+ */
+noll_tree_t *
+noll_graph2ta (const noll_graph_t * graph, const noll_uid_array * homo)
+{
+  noll_graph2ta_out_t out;
+  out.tree = noll_tree_new ();
+  assert (NULL != out.tree);
+
+  if (!noll_graph2ta_build (graph, homo, &out))
+    {
+      noll_tree_free (out.tree);
+      return NULL;
+    }
+
+  return out.tree;
+}
+
+
+/**
+ *  Translates g into a tree automaton, without building the tree.
+ *  @return TA built or NULL
+ */
+noll_ta_t *
+noll_graph2vata (const noll_graph_t * graph, const noll_uid_array * homo)
+{
+  noll_graph2ta_out_t out;
+  out.tree = NULL;
+  out.parents = noll_uid_array_new ();
+  out.symbols = noll_ta_symbol_array_new ();
+  out.children = noll_uid_array_new ();
+  out.offsets = noll_uid_array_new ();
+  // about one transition per node, with two children
+  noll_uid_array_reserve (out.parents, graph->nodes_size + 1);
+  noll_ta_symbol_array_reserve (out.symbols, graph->nodes_size + 1);
+  noll_uid_array_reserve (out.children, 2 * graph->nodes_size + 1);
+  noll_uid_array_reserve (out.offsets, graph->nodes_size + 2);
+  noll_uid_array_push (out.offsets, 0);
+
+  noll_ta_t *ta = NULL;
+  if (noll_graph2ta_build (graph, homo, &out))
+    {
+      ta = vata_create_ta ();
+      vata_set_state_root (ta, out.root);
+      vata_add_transitions (ta, out.parents, out.symbols, out.children,
+                            out.offsets);
+    }
+
+  noll_uid_array_delete (out.parents);
+  noll_ta_symbol_array_delete (out.symbols);
+  noll_uid_array_delete (out.children);
+  noll_uid_array_delete (out.offsets);
+  return ta;
 }
@@ -61,4 +61,22 @@
 noll_tree_t *noll_graph2ta (const noll_graph_t * graph,
                             const noll_uid_array * homo);
 
+
+/**
+ * @brief  Translates a graph into a TA, without building the tree
+ *
+ * Same as noll_graph2ta(), but the transitions are collected while the graph
+ * is traversed and added at once into a new TA, which has to be freed using
+ * vata_free_ta().
+ *
+ * @param[in]  graph  The graph to be translated to a TA
+ * @param[in]  homo   The mapping of arguments of a predicate edge to nodes of
+ *                    @p graph
+ *
+ * @returns  The TA encoding @p graph, or NULL if the graph could not be
+ *           translated
+ */
+noll_ta_t *noll_graph2vata (const noll_graph_t * graph,
+                            const noll_uid_array * homo);
+
 #endif /* NOLL_GRAPH2TA_H_ */
@@ -20,11 +20,16 @@
  * Homeomorphism definition and computation.
  */
 
+#include <errno.h>
 #include <stdbool.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include "noll_option.h"
 #include "noll_types.h"
 #include "noll_lemma.h"
 #include "noll_hom.h"
+#include "noll_scratch.h"
 #include "noll_entl.h"
 #include "noll.h"
 #include "noll_graph2ta.h"
@@ -311,6 +316,127 @@ noll_uid_array_compose (noll_uid_array * dst, noll_uid_array * src)
   return dst;
 }
 
+/**
+ * Record in @p hs that no simple homeomorphism exists for graph @p i,
+ * as done by noll_hom_build_1.
+ */
+static void
+noll_hom_set_empty (noll_hom_t * hs, size_t i)
+{
+  noll_shom_t *h = (noll_shom_t *) malloc (sizeof (noll_shom_t));
+  h->ngraph = i;
+  h->is_empty = true;
+  h->node_hom = NULL;
+  h->pto_hom = NULL;
+  h->ls_hom = NULL;
+  h->pused = NULL;
+  hs->is_empty = false;
+  noll_vector_at (hs->shom, i) = h;
+}
+
+/**
+ * Search the simple homeomorphisms for the negative graphs in parallel,
+ * using at most @p jobs child processes, each one checking one graph.
+ * The children get a copy of the problem, predicates and TA symbols,
+ * and return the result of noll_hom_build_1 in their exit status.
+ * The children still running are killed when one graph is mapped;
+ * the homeomorphism of this graph is built again in the caller.
+ *
+ * @return 1 if hom found, the result for the last graph otherwise
+ */
+static int
+noll_hom_build_par (noll_hom_t * h, uint_t jobs)
+{
+  size_t size = noll_vector_size (noll_prob->ngraph);
+  pid_t *pids = (pid_t *) malloc (size * sizeof (pid_t));
+  int *res = (int *) malloc (size * sizeof (int));
+  for (size_t i = 0; i < size; i++)
+    res[i] = -1;
+  size_t next = 0;              // next graph to be checked
+  size_t found = size;          // graph mapped
+  uint_t running = 0;
+
+  /* the children shall not print again the buffered output */
+  fflush (stdout);
+  fflush (stderr);
+  while ((found == size) && ((next < size) || (running > 0)))
+    {
+      /* start a child for the next graphs */
+      while ((next < size) && (running < jobs))
+        {
+          pid_t pid = fork ();
+          if (pid == 0)
+            {
+              int r = noll_hom_build_1 (h, next);
+              fflush (stdout);
+              /* _exit skips the atexit cleanup of the scratch files */
+              noll_scratch_free ();
+              _exit (r + 1);
+            }
+          if (pid < 0)
+            break;
+          pids[next++] = pid;
+          running++;
+        }
+      if (running == 0)
+        {                       /* fork failed, check the graph here */
+          res[next] = noll_hom_build_1 (h, next);
+          if (res[next] == 1)
+            found = next;
+          next++;
+          continue;
+        }
+
+      /* wait the end of a child */
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          break;
+        }
+      size_t i = 0;
+      while ((i < next) && (pids[i] != pid))
+        i++;
+      if (i == next)
+        continue;               // not a child of this search
+      pids[i] = 0;
+      running--;
+      /* a child killed is an incomplete search */
+      res[i] = WIFEXITED (status) ? (WEXITSTATUS (status) - 1) : -1;
+      if (res[i] == 1)
+        found = i;
+      else
+        noll_hom_set_empty (h, i);
+    }
+
+  /* cancel the search for the other graphs */
+  size_t first = next;          // first graph not decided
+  for (size_t i = 0; i < next; i++)
+    if (pids[i] > 0)
+      {
+        kill (pids[i], SIGKILL);
+        waitpid (pids[i], NULL, 0);
+        if (i < first)
+          first = i;
+      }
+
+  /* the children were not waited (waitpid failed), check the graphs here */
+  for (size_t i = first; (found == size) && (i < size); i++)
+    if ((i >= next) || (pids[i] > 0))
+      {
+        res[i] = noll_hom_build_1 (h, i);
+        if (res[i] == 1)
+          found = i;
+      }
+
+  int r = (found < size) ? noll_hom_build_1 (h, found) : res[size - 1];
+  free (pids);
+  free (res);
+  return r;
+}
+
 /**
  * Search a homeomorphism to prove noll_prob.
  * Store the homeomorphism found in noll_prob->hom.
@@ -327,15 +453,19 @@ noll_hom_build (void)
 
   /* compute a simple homeomorphism for each negative graph */
   int res = 0;
-  for (size_t i = 0; i < noll_vector_size (noll_prob->ngraph); i++)
-    {
-      res = noll_hom_build_1 (h, i);
-      /* TODO: update with the algo for disjunctions */
-      if (res == 1)
-        {
-          break;
-        }
-    }
+  uint_t jobs = noll_option_get_jobs ();
+  if ((jobs > 1) && (noll_vector_size (noll_prob->ngraph) > 1))
+    res = noll_hom_build_par (h, jobs);
+  else
+    for (size_t i = 0; i < noll_vector_size (noll_prob->ngraph); i++)
+      {
+        res = noll_hom_build_1 (h, i);
+        /* TODO: update with the algo for disjunctions */
+        if (res == 1)
+          {
+            break;
+          }
+      }
   noll_prob->hom = h;
   return res;
 }
@@ -408,12 +538,11 @@ noll_shom_build_nodes (noll_graph_t * g1, noll_graph_t * g2)
     {
       for (uint_t nj1 = 0; nj1 < ni1; nj1++)
         {
-          if (g1->diff[ni1][nj1])
+          if (noll_graph_is_diff (g1, ni1, nj1))
             {
               uint_t ni2 = noll_vector_at (n_hom, ni1);
               uint_t nj2 = noll_vector_at (n_hom, nj1);
-              bool isdiff2 = (ni2 < nj2) ? g2->diff[nj2][ni2]
-                : g2->diff[ni2][nj2];
+              bool isdiff2 = noll_graph_is_diff (g2, ni2, nj2);
               if (isdiff2 == false)
                 {
                   res = 0;
@@ -491,13 +620,13 @@ noll_shom_build_pto (noll_graph_t * g1, noll_graph_t * g2,
       uint_t nsrc_e2 = noll_vector_at (n_hom, nsrc_e1);
       uint_t ndst_e2 = noll_vector_at (n_hom, ndst_e1);
       /* the edge shall start from nsrc_e2 in g2 */
-      if (g2->mat[nsrc_e2] != NULL)
+      if (noll_graph_out_size (g2, nsrc_e2) > 0)
         {
           for (uint_t i = 0;
-               (i < noll_vector_size (g2->mat[nsrc_e2])) && (isHom == false);
+               (i < noll_graph_out_size (g2, nsrc_e2)) && (isHom == false);
                i++)
             {
-              uint_t ei2 = noll_vector_at (g2->mat[nsrc_e2], i);
+              uint_t ei2 = noll_graph_out_at (g2, nsrc_e2, i);
               noll_edge_t *e2 = noll_vector_at (g2->edges, ei2);
               if ((e2->kind == NOLL_EDGE_PTO) &&
                   (e2->label == e1->label) &&
@@ -611,9 +740,10 @@ noll_shom_select_rd (noll_graph_t * g, uint_t eid, uint_t label,
   /*
    * Build the set of nodes vg
    */
-  /* bit set of nodes in @p g selected */
+  /* bit set of nodes in @p g selected,
+   * the scratch of the selection is freed with the result */
   uint_t vg_size = g->nodes_size;
-  int *vg = (int *) malloc (vg_size * sizeof (int));
+  int *vg = (int *) noll_arena_alloc (rg->arena, vg_size * sizeof (int));
   for (uint_t i = 0; i < vg_size; i++)
     vg[i] = -1;                 /* not marked */
   /* mark the starting node */
@@ -629,11 +759,11 @@ noll_shom_select_rd (noll_graph_t * g, uint_t eid, uint_t label,
         vg[ai] = 3;             /* border */
     }
   /* the queue of nodes to be explored */
-  noll_uid_array *vqueue = noll_uid_array_new ();
+  noll_uid_array *vqueue = noll_uid_array_new_in (rg->arena);
   noll_uid_array_push (vqueue, noll_vector_at (args, 0));
   /* sets also the edges explored and labeled in L2 */
   uint_t eg_size = noll_vector_size (g->edges);
-  int *eg = (int *) malloc (eg_size * sizeof (int));
+  int *eg = (int *) noll_arena_alloc (rg->arena, eg_size * sizeof (int));
   for (uint_t i = 0; i < eg_size; i++)
     eg[i] = 0;                  /* not marked */
   /* exploration */
@@ -653,12 +783,11 @@ noll_shom_select_rd (noll_graph_t * g, uint_t eid, uint_t label,
           /* mark the node */
           vg[v] = 2;            /* internal */
           /* look at its successors labeled in L2 */
-          noll_uid_array *out_v = g->mat[v];
-          if (out_v != NULL)
+          if (noll_graph_out_size (g, v) > 0)
             {
-              for (uint_t i = 0; i < noll_vector_size (out_v); i++)
+              for (uint_t i = 0; i < noll_graph_out_size (g, v); i++)
                 {
-                  uint_t ei = noll_vector_at (out_v, i);
+                  uint_t ei = noll_graph_out_at (g, v, i);
                   /* if this edge has been already used, then error and stop */
                   if (noll_vector_at (used, ei) != UNDEFINED_ID)
                     {
@@ -736,12 +865,11 @@ noll_shom_select_rd (noll_graph_t * g, uint_t eid, uint_t label,
           (vg[v] == 1 && (noll_pred_is_one_dir (label) == false)))
         {
           /* outgoing edges from i */
-          noll_uid_array *out_v = g->mat[v];
-          if (out_v != NULL)
+          if (noll_graph_out_size (g, v) > 0)
             {
-              for (uint_t i = 0; i < noll_vector_size (out_v); i++)
+              for (uint_t i = 0; i < noll_graph_out_size (g, v); i++)
                 {
-                  uint_t ei = noll_vector_at (out_v, i);
+                  uint_t ei = noll_graph_out_at (g, v, i);
                   if (noll_vector_at (used, ei) != UNDEFINED_ID)
                     {
                       fprintf (stdout,
@@ -753,22 +881,11 @@ noll_shom_select_rd (noll_graph_t * g, uint_t eid, uint_t label,
                     {
                       noll_edge_t *e = noll_vector_at (g->edges, ei);
                       /* edge using the label, copy in the result */
-                      noll_edge_t *ecopy = noll_edge_copy (e);
-                      /* the source node */
-                      uint_t src = noll_vector_at (ecopy->args, 0);
-                      /* the destination node */
-                      uint_t dst = noll_vector_at (ecopy->args, 1);
+                      noll_edge_t *ecopy = noll_edge_copy (rg->arena, e);
                       /* the edge index */
                       uint_t new_id = noll_vector_size (rg->edges);
                       noll_edge_array_push (rg->edges, ecopy);
                       ecopy->id = new_id;
-                      /* update the the adjacency matrices */
-                      if (rg->mat[src] == NULL)
-                        rg->mat[src] = noll_uid_array_new ();
-                      noll_uid_array_push (rg->mat[src], new_id);
-                      if (rg->rmat[dst] == NULL)
-                        rg->rmat[dst] = noll_uid_array_new ();
-                      noll_uid_array_push (rg->rmat[dst], new_id);
                     }
                 }
             }
@@ -789,8 +906,9 @@ noll_shom_select_rd (noll_graph_t * g, uint_t eid, uint_t label,
     {
       for (uint_t j = 0; j <= i; j++)
         {
-          if ((i == 0 || vg[i] >= 0) && (j == 0 || vg[j] >= 0))
-            rg->diff[i][j] = g->diff[i][j];
+          if ((i == 0 || vg[i] >= 0) && (j == 0 || vg[j] >= 0)
+              && noll_graph_is_diff (g, i, j))
+            noll_graph_set_diff (rg, i, j);
         }
     }
   goto return_select_ls;
@@ -803,12 +921,11 @@ return_select_ls_error:
           (vg[v] == 1 && (noll_pred_is_one_dir (label) == false)))
         {
           /* outgoing edges from i */
-          noll_uid_array *out_v = g->mat[v];
-          if (out_v != NULL)
+          if (noll_graph_out_size (g, v) > 0)
             {
-              for (uint_t i = 0; i < noll_vector_size (out_v); i++)
+              for (uint_t i = 0; i < noll_graph_out_size (g, v); i++)
                 {
-                  uint_t ei = noll_vector_at (out_v, i);
+                  uint_t ei = noll_graph_out_at (g, v, i);
                   noll_vector_at (used, ei) = UNDEFINED_ID;
                 }
             }
@@ -826,14 +943,14 @@ return_select_ls_error:
 #endif
 
 return_select_ls:
-  /* correct return, free the auxiliary memory */
-  if (vg != NULL)
-    free (vg);
-  if (eg != NULL)
-    free (eg);
+  /* the auxiliary memory is in the arena of the result */
+  if (rg == NULL)
+    return NULL;
   /* fill data constraints */
   rg->data = g->data;
   rg->isComplete = g->isComplete;
+  /* build the adjacency of the result */
+  noll_graph_freeze (rg);
 
 #ifndef NDEBUG
   if (noll_option_is_diag())
@@ -908,7 +1025,7 @@ noll_shom_select_wf_0 (noll_graph_t * g2, noll_graph_t * sg2,
       // check the query Bool(g2) => ![fst=nv], i.e.,
       uid_t ni = (nv > nfst) ? nv : nfst;
       uid_t nj = (nv > nfst) ? nfst : nv;
-      res = (g2->diff[ni][nj]) ? 1 : 0;
+      res = (noll_graph_is_diff (g2, ni, nj)) ? 1 : 0;
 #ifndef NDEBUG
       if (noll_option_is_diag())
       {
@@ -939,7 +1056,7 @@ noll_shom_select_wf_0 (noll_graph_t * g2, noll_graph_t * sg2,
       uid_t pr = noll_vector_at (args2, 2);
       uid_t ni = (bk > pr) ? bk : pr;
       uid_t nj = (bk > pr) ? pr : bk;
-      res = (g2->diff[ni][nj]) ? 1 : 0;
+      res = (noll_graph_is_diff (g2, ni, nj)) ? 1 : 0;
 #ifndef NDEBUG
       if (noll_option_is_diag())
       {
@@ -1105,7 +1222,8 @@ noll_shom_select_wf_2 (noll_graph_t * g2, noll_graph_t * sg2,
    *     check unsat Bool(g1) => ![V=V']
    */
   /* collect all V' origin of some pto in sg2 */
-  noll_uid_array *src_pto = noll_uid_array_new ();
+  noll_uid_inline_array src_pto_buf;
+  noll_uid_array *src_pto = noll_uid_inline_array_init (&src_pto_buf);
   for (uint_t eid2 = 0; eid2 < noll_vector_size (sg2->edges); eid2++)
     {
       noll_edge_t *e2 = noll_vector_at (sg2->edges, eid2);
@@ -1118,7 +1236,7 @@ noll_shom_select_wf_2 (noll_graph_t * g2, noll_graph_t * sg2,
   if (noll_vector_empty (src_pto))
     {
       // no check needed
-      noll_uid_array_delete (src_pto);
+      noll_uid_inline_array_fini (&src_pto_buf);
       return res;               // 1
     }
 
@@ -1136,10 +1254,10 @@ noll_shom_select_wf_2 (noll_graph_t * g2, noll_graph_t * sg2,
           uid_t nvp = noll_vector_at (src_pto, j);
           // check the query Bool(g1) => ![V=V'], i.e.,
           // there is a difference edge between V and V'
-          // in the low diagonal matrix og g2->diff
+          // in the bit matrix g2->diff
           uid_t ni = (nv > nvp) ? nv : nvp;
           uid_t nj = (nv > nvp) ? nvp : nv;
-          res = (g2->diff[ni][nj]) ? 1 : 0;
+          res = (noll_graph_is_diff (g2, ni, nj)) ? 1 : 0;
 #ifndef NDEBUG
           if (noll_option_is_diag())
           {
@@ -1165,7 +1283,7 @@ noll_shom_select_wf_2 (noll_graph_t * g2, noll_graph_t * sg2,
             }
         }
     }
-  noll_uid_array_delete (src_pto);
+  noll_uid_inline_array_fini (&src_pto_buf);
   return res;
 }
 
@@ -1206,9 +1324,253 @@ noll_shom_select_wf (noll_graph_t * g2, noll_graph_t * sg2,
   return res;
 }
 
+/* ====================================================================== */
+/* Memoization of the TA checks */
+/* ====================================================================== */
+
+/* Maximal number of results kept, the least recently used is dropped */
+#define NOLL_SHOM_CACHE_SIZE 4096
+
+/* Number of buckets of the table, a power of 2 */
+#define NOLL_SHOM_CACHE_BUCKETS (2 * NOLL_SHOM_CACHE_SIZE)
+
+/* A result of noll_shom_check_TA for a canonical key */
+typedef struct noll_shom_cache_s
+{
+  noll_uid_array *key;          // canonical form of the check
+  uint_t hash;                  // hash of key
+  int res;                      // result of the check
+  struct noll_shom_cache_s *prev;       // more recently used entry
+  struct noll_shom_cache_s *next;       // less recently used entry
+  struct noll_shom_cache_s *chain;      // next entry in the bucket
+} noll_shom_cache_t;
+
+/* The table of results, kept across queries until noll_shom_cache_free */
+static noll_shom_cache_t **shom_cache = NULL;
+static noll_shom_cache_t *shom_cache_first = NULL;     // most recently used
+static noll_shom_cache_t *shom_cache_last = NULL;      // least recently used
+static uint_t shom_cache_size = 0;
+
+/**
+ * Give a number in @p canon to node @p n of @p g2 if not yet done.
+ */
+static void
+noll_shom_cache_visit (uid_t n, uid_t * canon, noll_uid_array * order)
+{
+  if (canon[n] == UNDEFINED_ID)
+    {
+      canon[n] = noll_vector_size (order);
+      noll_uid_array_push (order, n);
+    }
+}
+
+/**
+ * Build the canonical form of the check of @p e1 on @p g2 with the
+ * mapping @p h of the arguments of @p e1 to nodes of @p g2.
+ *
+ * The nodes of @p g2 are renumbered in the BFS order from the nodes in
+ * @p h following the out-edges, then from the other sources of edges of
+ * the whole graph in the order of their ids. Nodes not in @p h and
+ * without edges are ignored.
+ * The key contains the predicate and the arguments of @p e1, the mapping
+ * @p h, and for each node its variable and its out-edges. The variables
+ * and the arguments of @p e1 are kept with their ids, thus only checks
+ * over the same variables share a key; isomorphic subgraphs over other
+ * variables do not.
+ *
+ * @return the key, NULL if @p g2 has no adjacency
+ */
+static noll_uid_array *
+noll_shom_cache_key (noll_graph_t * g2, noll_edge_t * e1, noll_uid_array * h)
+{
+  if (g2->adj_off == NULL)
+    return NULL;
+
+  uid_t *canon = (uid_t *) malloc (g2->nodes_size * sizeof (uid_t));
+  for (uint_t n = 0; n < g2->nodes_size; n++)
+    canon[n] = UNDEFINED_ID;
+  noll_uid_array *order = noll_uid_array_new ();
+
+  /* the nodes reached from the mapping, then the other sources of edges */
+  for (uint_t i = 0; i < noll_vector_size (h); i++)
+    noll_shom_cache_visit (noll_vector_at (h, i), canon, order);
+  uint_t next = 0;
+  for (uint_t seed = 0; seed <= g2->nodes_size; seed++)
+    {
+      for (; next < noll_vector_size (order); next++)
+        {
+          uid_t n = noll_vector_at (order, next);
+          for (uint_t j = 0; j < noll_graph_out_size (g2, n); j++)
+            {
+              noll_edge_t *e =
+                noll_vector_at (g2->edges, noll_graph_out_at (g2, n, j));
+              for (uint_t k = 1; k < noll_vector_size (e->args); k++)
+                noll_shom_cache_visit (noll_vector_at (e->args, k), canon,
+                                       order);
+            }
+        }
+      if ((seed < g2->nodes_size) && (noll_graph_out_size (g2, seed) > 0))
+        noll_shom_cache_visit (seed, canon, order);
+    }
+
+  noll_uid_array *key = noll_uid_array_new ();
+  noll_uid_array_push (key, e1->label);
+  noll_uid_array_push (key, noll_vector_size (e1->args));
+  for (uint_t i = 0; i < noll_vector_size (e1->args); i++)
+    noll_uid_array_push (key, noll_vector_at (e1->args, i));
+  noll_uid_array_push (key, noll_vector_size (h));
+  for (uint_t i = 0; i < noll_vector_size (h); i++)
+    noll_uid_array_push (key, canon[noll_vector_at (h, i)]);
+  noll_uid_array_push (key, noll_vector_size (order));
+  for (uint_t c = 0; c < noll_vector_size (order); c++)
+    {
+      uid_t n = noll_vector_at (order, c);
+      noll_uid_array_push (key, noll_graph_get_var (g2, n));
+      noll_uid_array_push (key, noll_graph_out_size (g2, n));
+      for (uint_t j = 0; j < noll_graph_out_size (g2, n); j++)
+        {
+          noll_edge_t *e =
+            noll_vector_at (g2->edges, noll_graph_out_at (g2, n, j));
+          noll_uid_array_push (key, e->kind);
+          noll_uid_array_push (key, e->label);
+          noll_uid_array_push (key, noll_vector_size (e->args));
+          for (uint_t k = 1; k < noll_vector_size (e->args); k++)
+            noll_uid_array_push (key, canon[noll_vector_at (e->args, k)]);
+        }
+    }
+
+  noll_uid_array_delete (order);
+  free (canon);
+  return key;
+}
+
+static uint_t
+noll_shom_cache_hash (const noll_uid_array * key)
+{
+  /* FNV-1a on the identifiers */
+  uint_t hash = 2166136261u;
+  for (uint_t i = 0; i < noll_vector_size (key); i++)
+    {
+      hash ^= noll_vector_at (key, i);
+      hash *= 16777619u;
+    }
+  return hash;
+}
+
+/**
+ * Remove @p c from the list of entries ordered by use.
+ */
+static void
+noll_shom_cache_unlink (noll_shom_cache_t * c)
+{
+  if (c->prev != NULL)
+    c->prev->next = c->next;
+  else
+    shom_cache_first = c->next;
+  if (c->next != NULL)
+    c->next->prev = c->prev;
+  else
+    shom_cache_last = c->prev;
+  c->prev = c->next = NULL;
+}
+
+/**
+ * Put @p c at the head of the list of entries ordered by use.
+ */
+static void
+noll_shom_cache_link (noll_shom_cache_t * c)
+{
+  c->prev = NULL;
+  c->next = shom_cache_first;
+  if (shom_cache_first != NULL)
+    shom_cache_first->prev = c;
+  shom_cache_first = c;
+  if (shom_cache_last == NULL)
+    shom_cache_last = c;
+}
+
+/**
+ * Search the result of the check of @p key.
+ *
+ * @return the entry found, NULL otherwise
+ */
+static noll_shom_cache_t *
+noll_shom_cache_get (const noll_uid_array * key, uint_t hash)
+{
+  if (shom_cache == NULL)
+    return NULL;
+
+  noll_shom_cache_t *c = shom_cache[hash & (NOLL_SHOM_CACHE_BUCKETS - 1)];
+  for (; c != NULL; c = c->chain)
+    if ((c->hash == hash) && noll_uid_array_equal (c->key, key))
+      {
+        noll_shom_cache_unlink (c);
+        noll_shom_cache_link (c);
+        return c;
+      }
+  return NULL;
+}
+
+/**
+ * Store the result @p res of the check of @p key, which is then owned by
+ * the cache.
+ */
+static void
+noll_shom_cache_put (noll_uid_array * key, uint_t hash, int res)
+{
+  if (shom_cache == NULL)
+    shom_cache = (noll_shom_cache_t **)
+      calloc (NOLL_SHOM_CACHE_BUCKETS, sizeof (noll_shom_cache_t *));
+
+  noll_shom_cache_t *c = NULL;
+  if (shom_cache_size < NOLL_SHOM_CACHE_SIZE)
+    {
+      c = (noll_shom_cache_t *) malloc (sizeof (noll_shom_cache_t));
+      shom_cache_size++;
+    }
+  else
+    {
+      /* reuse the least recently used entry */
+      c = shom_cache_last;
+      noll_shom_cache_unlink (c);
+      noll_shom_cache_t **pc =
+        &shom_cache[c->hash & (NOLL_SHOM_CACHE_BUCKETS - 1)];
+      while (*pc != c)
+        pc = &(*pc)->chain;
+      *pc = c->chain;
+      noll_uid_array_delete (c->key);
+    }
+
+  c->key = key;
+  c->hash = hash;
+  c->res = res;
+  uint_t b = hash & (NOLL_SHOM_CACHE_BUCKETS - 1);
+  c->chain = shom_cache[b];
+  shom_cache[b] = c;
+  noll_shom_cache_link (c);
+}
+
+void
+noll_shom_cache_free (void)
+{
+  while (shom_cache_first != NULL)
+    {
+      noll_shom_cache_t *c = shom_cache_first;
+      shom_cache_first = c->next;
+      noll_uid_array_delete (c->key);
+      free (c);
+    }
+  shom_cache_last = NULL;
+  shom_cache_size = 0;
+  if (shom_cache != NULL)
+    free (shom_cache);
+  shom_cache = NULL;
+}
+
 /**
  * Check that the graph in @p g2 is an unfolding of the edge @p e1.
  * The mapping of the arguments of @p e1 on nodes of @p g2 are given by @p h.
+ * The results of the checks using TA are memoized.
  */
 int
 noll_shom_check (noll_graph_t * g2, noll_edge_t * e1, noll_uid_array * h,
@@ -1221,10 +1583,29 @@ noll_shom_check (noll_graph_t * g2, noll_edge_t * e1, noll_uid_array * h,
   assert (h != NULL);
 
   /* TODO: select the method of checking entailment using the option */
-  if (noll_option_is_checkTA () == true)
-    return noll_shom_check_TA (g2, e1, h);
-  else
+  if (noll_option_is_checkTA () == false)
     return noll_shom_check_syn (g2, e1, h, df1);
+
+  /* the check of TA does not depend on data, it is memoized;
+   * a hit skips noll_graph_dll (g2, ...) done by noll_shom_check_TA for
+   * doubly linked predicates, thus g2 is transformed or not depending on
+   * the checks done before */
+  noll_uid_array *key = noll_shom_cache_key (g2, e1, h);
+  if (key == NULL)
+    return noll_shom_check_TA (g2, e1, h);
+  uint_t hash = noll_shom_cache_hash (key);
+  noll_shom_cache_t *c = noll_shom_cache_get (key, hash);
+  if (c != NULL)
+    {
+      if (noll_option_get_verb () > 0)
+        fprintf (stdout, "\nspen: check of %s found in the cache\n",
+                 noll_pred_name (e1->label));
+      noll_uid_array_delete (key);
+      return c->res;
+    }
+  int res = noll_shom_check_TA (g2, e1, h);
+  noll_shom_cache_put (key, hash, res);
+  return res;
 }
 
 /**
@@ -1239,16 +1620,12 @@ noll_shom_check_TA (noll_graph_t * g2, noll_edge_t * e1, noll_uid_array * h)
       // special case for generating TA from graphs with dll
       noll_graph_dll (g2, e1->label);
     }
-  noll_tree_t *g2_tree = noll_graph2ta (g2, h);
-  if (NULL == g2_tree)
+  noll_ta_t *g2_ta = noll_graph2vata (g2, h);
+  if (NULL == g2_ta)
     {                           // if the graph could not be translated to a tree
       NOLL_DEBUG ("Could not translate the graph into a tree!\n");
       return 0;
     }
-
-  noll_ta_t *g2_ta = noll_tree_to_ta (g2_tree);
-  assert (NULL != g2_ta);
-  noll_tree_free (g2_tree);
 #ifndef NDEBUG
   if (noll_option_is_diag())
   {
@@ -1274,7 +1651,8 @@ noll_shom_check_TA (noll_graph_t * g2, noll_edge_t * e1, noll_uid_array * h)
   }
 #endif
 
-  bool inclRes = vata_check_inclusion (g2_ta, e1_ta);
+  bool inclRes = vata_check_inclusion (g2_ta, e1_ta,
+                                       (vata_incl_e) noll_option_get_incl ());
   vata_free_ta (g2_ta);
   vata_free_ta (e1_ta);
 
@@ -1313,7 +1691,7 @@ noll_shom_match_form_pure (noll_graph_t * g2, noll_pure_t * fpure,
   assert (noll_vector_size (exvars) == noll_vector_size (m));
 
   /// more checks: the pure part is not empty
-  assert (fpure->m != NULL);
+  assert (fpure->size > 0);
 
 #ifndef NDEBUG
   if (noll_option_is_diag())
@@ -1401,8 +1779,7 @@ noll_shom_match_form_pto (noll_graph_t * g2, uid_t eid1,
                 noll_vector_size (m));
   }
 #endif
-  noll_uid_array *edges_nsrc = g2->mat[nsrc];
-  if (edges_nsrc == NULL)
+  if (noll_graph_out_size (g2, nsrc) == 0)
     {
 #ifndef NDEBUG
       if (noll_option_is_diag())
@@ -1421,9 +1798,9 @@ noll_shom_match_form_pto (noll_graph_t * g2, uid_t eid1,
       // search the edge from nsrc with label fid
       bool found = false;
       for (uint i2 = 0;
-           i2 < noll_vector_size (edges_nsrc) && (found == false); i2++)
+           i2 < noll_graph_out_size (g2, nsrc) && (found == false); i2++)
         {
-          uid_t eid2 = noll_vector_at (edges_nsrc, i2);
+          uid_t eid2 = noll_graph_out_at (g2, nsrc, i2);
           noll_edge_t *ei2 = noll_vector_at (g2->edges, eid2);
           if ((ei2->kind == NOLL_EDGE_PTO) &&
               (ei2->label == fid) &&
@@ -2034,8 +2411,7 @@ noll_shom_match_lemma (noll_graph_t * g2, uid_t eid1,
    *         i.e., the edge starting from m[args[0]] has a predicate
    */
   uint_t nE = noll_vector_at (m, noll_vector_at (args, 0));
-  noll_uid_array *nE_edges = g2->mat[nE];
-  if ((nE_edges == NULL) || (noll_vector_size (nE_edges) > 1))
+  if (noll_graph_out_size (g2, nE) != 1)
     {                           /// no edge or more than one edge, i.e., a pto
 #ifndef NDEBUG
       if (noll_option_is_diag())
@@ -2047,9 +2423,9 @@ noll_shom_match_lemma (noll_graph_t * g2, uid_t eid1,
 #endif
       return NULL;
     }
-  assert (noll_vector_size (nE_edges) == 1);
+  assert (noll_graph_out_size (g2, nE) == 1);
   /// that is a predicate edge
-  uid_t eidE = noll_vector_at (nE_edges, 0);
+  uid_t eidE = noll_graph_out_at (g2, nE, 0);
   noll_edge_t *edgeE = noll_vector_at (g2->edges, eidE);
   if (edgeE == NULL || edgeE->kind != NOLL_EDGE_PRED)
     {
@@ -2389,7 +2765,7 @@ noll_shom_match_rd (noll_graph_t * g2, uid_t eid1,
   /// From root starts an edge, match it exactly or using a lemma
   /**
    * Step 2: search the edge labeled by @p pid in g2
-   *         at g2->mat[args2[0]]
+   *         from g2 node args2[0]
    */
 #ifndef NDEBUG
   if (noll_option_is_diag())
@@ -2398,7 +2774,8 @@ noll_shom_match_rd (noll_graph_t * g2, uid_t eid1,
   }
 #endif
   /// apply to @p args the maping @p m to obtain the edge constraints
-  noll_uid_array *args2 = noll_uid_array_new ();
+  noll_uid_inline_array args2_buf;
+  noll_uid_array *args2 = noll_uid_inline_array_init (&args2_buf);
   noll_uid_array_reserve (args2, noll_vector_size (args));
   for (uint i = 0; i < noll_vector_size (args); i++)
     noll_uid_array_push (args2, noll_vector_at (m, noll_vector_at (args, i)));
@@ -2418,7 +2795,7 @@ noll_shom_match_rd (noll_graph_t * g2, uid_t eid1,
               if (noll_vector_at (m, ev) == UNDEFINED_ID)
                 noll_uid_array_set (m, ev, noll_vector_at (args2, i));
             }
-          noll_uid_array_delete (args2);
+          noll_uid_inline_array_fini (&args2_buf);
 
           /// update data constraints
           noll_dform_array_cup_all (df, dfnew);
@@ -2443,12 +2820,12 @@ noll_shom_match_rd (noll_graph_t * g2, uid_t eid1,
             NOLL_DEBUG ("\nMatched an already matched atom: fails!\n");
           }
 #endif
-          noll_uid_array_delete (args2);
+          noll_uid_inline_array_fini (&args2_buf);
           noll_dform_array_delete (dfnew);
           return NULL;
         }
     }
-  noll_uid_array_delete (args2);
+  noll_uid_inline_array_fini (&args2_buf);
 
   /**
    * Step 4: test the lemmas of P.
@@ -2597,7 +2974,8 @@ noll_shom_check_syn (noll_graph_t * g2,
   for (uint i = 0; i < noll_vector_size (g2->lvars); i++)
     noll_uid_array_push (m, g2->var2node[i]);
   /// args will give the position of pred args in exvars
-  noll_uid_array *args = noll_uid_array_new ();
+  noll_uid_inline_array args_buf;
+  noll_uid_array *args = noll_uid_inline_array_init (&args_buf);
   noll_uid_array_reserve (args, p->def->fargs);
   for (uint i = 0; i < p->def->fargs; i++)
     {
@@ -2692,7 +3070,16 @@ noll_shom_check_syn (noll_graph_t * g2,
     noll_dform_array_fprint (stdout, exvars, df);
   }
 #endif
-  res = noll_dform_array_check_entl (g2->lvars, g2->data, exvars, mg2, df);
+  /// the variables of g2 not in the positive formula occur only in the rhs
+  uint_t nlhs = noll_vector_size (g2->lvars);
+  if ((noll_prob->pform != NULL) && (noll_prob->pform->lvars != NULL)
+      && (noll_vector_size (noll_prob->pform->lvars) > nlhs))
+    nlhs = noll_vector_size (noll_prob->pform->lvars);
+  bool *lhs = (bool *) calloc (nlhs + 1, sizeof (bool));
+  noll_form_mark_vars (noll_prob->pform, lhs);
+  res = noll_dform_array_check_entl (g2->lvars, g2->data, exvars, mg2, df,
+                                     lhs);
+  free (lhs);
   noll_dform_array_delete (df);
   noll_uid_array_delete (mg2);
 
@@ -2706,6 +3093,7 @@ shom_check_syn_return:
     noll_var_array_delete (exvars);
   if (m != NULL)
     noll_uid_array_delete (m);
+  noll_uid_inline_array_fini (&args_buf);
 
   return res;
 }
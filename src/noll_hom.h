@@ -95,6 +95,10 @@ void noll_uid_map_fprint (FILE * f, noll_uid_map * h);
 /* Solver */
 /* ====================================================================== */
 
+void noll_shom_cache_free (void);
+/* Free the results of the checks of simple homomorphisms kept
+ * across queries. Called when the predicates are changed. */
+
 int noll_hom_build (void);
 /* Search a homeomorphism to prove noll_prob 
  * from prob->ngraph to noll_prob->pgraph. */
@@ -57,6 +57,44 @@ noll_lemma_init (void)
     }
 }
 
+/**
+ * @brief Frees the global array of lemma, before the predicates are reset.
+ *
+ * The lemmas share the variables of the predicate definitions,
+ * only the arrays of variables are freed.
+ */
+void
+noll_lemma_free (void)
+{
+  if (lemma_array == NULL)
+    return;
+
+  assert (preds_array != NULL);
+  for (uint_t pid = 0; pid < noll_vector_size (preds_array); pid++)
+    {
+      noll_lemma_array *lemma_pid = lemma_array[pid];
+      if (lemma_pid == NULL)
+        continue;
+      for (uint_t i = 0; i < noll_vector_size (lemma_pid); i++)
+        {
+          noll_lemma_t *lem = noll_vector_at (lemma_pid, i);
+          noll_var_array_delete (lem->rule.vars);
+          if (lem->rule.pure != NULL)
+            noll_pure_free (lem->rule.pure);
+          if (lem->rule.pto != NULL)
+            noll_space_free (lem->rule.pto);
+          if (lem->rule.nst != NULL)
+            noll_space_free (lem->rule.nst);
+          if (lem->rule.rec != NULL)
+            noll_space_free (lem->rule.rec);
+          free (lem);
+        }
+      noll_lemma_array_delete (lemma_pid);
+    }
+  free (lemma_array);
+  lemma_array = NULL;
+}
+
 /* ====================================================================== */
 /* Constructors/Destructors */
 /* ====================================================================== */
@@ -75,6 +75,9 @@ extern "C"
   void noll_lemma_init (void);
   /* Initialize the global arrays of lemmas, after the initialization of predicates */
 
+  void noll_lemma_free (void);
+  /* Free the global arrays of lemmas, before the predicates are reset */
+
   noll_lemma_array *noll_lemma_init_pred (uid_t pid);
   /* Initialize the global arrays of lemmas for entry @p pid */
 
@@ -40,25 +40,11 @@ noll_normalize_incr (noll_sat_t * fsat)
     /* nothing to do */
     return;
 
-  if (fsat->file != NULL)
-    fclose (fsat->file);
-
-  size_t fname_len = strlen (fsat->fname);
-
-  /*
-   * Initialize file including the list of (in)equalities queried
-   */
-  char *fname_inc = (char *) malloc ((fname_len + 20) * sizeof (char));
-  memset (fname_inc, 0, (fname_len + 20) * sizeof (char));
-  sprintf (fname_inc, "inc_%s", fsat->fname);
-  FILE *finc = fopen (fname_inc, "w");
-
   /*
    * Iterate over unknown (in)equalities between used variables and
-   *  - generate atomic formula to recover the result
-   *  - print the query in the finc
+   *  - query the solver on the boolean abstraction
+   *  - add the implied (in)equality to the formula
    */
-  noll_sat_pure_array *atoms = noll_sat_pure_array_new ();
   for (uint_t i = 0; i < noll_vector_size (fsat->form->lvars); i++)
     if (fsat->finfo->used_lvar[i] == true)
       {
@@ -73,187 +59,68 @@ noll_normalize_incr (noll_sat_t * fsat)
               }
 #endif
               if (noll_pure_matrix_at (fsat->form->pure, i, j)
-                  == NOLL_PURE_OTHER)
+                  != NOLL_PURE_OTHER)
+                continue;
+              // not known (in)equality
+              // check first their types
+              uint_t type_i = noll_var_record (fsat->form->lvars, i);
+              uint_t type_j = noll_var_record (fsat->form->lvars, j);
+              assert (type_i != UNDEFINED_ID);
+              assert (type_j != UNDEFINED_ID);
+              if ((type_i != NOLL_TYP_VOID) &&
+                  (type_j != NOLL_TYP_VOID) && (type_i != type_j))
                 {
-                  // not known (in)equality
-                  // check first their types
-                  uint_t type_i = noll_var_record (fsat->form->lvars, i);
-                  uint_t type_j = noll_var_record (fsat->form->lvars, j);
-                  assert (type_i != UNDEFINED_ID);
-                  assert (type_j != UNDEFINED_ID);
-                  if ((type_i != NOLL_TYP_VOID) &&
-                      (type_j != NOLL_TYP_VOID) && (type_i != type_j))
-                    {
-                      //variables of different types
-                      noll_pure_matrix_at (fsat->form->pure, i, j) =
-                        NOLL_PURE_NEQ;
-                    }
-                  else
-                    {
-                      //variables of the same type or void
-#ifndef NDEBUG
-                      if (noll_option_is_diag())
-                      {
-                        fprintf (stdout, "**************TESTING %s and %s\n",
-                                 noll_vector_at (fsat->form->lvars, i)->vname,
-                                 noll_vector_at (fsat->form->lvars, j)->vname);
-                        fflush (stdout);
-                      }
-#endif
-
-                      uid_t bvar_eq_i_j = noll2sat_get_bvar_eq (fsat, i,
-                                                                j);
-                      assert (bvar_eq_i_j != 0);
-                      // Encode equality
-                      fprintf (finc, "a -%d 0\n", bvar_eq_i_j);
-                      // Encode inequality
-                      fprintf (finc, "a %d 0\n", bvar_eq_i_j);
-
-                      // add atom tested
-                      noll_sat_pure_t *atom_eq =
-                        (noll_sat_pure_t *) malloc (sizeof (noll_sat_pure_t));
-                      atom_eq->op = NOLL_PURE_OTHER;
-                      atom_eq->x = i;
-                      atom_eq->y = j;
-                      noll_sat_pure_array_push (atoms, atom_eq);
-                    }
+                  //variables of different types
+                  noll_pure_matrix_set (fsat->form->pure, i, j,
+                                        NOLL_PURE_NEQ);
+                  continue;
                 }
-            }
-      }
-  fclose (finc);
-  free (fname_inc);
-
-  // print prefix for minisat file
-  char *fname_pre = (char *) malloc ((fname_len + 5) * sizeof (char));
-  memset (fname_pre, 0, (fname_len + 5) * sizeof (char));
-  sprintf (fname_pre, "pre_%s", fsat->fname);
-  FILE *out = fopen (fname_pre, "w");
-  fprintf (out, "p inccnf\n");
-  fclose (out);
-  free (fname_pre);
-
-  // build the final file for sat using cat
-  char *command = (char *) calloc ((100 + 4 * fname_len), sizeof (char));
-  memset (command, 0, (100 + 4 * fname_len) * sizeof (char));
-  sprintf (command,
-           "cat pre_%s %s inc_%s 1> full_%s", fsat->fname, fsat->fname,
-           fsat->fname, fsat->fname);
-  if (system (command) == -1)
-    assert (0);
-
-  // print the minisat command
-  memset (command, 0, (100 + 4 * fname_len) * sizeof (char));
-  sprintf (command,
-           "minisat_inc -verb=0 full_%s results_%s 1> /dev/null", fsat->fname,
-           fsat->fname);
-  if (system (command) == -1)
-    assert (0);
-  free (command);
-
-  // read the result
-  char *fname_res = (char *) malloc ((fname_len + 20) * sizeof (char));
-  memset (fname_res, 0, (fname_len + 20) * sizeof (char));
-  sprintf (fname_res, "results_%s", fsat->fname);
-  FILE *fres = fopen (fname_res, "r");
-  char *res = NULL;
-  size_t lres = 0;
-
-  for (uint_t k = 0; k < noll_vector_size (atoms); k++)
-    {
-      noll_sat_pure_t *atom = noll_vector_at (atoms, k);
-      if (getline (&res, &lres, fres) != -1)
-        {
-          if (strncmp (res, "UNSAT", 5) == 0)
-            {
+              //variables of the same type or void
 #ifndef NDEBUG
               if (noll_option_is_diag())
               {
-                fprintf (stdout, "New eq between %s and %s\n",
-                         noll_var_name (fsat->form->lvars, atom->x,
-                                        NOLL_TYP_RECORD),
-                         noll_var_name (fsat->form->lvars, atom->y,
-                                        NOLL_TYP_RECORD));
-              }
-#endif
-              noll_form_add_eq (fsat->form, atom->x, atom->y);
-              if (fsat->form->kind == NOLL_FORM_UNSAT)
-                goto return_norm_incr;
-            }
-          else
-            {
-#ifndef NDEBUG
-              if (noll_option_is_diag())
-              {
-                fprintf (stdout, "Testing eq between %s and %s gives %s\n",
-                         noll_var_name (fsat->form->lvars, atom->x,
-                                        NOLL_TYP_RECORD),
-                         noll_var_name (fsat->form->lvars, atom->y,
-                                        NOLL_TYP_RECORD), res);
+                fprintf (stdout, "**************TESTING %s and %s\n",
+                         noll_vector_at (fsat->form->lvars, i)->vname,
+                         noll_vector_at (fsat->form->lvars, j)->vname);
+                fflush (stdout);
               }
 #endif
-            }
-        }
-      else
-        {
-#ifndef NDEBUG
-          if (noll_option_is_diag())
-          {
-            fprintf (stdout, "---- inc: Passed\n");
-          }
-#endif
-          continue;
-        }
-
-      // second line for inequality query
-      if (getline (&res, &lres, fres) != -1)
-        {
-          if (strncmp (res, "UNSAT", 5) == 0)
-            {
+              // test entailment of equality
+              if (noll2sat_is_eq (fsat, i, j, NOLL_PURE_EQ) == 1)
+                {
 #ifndef NDEBUG
-              if (noll_option_is_diag())
-              {
-                fprintf (stdout, "New ineq between %s and %s\n",
-                         noll_var_name (fsat->form->lvars, atom->x,
-                                        NOLL_TYP_RECORD),
-                         noll_var_name (fsat->form->lvars, atom->y,
-                                        NOLL_TYP_RECORD));
-              }
+                  if (noll_option_is_diag())
+                  {
+                    fprintf (stdout, "New eq between %s and %s\n",
+                             noll_var_name (fsat->form->lvars, i,
+                                            NOLL_TYP_RECORD),
+                             noll_var_name (fsat->form->lvars, j,
+                                            NOLL_TYP_RECORD));
+                  }
 #endif
-              noll_form_add_neq (fsat->form, atom->x, atom->y);
-              if (fsat->form->kind == NOLL_FORM_UNSAT)
-                goto return_norm_incr;
-            }
-          else
-            {
+                  noll_form_add_eq (fsat->form, i, j);
+                  if (fsat->form->kind == NOLL_FORM_UNSAT)
+                    return;
+                }
+              // test entailment of inequality
+              else if (noll2sat_is_eq (fsat, i, j, NOLL_PURE_NEQ) == 1)
+                {
 #ifndef NDEBUG
-              if (noll_option_is_diag())
-              {
-                fprintf (stdout, "Testing ineq between %s and %s gives %s\n",
-                         noll_var_name (fsat->form->lvars, atom->x,
-                                        NOLL_TYP_RECORD),
-                         noll_var_name (fsat->form->lvars, atom->y,
-                                        NOLL_TYP_RECORD), res);
-              }
+                  if (noll_option_is_diag())
+                  {
+                    fprintf (stdout, "New ineq between %s and %s\n",
+                             noll_var_name (fsat->form->lvars, i,
+                                            NOLL_TYP_RECORD),
+                             noll_var_name (fsat->form->lvars, j,
+                                            NOLL_TYP_RECORD));
+                  }
 #endif
+                  noll_form_add_neq (fsat->form, i, j);
+                  if (fsat->form->kind == NOLL_FORM_UNSAT)
+                    return;
+                }
             }
-        }
-      else
-        {
-#ifndef NDEBUG
-          if (noll_option_is_diag())
-          {
-            fprintf (stdout, "---- inc: Passed\n");
-          }
-#endif
-          continue;
-        }
-    }
-return_norm_incr:
-  if (res != NULL)
-    free (res);
-  free (fname_res);
-  fclose (fres);
-  noll_sat_pure_array_delete (atoms);
+      }
 }
 
 /**
@@ -269,22 +136,19 @@ noll_normalize_iter (noll_sat_t * fsat)
   assert (fsat->fname != NULL);
   assert (fsat->var_pure != NULL);
 
-  if (fsat->file != NULL)
-    fclose (fsat->file);
-
   if (fsat->form->kind == NOLL_FORM_UNSAT)
     /* nothing to do */
     return;
 
   /*
    * Iterate over unknown (in)equalities between used variables and
-   *  - generate a problem for minisat
+   *  - query the solver on the boolean abstraction
    *  - fill the result inside the pure formula
    */
   for (uint_t i = 0; i < noll_vector_size (fsat->form->lvars); i++)
     if (fsat->finfo->used_lvar[i] == true)
       {
-        for (uint_t j = i + 1; j < noll_vector_size (fsat->form->lvars); i++)
+        for (uint_t j = i + 1; j < noll_vector_size (fsat->form->lvars); j++)
           if (fsat->finfo->used_lvar[j] == true)
             {
 #ifndef NDEBUG
@@ -307,8 +171,8 @@ noll_normalize_iter (noll_sat_t * fsat)
                       (type_j != NOLL_TYP_VOID) && (type_i != type_j))
                     {
                       //variables of different types
-                      noll_pure_matrix_at (fsat->form->pure, i, j) =
-                        NOLL_PURE_NEQ;
+                      noll_pure_matrix_set (fsat->form->pure, i, j,
+                                            NOLL_PURE_NEQ);
                     }
                   else
                     {
@@ -336,8 +200,8 @@ noll_normalize_iter (noll_sat_t * fsat)
                                                      j)->vname);
                           }
 #endif
-                          noll_pure_matrix_at (fsat->form->pure, i, j) =
-                            NOLL_PURE_EQ;
+                          noll_pure_matrix_set (fsat->form->pure, i, j,
+                                                NOLL_PURE_EQ);
                         }
 #ifndef NDEBUG
                       else
@@ -364,8 +228,8 @@ noll_normalize_iter (noll_sat_t * fsat)
                                                      j)->vname);
                           }
 #endif
-                          noll_pure_matrix_at (fsat->form->pure, i, j) =
-                            NOLL_PURE_NEQ;
+                          noll_pure_matrix_set (fsat->form->pure, i, j,
+                                                NOLL_PURE_NEQ);
                         }
 #ifndef NDEBUG
                       else
@@ -382,6 +246,166 @@ noll_normalize_iter (noll_sat_t * fsat)
       }
 }
 
+/**
+ * Flags of a pair (i,j) whose (in)equality may still be implied.
+ */
+#define NOLL_NORM_MAY_EQ 1
+#define NOLL_NORM_MAY_NEQ 2
+
+/**
+ * Remove from the flags of pairs the (in)equalities refuted
+ * by the last model found for fsat.
+ */
+static void
+noll_normalize_refute (noll_sat_t * fsat, uid_t * pairs, uint_t size,
+                       unsigned char *flags)
+{
+  for (uint_t k = 0; k < size; k++)
+    {
+      if (flags[k] == 0)
+        continue;
+      int val = noll2sat_model_eq (fsat, pairs[2 * k], pairs[2 * k + 1]);
+      if (val == 1)
+        flags[k] &= ~NOLL_NORM_MAY_NEQ;
+      else if (val == 0)
+        flags[k] &= ~NOLL_NORM_MAY_EQ;
+    }
+}
+
+/**
+ * Test the implied (in)equalities using the models of the
+ * boolean abstraction to avoid queries and update fsat->form
+ */
+void
+noll_normalize_model (noll_sat_t * fsat)
+{
+
+  assert (fsat != NULL);
+  assert (fsat->form != NULL);
+  assert (fsat->fname != NULL);
+  assert (fsat->var_pure != NULL);
+
+  if (fsat->form->kind == NOLL_FORM_UNSAT)
+    /* nothing to do */
+    return;
+
+  /*
+   * Collect the unknown (in)equalities between used variables
+   * of the same type.
+   */
+  uint_t nvars = noll_vector_size (fsat->form->lvars);
+  uint_t size = 0;
+  uid_t *pairs = NULL;
+  unsigned char *flags = NULL;
+  for (uint_t i = 0; i < nvars; i++)
+    if (fsat->finfo->used_lvar[i] == true)
+      for (uint_t j = i + 1; j < nvars; j++)
+        if ((fsat->finfo->used_lvar[j] == true) &&
+            (noll_pure_matrix_at (fsat->form->pure, i, j) ==
+             NOLL_PURE_OTHER))
+          {
+            uint_t type_i = noll_var_record (fsat->form->lvars, i);
+            uint_t type_j = noll_var_record (fsat->form->lvars, j);
+            assert (type_i != UNDEFINED_ID);
+            assert (type_j != UNDEFINED_ID);
+            if ((type_i != NOLL_TYP_VOID) &&
+                (type_j != NOLL_TYP_VOID) && (type_i != type_j))
+              {
+                //variables of different types
+                noll_pure_matrix_set (fsat->form->pure, i, j, NOLL_PURE_NEQ);
+                continue;
+              }
+            if ((size & (size - 1)) == 0)
+              {
+                // size is 0 or a power of 2, double the arrays
+                uint_t cap = (size == 0) ? 8 : 2 * size;
+                pairs = (uid_t *) realloc (pairs, 2 * cap * sizeof (uid_t));
+                flags = (unsigned char *) realloc (flags, cap);
+              }
+            pairs[2 * size] = i;
+            pairs[2 * size + 1] = j;
+            flags[size] = NOLL_NORM_MAY_EQ | NOLL_NORM_MAY_NEQ;
+            size++;
+          }
+
+  if (size == 0)
+    return;
+
+  /*
+   * Start from a model of the abstraction, then query only the
+   * (in)equalities not refuted; each satisfiable query gives a new model.
+   */
+  if (noll2sat_solve (fsat, NULL, 0) == 1)
+    noll_normalize_refute (fsat, pairs, size, flags);
+#ifndef NDEBUG
+  uint_t no_queries = 0;
+#endif
+  for (uint_t k = 0; k < size && fsat->form->kind != NOLL_FORM_UNSAT; k++)
+    {
+      uid_t i = pairs[2 * k];
+      uid_t j = pairs[2 * k + 1];
+      // (in)equality already found by closure
+      if (noll_pure_matrix_at (fsat->form->pure, i, j) != NOLL_PURE_OTHER)
+        continue;
+
+      if (flags[k] & NOLL_NORM_MAY_EQ)
+        {
+#ifndef NDEBUG
+          no_queries++;
+#endif
+          if (noll2sat_is_eq (fsat, i, j, NOLL_PURE_EQ) == 1)
+            {
+#ifndef NDEBUG
+              if (noll_option_is_diag())
+              {
+                fprintf (stdout, "New eq between %s and %s\n",
+                         noll_var_name (fsat->form->lvars, i,
+                                        NOLL_TYP_RECORD),
+                         noll_var_name (fsat->form->lvars, j,
+                                        NOLL_TYP_RECORD));
+              }
+#endif
+              noll_form_add_eq (fsat->form, i, j);
+              continue;
+            }
+          noll_normalize_refute (fsat, pairs, size, flags);
+        }
+
+      if (flags[k] & NOLL_NORM_MAY_NEQ)
+        {
+#ifndef NDEBUG
+          no_queries++;
+#endif
+          if (noll2sat_is_eq (fsat, i, j, NOLL_PURE_NEQ) == 1)
+            {
+#ifndef NDEBUG
+              if (noll_option_is_diag())
+              {
+                fprintf (stdout, "New ineq between %s and %s\n",
+                         noll_var_name (fsat->form->lvars, i,
+                                        NOLL_TYP_RECORD),
+                         noll_var_name (fsat->form->lvars, j,
+                                        NOLL_TYP_RECORD));
+              }
+#endif
+              noll_form_add_neq (fsat->form, i, j);
+              continue;
+            }
+          noll_normalize_refute (fsat, pairs, size, flags);
+        }
+    }
+
+#ifndef NDEBUG
+  if (noll_option_is_diag())
+  {
+    fprintf (stdout, "---- normalization: %d queries for %d pairs\n",
+             no_queries, size);
+  }
+#endif
+  free (pairs);
+  free (flags);
+}
+
 /**
  * If form is satisfiable, normalize it; otherwise do nothing.
  */
@@ -427,7 +451,9 @@ noll_normalize (noll_form_t * form, char *fname, bool incr, bool destructive)
        */
       if (noll_option_get_verb () > 0)
         fprintf (stdout, "      * infer implied (in)equalities ...");
-      if (incr == true)
+      if (noll_option_is_norm_model ())
+        noll_normalize_model (fsat);
+      else if (incr == true)
         noll_normalize_incr (fsat);
       else
         noll_normalize_iter (fsat);
@@ -47,7 +47,8 @@
 noll_sat_t *noll_normalize (noll_form_t * form, char *fname, bool incr,
                             bool destructive);
 /* Updates form to its normal form and
- * put in the file "file" the boolean abstraction;
- * use incremental minisat if incr = true */
+ * returns the boolean abstraction (kept in memory, named "fname");
+ * use incremental queries if incr = true,
+ * use the models of the abstraction if option -m is set */
 
 #endif /* NOLL_NORM_H_ */
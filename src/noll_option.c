@@ -21,6 +21,8 @@
  */
 
 #include "noll_option.h"
+#include <ctype.h>
+#include <stdlib.h>
 #include <string.h>
 
 
@@ -49,6 +51,87 @@ noll_option_is_tosat (int version)
 }
 
 
+/**
+ * Global option for the inference of implied (in)equalities.
+ * false - query each unknown (in)equality (default)
+ * true  - query only (in)equalities not refuted by the models found
+ */
+bool norm_model = false;
+
+void
+noll_option_set_norm_model (bool ismodel)
+{
+  norm_model = ismodel;
+}
+
+bool
+noll_option_is_norm_model (void)
+{
+  return norm_model;
+}
+
+
+/**
+ * Global option for the encoding of separation and determinism.
+ * false - one clause per pair of atoms (default)
+ * true  - auxiliary variables and at-most-one ladders, of linear size
+ *         in the number of atoms
+ */
+bool enc_linear = false;
+
+void
+noll_option_set_enc_linear (bool islinear)
+{
+  enc_linear = islinear;
+}
+
+bool
+noll_option_is_enc_linear (void)
+{
+  return enc_linear;
+}
+
+
+/**
+ * Global option for the clauses of F_det and F(Lambda).
+ * false - loaded in the solver with the other clauses (default)
+ * true  - loaded only when a model found violates them
+ */
+bool enc_lazy = false;
+
+void
+noll_option_set_enc_lazy (bool islazy)
+{
+  enc_lazy = islazy;
+}
+
+bool
+noll_option_is_enc_lazy (void)
+{
+  return enc_lazy;
+}
+
+
+/**
+ * Global option for the solver of the boolean abstraction.
+ * false - clauses loaded as built (default)
+ * true  - clauses simplified once, keeping the variables of the queries
+ */
+bool sat_simp = false;
+
+void
+noll_option_set_sat_simp (bool issimp)
+{
+  sat_simp = issimp;
+}
+
+bool
+noll_option_is_sat_simp (void)
+{
+  return sat_simp;
+}
+
+
 /* ====================================================================== */
 /* Translation of predicates to tree automata. */
 /* ====================================================================== */
@@ -120,6 +203,26 @@ noll_option_get_pred2ta_opt (void)
   return pred2ta_opt;
 }
 
+/**
+ * Global option for the inclusion check of tree automata.
+ * 0 - upward antichains (default)
+ * 1 - downward antichains
+ * 2 - downward antichains pruned by simulation
+ */
+int incl_mode = 0;
+
+void
+noll_option_set_incl (int mode)
+{
+  incl_mode = (mode >= 0 && mode <= 2) ? mode : 0;
+}
+
+int
+noll_option_get_incl (void)
+{
+  return incl_mode;
+}
+
 
 /* ====================================================================== */
 /* Verbosity. */
@@ -155,6 +258,98 @@ noll_option_get_verb (void)
 }
 
 
+/* ====================================================================== */
+/* Running mode. */
+/* ====================================================================== */
+
+/*
+ * false - solve the problem in the file given (default)
+ * true  - solve the stream of problems read from stdin or a socket
+ */
+bool server_mode = false;
+
+void
+noll_option_set_server (bool isserver)
+{
+  server_mode = isserver;
+}
+
+bool
+noll_option_is_server (void)
+{
+  return server_mode;
+}
+
+
+/* ====================================================================== */
+/* Parallelism. */
+/* ====================================================================== */
+
+/*
+ * number of processes used to search the homomorphisms
+ * for the disjuncts of the negative formula (default 1)
+ */
+int jobs = 1;
+
+void
+noll_option_set_jobs (int n)
+{
+  jobs = (n > 1) ? n : 1;
+}
+
+int
+noll_option_get_jobs (void)
+{
+  return jobs;
+}
+
+
+/* ====================================================================== */
+/* Scratch files. */
+/* ====================================================================== */
+
+/*
+ * directory where the private scratch directory is created,
+ * "mem" for files in memory, NULL for the default
+ */
+const char *scratch_dir = NULL;
+
+void
+noll_option_set_scratch (const char *dir)
+{
+  scratch_dir = (dir != NULL && dir[0] != '\0') ? dir : NULL;
+}
+
+const char *
+noll_option_get_scratch (void)
+{
+  return scratch_dir;
+}
+
+
+/* ====================================================================== */
+/* Cache of results. */
+/* ====================================================================== */
+
+/*
+ * directory keeping the results of the problems solved,
+ * NULL for no cache (default)
+ */
+const char *cache_dir = NULL;
+
+void
+noll_option_set_cache (const char *dir)
+{
+  cache_dir = (dir != NULL && dir[0] != '\0') ? dir : NULL;
+}
+
+const char *
+noll_option_get_cache (void)
+{
+  return cache_dir;
+}
+
+
 /* ====================================================================== */
 /* Set/Print. */
 /* ====================================================================== */
@@ -167,6 +362,11 @@ noll_option_set (char *option)
       noll_option_set_preds (true);     /* NYI: builtin predicates */
       return 1;
     }
+  if ((strncmp (option, "-C", 2) == 0) && (option[2] != '\0'))
+    {
+      noll_option_set_cache (option + 2);       /* cache of results */
+      return 1;
+    }
   if (strcmp (option, "-d") == 0)
     {
       noll_option_set_diag ();  /* set diagnosis */
@@ -177,6 +377,41 @@ noll_option_set (char *option)
       noll_option_set_tosat (0);        /* use old version of boolean abstraction */
       return 1;
     }
+  if ((strncmp (option, "-i", 2) == 0) && isdigit (option[2]))
+    {
+      noll_option_set_incl (atoi (option + 2)); /* inclusion algorithm */
+      return 1;
+    }
+  if ((strncmp (option, "-j", 2) == 0) && isdigit (option[2]))
+    {
+      noll_option_set_jobs (atoi (option + 2)); /* parallel normalization and search of hom */
+      return 1;
+    }
+  if (strcmp (option, "-l") == 0)
+    {
+      noll_option_set_enc_linear (true);        /* linear-size encodings */
+      return 1;
+    }
+  if (strcmp (option, "-lazy") == 0)
+    {
+      noll_option_set_enc_lazy (true);  /* add F_det and F(Lambda) on demand */
+      return 1;
+    }
+  if (strcmp (option, "-m") == 0)
+    {
+      noll_option_set_norm_model (true);        /* use models to normalize */
+      return 1;
+    }
+  if (strcmp (option, "-s") == 0)
+    {
+      noll_option_set_server (true);    /* read a stream of problems */
+      return 1;
+    }
+  if (strcmp (option, "-simp") == 0)
+    {
+      noll_option_set_sat_simp (true);  /* preprocess the abstraction */
+      return 1;
+    }
   if (strcmp (option, "-sll") == 0)
     {
       noll_option_set_check (0);        /* special check for sll edges */
@@ -199,6 +434,11 @@ noll_option_set (char *option)
       noll_option_set_pred2ta_opt (1);
       return 1;
     }
+  if ((strncmp (option, "-T", 2) == 0) && (option[2] != '\0'))
+    {
+      noll_option_set_scratch (option + 2);     /* location of scratch files */
+      return 1;
+    }
   if (strcmp (option, "-v") == 0)
     {
       noll_option_set_verb (1); /* verbosity level */
@@ -220,12 +460,29 @@ noll_option_print (FILE * f)
   fprintf (f, "Options:\n");
   fprintf (f,
            "  -b     use predefined recursive definitions (set from name)\n");
+  fprintf (f,
+           "  -Cdir  keep the results of the problems in dir across runs\n");
   fprintf (f, "  -d     print diagnosis messages\n");
+  fprintf (f,
+           "  -iN    TA inclusion: 0 upward, 1 downward, 2 downward with simulation\n");
+  fprintf (f,
+           "  -jN    normalize and search the homomorphisms with N parallel processes\n");
+  fprintf (f,
+           "  -l     use linear-size encodings of separation and determinism\n");
+  fprintf (f,
+           "  -lazy  add determinism and sharing clauses when models violate them\n");
+  fprintf (f, "  -m     use SAT models to prune normalisation queries\n");
   fprintf (f, "  -n     internal switch to old normalisation procedure\n");
   fprintf (f, "  -o     combines -sll and -ta\n");
+  fprintf (f,
+           "  -s     solve a stream of problems (from stdin or the socket file)\n");
+  fprintf (f,
+           "  -simp  simplify the boolean abstraction before the queries\n");
   fprintf (f, "  -sll   use special procedure for sll predicates\n");
   fprintf (f, "  -syn   use procedure based on unfolding and lemma\n");
   fprintf (f, "  -ta    use procedure based on tree automata\n");
+  fprintf (f,
+           "  -Tdir  put the scratch files in dir (-Tmem: in memory)\n");
   fprintf (f, "  -v     verbose messages\n");
 
 }
@@ -42,6 +42,57 @@ void noll_option_set_tosat (int version);
  */
 bool noll_option_is_tosat (int version);
 
+/**
+ * @brief Select the model-guided inference of implied (in)equalities.
+ *
+ * Default is false (i.e., query each unknown (in)equality).
+ */
+void noll_option_set_norm_model (bool ismodel);
+
+/**
+ * @brief True if the models found prune the normalization queries.
+ */
+bool noll_option_is_norm_model (void);
+
+/**
+ * @brief Select the linear-size encodings of separation and determinism
+ *        in the boolean abstraction.
+ *
+ * Default is false (i.e., one clause per pair of atoms).
+ */
+void noll_option_set_enc_linear (bool islinear);
+
+/**
+ * @brief True if the linear-size encodings are used.
+ */
+bool noll_option_is_enc_linear (void);
+
+/**
+ * @brief Select the lazy generation of the determinism and sharing clauses
+ *        in the solver of the boolean abstraction.
+ *
+ * Default is false (i.e., all clauses are loaded in the solver).
+ */
+void noll_option_set_enc_lazy (bool islazy);
+
+/**
+ * @brief True if the determinism and sharing clauses are added on demand.
+ */
+bool noll_option_is_enc_lazy (void);
+
+/**
+ * @brief Select the preprocessing (subsumption, variable elimination)
+ *        of the boolean abstraction before the normalization queries.
+ *
+ * Default is false (i.e., the clauses are loaded as built).
+ */
+void noll_option_set_sat_simp (bool issimp);
+
+/**
+ * @brief True if the boolean abstraction is preprocessed.
+ */
+bool noll_option_is_sat_simp (void);
+
 /**
  * @brief Select builtin definition of tree automata for predicate defs.
  *
@@ -101,6 +152,21 @@ void noll_option_set_pred2ta_opt (int lelev);
  */
 int noll_option_get_pred2ta_opt (void);
 
+/**
+ * @brief Select the algorithm checking inclusion of tree automata.
+ *
+ * Default is 0 (i.e., upward antichains).
+ * Other algorithms are:
+ *   - 1: downward antichains
+ *   - 2: downward antichains using simulation
+ */
+void noll_option_set_incl (int mode);
+
+/**
+ * @brief Algorithm checking inclusion of tree automata.
+ */
+int noll_option_get_incl (void);
+
 
 /**
  * @brief Trigger verbosity level.
@@ -127,6 +193,57 @@ void noll_option_set_diag (void);
  */
 bool noll_option_is_diag (void);
 
+/**
+ * @brief Select the server mode, solving a stream of problems.
+ *
+ * Default is false (i.e., solve the problem in the file given).
+ */
+void noll_option_set_server (bool isserver);
+
+/**
+ * @brief True if a stream of problems is solved.
+ */
+bool noll_option_is_server (void);
+
+/**
+ * @brief Set the number of processes searching homomorphisms
+ * and normalizing the formulae.
+ *
+ * Default is 1 (i.e., sequential search).
+ */
+void noll_option_set_jobs (int n);
+
+/**
+ * @brief Number of processes searching homomorphisms
+ * and normalizing the formulae.
+ */
+int noll_option_get_jobs (void);
+
+/**
+ * @brief Set the location of the scratch files.
+ *
+ * Default is NULL (i.e., tmpfs if available, otherwise $TMPDIR or /tmp).
+ * The value "mem" selects files in memory (memfd).
+ */
+void noll_option_set_scratch (const char *dir);
+
+/**
+ * @brief Location of the scratch files, NULL for the default.
+ */
+const char *noll_option_get_scratch (void);
+
+/**
+ * @brief Set the directory keeping the results of problems across runs.
+ *
+ * Default is NULL (i.e., no cache of results).
+ */
+void noll_option_set_cache (const char *dir);
+
+/**
+ * @brief Directory of the cache of results, NULL if none.
+ */
+const char *noll_option_get_cache (void);
+
 /**
  * @brief Set option using the input string of the form '-'optioncode.
  */
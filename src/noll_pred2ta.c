@@ -52,6 +52,46 @@ noll_pred2graph_init ()
   noll_graph_array_resize (pred2graph_array, noll_vector_size (preds_array));
 }
 
+/**
+ * Entry of the cache of TA built for predicate edges.
+ * The TA of an edge depends only on its predicate and its arguments,
+ * so it is obtained from the TA of an edge with the same predicate
+ * and the same signature (the roles of arguments: null or equal to
+ * a previous argument) by renaming the arguments in its symbols.
+ */
+typedef struct noll_edge2ta_cache_s
+{
+  const noll_pred_t *pred;      /* predicate of the edge */
+  noll_uid_array *args;         /* arguments of the edge translated */
+  noll_uid_array *sign;         /* signature of args */
+  noll_ta_t *ta;                /* TA built for the edge */
+} noll_edge2ta_cache_t;
+
+NOLL_VECTOR_DECLARE (noll_edge2ta_cache_array, noll_edge2ta_cache_t *);
+NOLL_VECTOR_DEFINE (noll_edge2ta_cache_array, noll_edge2ta_cache_t *);
+
+static noll_edge2ta_cache_array *edge2ta_cache = NULL;
+
+/* renaming of variables used by noll_edge2ta_cache_rename */
+static noll_uid_array *edge2ta_cache_vmap = NULL;
+
+void
+noll_edge2ta_cache_free ()
+{
+  if (edge2ta_cache == NULL)
+    return;
+  for (uint_t i = 0; i < noll_vector_size (edge2ta_cache); i++)
+    {
+      noll_edge2ta_cache_t *entry = noll_vector_at (edge2ta_cache, i);
+      noll_uid_array_delete (entry->args);
+      noll_uid_array_delete (entry->sign);
+      vata_free_ta (entry->ta);
+      free (entry);
+    }
+  noll_edge2ta_cache_array_delete (edge2ta_cache);
+  edge2ta_cache = NULL;
+}
+
 /* ====================================================================== */
 /* Markings */
 /* ====================================================================== */
@@ -2593,6 +2633,146 @@ noll_pred2ta_skl (noll_ta_t * ta,
 
 
 
+/**
+ * Compute the signature of the arguments @p args of a predicate edge:
+ * the i-th entry is UNDEFINED_ID if args[i] is null, otherwise
+ * the first position j <= i such that args[j] = args[i].
+ */
+static noll_uid_array *
+noll_edge2ta_cache_sign (const noll_uid_array * args)
+{
+  noll_uid_array *sign = noll_uid_array_new ();
+  noll_uid_array_reserve (sign, noll_vector_size (args));
+  for (uint_t i = 0; i < noll_vector_size (args); i++)
+    {
+      uid_t ai = noll_vector_at (args, i);
+      uid_t si = i;
+      if (ai == 0)
+        si = UNDEFINED_ID;
+      else
+        for (uint_t j = 0; j < i; j++)
+          if (noll_vector_at (args, j) == ai)
+            {
+              si = j;
+              break;
+            }
+      noll_uid_array_push (sign, si);
+    }
+  return sign;
+}
+
+/**
+ * Translation of symbols used to instantiate a cached TA.
+ */
+static const noll_ta_symbol_t *
+noll_edge2ta_cache_rename (const noll_ta_symbol_t * sym)
+{
+  assert (NULL != edge2ta_cache_vmap);
+  return noll_ta_symbol_get_unique_renamed_vars (sym, edge2ta_cache_vmap);
+}
+
+/**
+ * Get from the cache the TA for @p edge.
+ *
+ * @param edge    A predicate edge
+ * @return        A new TA or NULL if no TA is cached for the predicate
+ *                and the signature of @p edge
+ */
+static noll_ta_t *
+noll_edge2ta_cache_get (const noll_edge_t * edge)
+{
+  if (edge2ta_cache == NULL)
+    return NULL;
+
+  const noll_pred_t *pred = noll_pred_getpred (edge->label);
+  noll_uid_array *sign = noll_edge2ta_cache_sign (edge->args);
+  noll_edge2ta_cache_t *entry = NULL;
+  for (uint_t i = 0; i < noll_vector_size (edge2ta_cache); i++)
+    {
+      noll_edge2ta_cache_t *ei = noll_vector_at (edge2ta_cache, i);
+      if ((ei->pred == pred) && noll_uid_array_equal (ei->sign, sign))
+        {
+          entry = ei;
+          break;
+        }
+    }
+  noll_uid_array_delete (sign);
+  if (entry == NULL)
+    return NULL;
+
+  noll_ta_t *ta = vata_copy_ta (entry->ta);
+  if (noll_uid_array_equal (entry->args, edge->args))
+    return ta;
+
+  /* rename the arguments of the cached edge into the arguments of edge;
+   * the renaming is completed into a permutation of the variables such that
+   * the other variables of the TA (e.g., in nested symbols) are not
+   * captured by the arguments of edge */
+  uid_t max = 0;
+  for (uint_t i = 0; i < noll_vector_size (entry->args); i++)
+    {
+      if (noll_vector_at (entry->args, i) > max)
+        max = noll_vector_at (entry->args, i);
+      if (noll_vector_at (edge->args, i) > max)
+        max = noll_vector_at (edge->args, i);
+    }
+  edge2ta_cache_vmap = noll_uid_array_new ();
+  noll_uid_array_reserve (edge2ta_cache_vmap, max + 1);
+  for (uid_t v = 0; v <= max; v++)
+    noll_uid_array_push (edge2ta_cache_vmap, UNDEFINED_ID);
+  bool *used = (bool *) calloc (max + 1, sizeof (bool));
+  for (uint_t i = 0; i < noll_vector_size (entry->args); i++)
+    {
+      /* same signature, thus the map is a function and injective */
+      noll_uid_array_set (edge2ta_cache_vmap, noll_vector_at (entry->args, i),
+                          noll_vector_at (edge->args, i));
+      used[noll_vector_at (edge->args, i)] = true;
+    }
+  /* the other variables are unchanged if not captured ... */
+  for (uid_t v = 0; v <= max; v++)
+    if ((noll_vector_at (edge2ta_cache_vmap, v) == UNDEFINED_ID) && !used[v])
+      {
+        noll_uid_array_set (edge2ta_cache_vmap, v, v);
+        used[v] = true;
+      }
+  /* ... otherwise they take the ids of the arguments of the cached edge
+   * left free by the renaming above */
+  uid_t free_id = 0;
+  for (uid_t v = 0; v <= max; v++)
+    if (noll_vector_at (edge2ta_cache_vmap, v) == UNDEFINED_ID)
+      {
+        while (used[free_id])
+          free_id++;
+        noll_uid_array_set (edge2ta_cache_vmap, v, free_id);
+        used[free_id] = true;
+      }
+  free (used);
+  vata_translate_symbols (ta, noll_edge2ta_cache_rename);
+  noll_uid_array_delete (edge2ta_cache_vmap);
+  edge2ta_cache_vmap = NULL;
+
+  return ta;
+}
+
+/**
+ * Put in the cache a copy of the TA @p ta built for @p edge.
+ */
+static void
+noll_edge2ta_cache_put (const noll_edge_t * edge, const noll_ta_t * ta)
+{
+  if (edge2ta_cache == NULL)
+    edge2ta_cache = noll_edge2ta_cache_array_new ();
+
+  noll_edge2ta_cache_t *entry =
+    (noll_edge2ta_cache_t *) malloc (sizeof (noll_edge2ta_cache_t));
+  entry->pred = noll_pred_getpred (edge->label);
+  entry->args = noll_uid_array_new ();
+  noll_uid_array_copy (entry->args, edge->args);
+  entry->sign = noll_edge2ta_cache_sign (edge->args);
+  entry->ta = vata_copy_ta (ta);
+  noll_edge2ta_cache_array_push (edge2ta_cache, entry);
+}
+
 /**
  * Get the TA for the @p edge.
  *
@@ -2623,10 +2803,15 @@ noll_edge2ta (const noll_edge_t * edge)
       ("********************************************************************************\n");
   }
 
-  vata_ta_t *ta = NULL;
-  if ((ta = vata_create_ta ()) == NULL)
+  /* the TA may be obtained from the one of a similar edge */
+  vata_ta_t *ta = noll_edge2ta_cache_get (edge);
+  if (NULL != ta)
     {
-      return NULL;
+      if (noll_option_is_diag())
+      {
+        NOLL_DEBUG ("TA for edge obtained from the cache\n");
+      }
+      return ta;
     }
 
   if (noll_option_is_diag())
@@ -2723,5 +2908,12 @@ noll_edge2ta (const noll_edge_t * edge)
     NOLL_DEBUG ("*** END EDGE -> TA\n");
   }
 
+  if (NULL != ta)
+    {
+      /* reduced once, the copies from the cache are reduced */
+      vata_reduce_ta (ta);
+      noll_edge2ta_cache_put (edge, ta);
+    }
+
   return ta;
 }
@@ -56,6 +56,9 @@ extern noll_graph_array *pred2graph_array;
 void noll_pred2graph_init (void);
 /* Initialize global arrays of graphs */
 
+void noll_edge2ta_cache_free (void);
+/* Free the cache of TA built for predicate edges */
+
 /* ====================================================================== */
 /* Translators */
 /* ====================================================================== */
@@ -32,10 +32,14 @@ NOLL_VECTOR_DEFINE (noll_pred_array, noll_pred_t *);
 
 noll_pred_array *preds_array;
 
+/* true once the predicates are typed and the fields ordered */
+static bool preds_typed = false;
+
 void
 noll_pred_init ()
 {
   preds_array = noll_pred_array_new ();
+  preds_typed = false;
   noll_pred_array_reserve (preds_array, 4);
 }
 
@@ -400,6 +404,10 @@ noll_pred_type ()
   assert (fields_array != NULL);
   assert (records_array != NULL);
 
+  /* the typing infos are kept for all the problems using these predicates */
+  if (preds_typed == true)
+    return 1;
+
   int res = 1;
   /* go through all predicates starting with the simpler ones */
   for (uint_t pid = 0;
@@ -862,6 +870,8 @@ noll_pred_type_rule (noll_pred_t * p, uint_t level, noll_pred_rule_t * rule)
 int
 noll_field_order ()
 {
+  if (preds_typed == true)
+    return 1;
 
   /* pre-analysis:
    * go through the predicates and
@@ -980,6 +990,7 @@ noll_field_order ()
     }
 #ifndef NDEBUG
 #endif
+  preds_typed = true;
   return 1;
 }
 
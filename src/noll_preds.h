@@ -233,6 +233,7 @@ extern "C"
 
   int noll_pred_type (void);
   /* Type the predicate definitions.
+   * Done once after noll_pred_init, the typing infos are kept.
    */
 
   /**
@@ -246,6 +247,7 @@ extern "C"
 
   int noll_field_order (void);
   /* Order the fields using the predicate order.
+   * Done once after noll_pred_init, the order is kept.
    */
 
   noll_form_t *noll_pred_get_matrix (uid_t pid);
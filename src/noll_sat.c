@@ -22,6 +22,7 @@
 #include "noll_sat.h"
 #include "noll_entl.h"
 #include "noll_option.h"
+#include "noll_scratch.h"
 #include "noll2graph.h"
 
 /* ====================================================================== */
@@ -57,18 +58,17 @@ noll_sat_diag_unsat (noll_form_t * form, noll_sat_t * fsat)
   assert (form == noll_prob->pform);
   assert (form == fsat->form);
 
-  /// file containing the boolean abstraction fsat->file, is closed
-  assert (fsat->file == NULL);
+  /// the boolean abstraction is finished
+  assert (fsat->clauses != NULL);
   FILE *foutput = fopen ((noll_prob->output_fname == NULL) ? "unsat-out.txt" :
                          noll_prob->output_fname, "a");
   assert (foutput != NULL);
 
   /// file with proof is in drup_fname with fname=fsat->fname
   assert (fsat->fname != NULL);
-  char fnameDRUP[1024];
-  fnameDRUP[0] = '\0';
-  sprintf (fnameDRUP, "drup_%s", fsat->fname);
+  char *fnameDRUP = noll_scratch_path ("drup_", fsat->fname);
   FILE *fDRUP = fopen (fnameDRUP, "r");
+  free (fnameDRUP);
   assert (fDRUP != NULL);
   char *line = NULL;
   size_t lineLen = 0;
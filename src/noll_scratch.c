@@ -0,0 +1,212 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Scratch files exchanged with the external solvers.
+ */
+
+#define _GNU_SOURCE             /* memfd_create */
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "noll_option.h"
+#include "noll_scratch.h"
+
+/* ====================================================================== */
+/* Globals */
+/* ====================================================================== */
+
+/* process owning the scratch files, 0 if none */
+static pid_t scratch_pid = 0;
+
+/* private directory of the scratch files, NULL in memory */
+static char *scratch_root = NULL;
+
+/* files in memory: names and descriptors */
+static char **scratch_names = NULL;
+static int *scratch_fds = NULL;
+static size_t scratch_size = 0;
+
+/* ====================================================================== */
+/* Auxiliary functions */
+/* ====================================================================== */
+
+/**
+ * Default location of the scratch directory: tmpfs if available.
+ */
+static const char *
+noll_scratch_default (void)
+{
+  if (access ("/dev/shm", W_OK | X_OK) == 0)
+    return "/dev/shm";
+  const char *tmp = getenv ("TMPDIR");
+  return (tmp != NULL) ? tmp : "/tmp";
+}
+
+/**
+ * Start the scratch space of the current process.
+ * @return true if the files are in memory
+ */
+static bool
+noll_scratch_init (void)
+{
+  static bool registered = false;
+  if (!registered)
+    {
+      atexit (noll_scratch_free);
+      registered = true;
+    }
+  if (scratch_pid != 0)
+    {
+      /* forked process: forget the files of the parent, which
+       * keeps its descriptors and removes its directory */
+      for (size_t i = 0; i < scratch_size; i++)
+        {
+          close (scratch_fds[i]);
+          free (scratch_names[i]);
+        }
+      free (scratch_names);
+      free (scratch_fds);
+      scratch_names = NULL;
+      scratch_fds = NULL;
+      scratch_size = 0;
+      free (scratch_root);
+      scratch_root = NULL;
+    }
+  scratch_pid = getpid ();
+
+  const char *dir = noll_option_get_scratch ();
+#ifdef MFD_CLOEXEC
+  if ((dir != NULL) && (strcmp (dir, "mem") == 0))
+    return true;
+#endif
+  if (dir == NULL || strcmp (dir, "mem") == 0)
+    dir = noll_scratch_default ();
+
+  scratch_root = (char *) malloc (strlen (dir) + 32);
+  sprintf (scratch_root, "%s/spen-%d-XXXXXX", dir, (int) scratch_pid);
+  if (mkdtemp (scratch_root) == NULL)
+    {
+      fprintf (stderr, "Scratch directory in %s not created! quit.\n", dir);
+      exit (1);
+    }
+  return false;
+}
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+char *
+noll_scratch_path (const char *prefix, const char *fname)
+{
+  bool inmem = (scratch_pid == getpid ()) ? (scratch_root == NULL)
+    : noll_scratch_init ();
+
+  /* the name is flat */
+  size_t len = strlen (prefix) + strlen (fname);
+  char *name = (char *) malloc (len + 1);
+  sprintf (name, "%s%s", prefix, fname);
+  for (char *c = name; *c != '\0'; c++)
+    if (*c == '/')
+      *c = '_';
+
+#ifdef MFD_CLOEXEC
+  if (inmem)
+    {
+      /* the external solvers inherit the descriptor */
+      size_t i = 0;
+      while ((i < scratch_size) && (strcmp (scratch_names[i], name) != 0))
+        i++;
+      if (i == scratch_size)
+        {
+          int fd = memfd_create (name, 0);
+          if (fd < 0)
+            {
+              fprintf (stderr, "Scratch file %s not created! quit.\n", name);
+              exit (1);
+            }
+          scratch_names = (char **) realloc (scratch_names,
+                                             (i + 1) * sizeof (char *));
+          scratch_fds = (int *) realloc (scratch_fds, (i + 1) * sizeof (int));
+          scratch_names[i] = name;
+          scratch_fds[i] = fd;
+          scratch_size++;
+        }
+      else
+        free (name);
+      char *path = (char *) malloc (64);
+      sprintf (path, "/proc/%d/fd/%d", (int) scratch_pid, scratch_fds[i]);
+      return path;
+    }
+#else
+  (void) inmem;
+#endif
+
+  char *path = (char *) malloc (strlen (scratch_root) + len + 2);
+  sprintf (path, "%s/%s", scratch_root, name);
+  free (name);
+  return path;
+}
+
+void
+noll_scratch_free (void)
+{
+  /* the processes forked do not own the files */
+  if (scratch_pid != getpid ())
+    return;
+  scratch_pid = 0;
+
+  for (size_t i = 0; i < scratch_size; i++)
+    {
+      close (scratch_fds[i]);
+      free (scratch_names[i]);
+    }
+  free (scratch_names);
+  free (scratch_fds);
+  scratch_names = NULL;
+  scratch_fds = NULL;
+  scratch_size = 0;
+
+  if (scratch_root == NULL)
+    return;
+  DIR *d = opendir (scratch_root);
+  if (d != NULL)
+    {
+      struct dirent *e;
+      while ((e = readdir (d)) != NULL)
+        if (e->d_name[0] != '.')
+          {
+            char *path = (char *) malloc (strlen (scratch_root)
+                                          + strlen (e->d_name) + 2);
+            sprintf (path, "%s/%s", scratch_root, e->d_name);
+            unlink (path);
+            free (path);
+          }
+      closedir (d);
+    }
+  rmdir (scratch_root);
+  free (scratch_root);
+  scratch_root = NULL;
+}
@@ -0,0 +1,44 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Scratch files exchanged with the external solvers.
+ */
+
+#ifndef NOLL_SCRATCH_H_
+#define NOLL_SCRATCH_H_
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+char *noll_scratch_path (const char *prefix, const char *fname);
+/* Path of the scratch file named @p prefix followed by @p fname,
+ * to be freed by the caller.
+ * The files are private to the process: they are created in a
+ * directory of their own (under the location given by the option -T,
+ * tmpfs by default) or in memory with -Tmem.
+ * The same names give the same file until noll_scratch_free.
+ */
+
+void noll_scratch_free (void);
+/* Remove the scratch files of the process.
+ * Called at exit, the next call to noll_scratch_path starts again.
+ */
+
+#endif /* NOLL_SCRATCH_H_ */
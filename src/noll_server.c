@@ -0,0 +1,360 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Server mode: solve a stream of problems sharing their declarations.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "smtlib2noll.h"
+#include "noll_entl.h"
+#include "noll_lemma.h"
+#include "noll_option.h"
+#include "noll_pred2ta.h"
+#include "noll_ta_symbols.h"
+#include "noll_server.h"
+#include "noll_data.h"
+#include "noll_arena.h"
+#include "noll_hom.h"
+
+/* ====================================================================== */
+/* Datatypes */
+/* ====================================================================== */
+
+/** Kinds of commands read from the stream */
+typedef enum
+{
+  NOLL_SERVER_CMD_DECL = 0,     /// declaration shared by problems
+  NOLL_SERVER_CMD_PROB,         /// command of the current problem
+  NOLL_SERVER_CMD_CHECK,        /// (check-sat), ends the current problem
+  NOLL_SERVER_CMD_EXIT          /// (exit), ends the stream
+} noll_server_cmd_e;
+
+/* ====================================================================== */
+/* Globals */
+/* ====================================================================== */
+
+/* parser of the current session, it stores the declarations */
+static smtlib2_noll_parser *server_parser = NULL;
+
+/* text of the declarations of the current session */
+static char *server_decls = NULL;
+
+/* ====================================================================== */
+/* Reading commands */
+/* ====================================================================== */
+
+/**
+ * Read the next command from @p in.
+ * Comments are removed and blanks are collapsed outside
+ * string literals and quoted symbols, such that equal declarations
+ * have equal texts.
+ * @return the text of the command (to be freed) or NULL at the end
+ */
+static char *
+noll_server_read_cmd (FILE * in)
+{
+  int c;
+  /* skip blanks and comments up to the next command */
+  while ((c = fgetc (in)) != EOF && c != '(')
+    if (c == ';')
+      while ((c = fgetc (in)) != EOF && c != '\n')
+        ;
+  if (c == EOF)
+    return NULL;
+
+  char *cmd = NULL;
+  size_t size = 0;
+  FILE *f = open_memstream (&cmd, &size);
+  int depth = 0;
+  bool blank = false;
+  do
+    {
+      if (c == ';')
+        {                       /* comment up to the end of line */
+          while ((c = fgetc (in)) != EOF && c != '\n')
+            ;
+          blank = true;
+          continue;
+        }
+      if (isspace (c))
+        {
+          blank = true;
+          continue;
+        }
+      if (blank)
+        fputc (' ', f);
+      blank = false;
+      fputc (c, f);
+      if (c == '(')
+        depth++;
+      else if (c == ')')
+        depth--;
+      else if (c == '"' || c == '|')
+        {                       /* string literal or quoted symbol */
+          int q = c;
+          while ((c = fgetc (in)) != EOF && c != q)
+            fputc (c, f);
+          if (c == EOF)
+            break;
+          fputc (c, f);
+        }
+    }
+  while (depth > 0 && (c = fgetc (in)) != EOF);
+  fclose (f);
+
+  if (depth > 0)
+    {                           /* truncated command */
+      free (cmd);
+      return NULL;
+    }
+  return cmd;
+}
+
+/**
+ * Classify the command @p cmd.
+ * Sorts, fields and predicates are declarations, the
+ * variables declared are part of the problem.
+ */
+static noll_server_cmd_e
+noll_server_cmd_kind (const char *cmd)
+{
+  assert (cmd[0] == '(');
+
+  const char *kw = cmd + 1;
+  while (*kw == ' ')
+    kw++;
+  size_t len = strcspn (kw, " ()");
+
+#define NOLL_SERVER_IS(name) \
+  ((len == sizeof (name) - 1) && (strncmp (kw, name, len) == 0))
+
+  if (NOLL_SERVER_IS ("check-sat"))
+    return NOLL_SERVER_CMD_CHECK;
+  if (NOLL_SERVER_IS ("exit"))
+    return NOLL_SERVER_CMD_EXIT;
+  if (NOLL_SERVER_IS ("set-logic") || NOLL_SERVER_IS ("declare-sort")
+      || NOLL_SERVER_IS ("define-sort") || NOLL_SERVER_IS ("define-fun"))
+    return NOLL_SERVER_CMD_DECL;
+  if (NOLL_SERVER_IS ("declare-fun") && (strstr (kw, "(Field ") != NULL))
+    return NOLL_SERVER_CMD_DECL;
+  return NOLL_SERVER_CMD_PROB;
+
+#undef NOLL_SERVER_IS
+}
+
+/* ====================================================================== */
+/* Sessions */
+/* ====================================================================== */
+
+/**
+ * Parse the commands in @p text with the parser of the session,
+ * the answers are printed in @p out.
+ */
+static void
+noll_server_parse (char *text, size_t size, FILE * out)
+{
+  smtlib2_abstract_parser *ap = (smtlib2_abstract_parser *) server_parser;
+  ap->outstream_ = out;
+  ap->errstream_ = out;
+
+  if (size == 0)
+    return;
+  FILE *f = fmemopen (text, size, "r");
+  smtlib2_abstract_parser_parse (ap, f);
+  fclose (f);
+}
+
+/**
+ * Free the current session, if any.
+ */
+static void
+noll_server_close (void)
+{
+  if (server_parser == NULL)
+    return;
+
+  smtlib2_noll_parser_delete (server_parser);
+  server_parser = NULL;
+  free (server_decls);
+  server_decls = NULL;
+
+  noll_entl_free ();
+  noll_lemma_free ();           // before the predicates are reset
+  noll_edge2ta_cache_free ();   // refers to the predicates
+  noll_shom_cache_free ();      // refers to the predicates
+  noll_data_free ();
+  noll_ta_symbol_destroy ();    // refers to the predicates and fields
+  noll_arena_free ();
+}
+
+/**
+ * Start a session for the declarations @p decls.
+ */
+static void
+noll_server_open (char *decls, size_t size, FILE * out)
+{
+  if (noll_option_get_verb () > 0)
+    fprintf (stdout, "  > new session (%zu bytes of declarations)\n", size);
+
+  noll_ta_symbol_init ();
+  server_parser = smtlib2_noll_parser_new ();
+  server_decls = strdup (decls);
+  noll_entl_init ();
+  noll_server_parse (decls, size, out);
+}
+
+/**
+ * Solve the problem @p prob in the current session.
+ */
+static void
+noll_server_solve (char *prob, size_t size, uint_t nprob, FILE * out)
+{
+  char fname[32];
+  snprintf (fname, sizeof (fname), "problem-%u", nprob);
+  if (noll_option_get_verb () > 0)
+    fprintf (stdout, "  > parse %s\n", fname);
+
+  noll_entl_set_fname (fname);
+  smtlib2_noll_parser_reset (server_parser);
+  noll_server_parse (prob, size, out);
+
+  /* only the problem is freed */
+  noll_entl_free ();
+  noll_entl_init ();
+}
+
+/* ====================================================================== */
+/* Main loops */
+/* ====================================================================== */
+
+int
+noll_server_loop (FILE * in, FILE * out)
+{
+  char *decls = NULL;
+  size_t dsize = 0;
+  FILE *fdecls = open_memstream (&decls, &dsize);
+  char *prob = NULL;
+  size_t psize = 0;
+  FILE *fprob = open_memstream (&prob, &psize);
+  uint_t nprob = 0;
+
+  char *cmd;
+  while ((cmd = noll_server_read_cmd (in)) != NULL)
+    {
+      noll_server_cmd_e kind = noll_server_cmd_kind (cmd);
+      if (kind == NOLL_SERVER_CMD_EXIT)
+        {
+          free (cmd);
+          break;
+        }
+      fprintf ((kind == NOLL_SERVER_CMD_DECL) ? fdecls : fprob, "%s\n", cmd);
+      free (cmd);
+      if (kind != NOLL_SERVER_CMD_CHECK)
+        continue;
+
+      fclose (fdecls);
+      fclose (fprob);
+      /* a problem without declarations uses the current ones */
+      if ((server_parser == NULL)
+          || ((dsize > 0) && (strcmp (decls, server_decls) != 0)))
+        {
+          noll_server_close ();
+          noll_server_open (decls, dsize, out);
+        }
+      noll_server_solve (prob, psize, ++nprob, out);
+      fflush (out);
+
+      free (decls);
+      free (prob);
+      fdecls = open_memstream (&decls, &dsize);
+      fprob = open_memstream (&prob, &psize);
+    }
+
+  /* commands after the last (check-sat) are ignored */
+  fclose (fdecls);
+  fclose (fprob);
+  free (decls);
+  free (prob);
+  return 0;
+}
+
+int
+noll_server_run (const char *sockname)
+{
+  if (sockname == NULL)
+    {
+      noll_server_loop (stdin, stdout);
+      noll_server_close ();
+      return 0;
+    }
+
+  struct sockaddr_un addr;
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  if (strlen (sockname) >= sizeof (addr.sun_path))
+    {
+      fprintf (stderr, "Socket name %s too long!\nquit.", sockname);
+      return 1;
+    }
+  strcpy (addr.sun_path, sockname);
+
+  int sfd = socket (AF_UNIX, SOCK_STREAM, 0);
+  unlink (sockname);
+  if ((sfd < 0)
+      || (bind (sfd, (struct sockaddr *) &addr, sizeof (addr)) < 0)
+      || (listen (sfd, 8) < 0))
+    {
+      fprintf (stderr, "Socket %s: %s!\nquit.", sockname, strerror (errno));
+      if (sfd >= 0)
+        close (sfd);
+      return 1;
+    }
+
+  /* the connections are served in sequence,
+   * the session is kept between connections */
+  for (;;)
+    {
+      int cfd = accept (sfd, NULL, NULL);
+      if (cfd < 0)
+        {
+          if (errno == EINTR)
+            continue;
+          break;
+        }
+      FILE *in = fdopen (cfd, "r");
+      FILE *out = fdopen (dup (cfd), "w");
+      noll_server_loop (in, out);
+      fclose (out);
+      fclose (in);
+    }
+
+  close (sfd);
+  unlink (sockname);
+  noll_server_close ();
+  return 0;
+}
@@ -0,0 +1,46 @@
+/**************************************************************************/
+/*                                                                        */
+/*  SPEN decision procedure                                               */
+/*                                                                        */
+/*  you can redistribute it and/or modify it under the terms of the GNU   */
+/*  Lesser General Public License as published by the Free Software       */
+/*  Foundation, version 3.                                                */
+/*                                                                        */
+/*  It is distributed in the hope that it will be useful,                 */
+/*  but WITHOUT ANY WARRANTY; without even the implied warranty of        */
+/*  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         */
+/*  GNU Lesser General Public License for more details.                   */
+/*                                                                        */
+/*  See the GNU Lesser General Public License version 3.                  */
+/*  for more details (enclosed in the file LICENSE).                      */
+/*                                                                        */
+/**************************************************************************/
+
+/**
+ * Server mode: solve a stream of problems sharing their declarations.
+ */
+
+#ifndef NOLL_SERVER_H_
+#define NOLL_SERVER_H_
+
+#include <stdio.h>
+
+/* ====================================================================== */
+/* Functions */
+/* ====================================================================== */
+
+int noll_server_loop (FILE * in, FILE * out);
+/* Solve the problems read from @p in, print the answers in @p out.
+ * A problem ends with (check-sat), the stream ends with (exit) or EOF.
+ * The declarations (sorts, fields, predicates) are parsed only when
+ * they change, the typing of predicates, the lemmas and the TA symbols
+ * are kept for all the problems sharing them.
+ */
+
+int noll_server_run (const char *sockname);
+/* Solve the problems read from stdin if @p sockname is NULL,
+ * otherwise from each connection to the UNIX socket @p sockname.
+ * @return 0 if ok, 1 otherwise
+ */
+
+#endif /* NOLL_SERVER_H_ */
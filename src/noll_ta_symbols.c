@@ -95,6 +95,12 @@ typedef struct noll_ta_symbol
 
   /// The string representation (for humans)
   char *str;
+
+  /// The hash of the contents of the symbol (see noll_ta_symbol_hash)
+  uint_t hash;
+
+  /// The next symbol in the same bucket of the database
+  struct noll_ta_symbol *next;
 } noll_ta_symbol_t;
 
 // a database of symbols
@@ -103,10 +109,21 @@ NOLL_VECTOR_DEFINE (noll_ta_symbol_array, const noll_ta_symbol_t *)
 /* ====================================================================== */
 /* Globals */
 /* ====================================================================== */
-/// The global database of symbols
-/// @todo: it would be more efficient to have 3 databases for every label_type
+/// The global database of symbols (in the order of creation)
      static noll_ta_symbol_array *g_ta_symbols;
 
+/// The hash table of the database, buckets are chained using the field next
+static noll_ta_symbol_t **g_ta_symbols_table;
+
+/// The number of buckets of the hash table (a power of 2)
+static size_t g_ta_symbols_buckets;
+
+/// The arena storing the symbols of the database and their arrays
+static noll_arena_t *g_ta_symbols_arena;
+
+/// The array used for missing variables
+static noll_uid_array g_ta_symbols_novars = { .data_ = NULL };
+
 /* ====================================================================== */
 /* Functions */
 /* ====================================================================== */
@@ -234,6 +251,162 @@ noll_uid_array_subseteq (const noll_uid_array * smaller,
   return true;
 }
 
+/**
+ * @brief  Adds the word @p v to the hash @p h (FNV-1a on words)
+ */
+static inline uint_t
+noll_hash_add (uint_t h, uint_t v)
+{
+  return (h ^ v) * 16777619u;
+}
+
+
+/**
+ * @brief  Adds an UID array to the hash @p h
+ */
+static uint_t
+noll_hash_add_array (uint_t h, const noll_uid_array * arr)
+{
+  assert (NULL != arr);
+
+  h = noll_hash_add (h, noll_vector_size (arr));
+  for (size_t i = 0; i < noll_vector_size (arr); ++i)
+    {
+      h = noll_hash_add (h, noll_vector_at (arr, i));
+    }
+
+  return h;
+}
+
+
+/**
+ * @brief  Adds an UID array, considered as a set, to the hash @p h
+ *
+ * Symbols match on the set of their variables (see noll_ta_symbol_match), so
+ * the value added shall not depend on the order or the repetition of
+ * elements: each element sets one bit of a mask.
+ */
+static uint_t
+noll_hash_add_set (uint_t h, const noll_uid_array * arr)
+{
+  assert (NULL != arr);
+
+  uint_t mask = 0;
+  for (size_t i = 0; i < noll_vector_size (arr); ++i)
+    {
+      mask |= 1u << (noll_hash_add (2166136261u, noll_vector_at (arr, i)) & 31);
+    }
+
+  return noll_hash_add (h, mask);
+}
+
+
+/**
+ * @brief  Computes the hash of a symbol
+ *
+ * Matching symbols (see noll_ta_symbol_match) have the same hash.
+ *
+ * @param[in]  symb  The symbol
+ *
+ * @returns  The hash of the contents of @p symb
+ */
+static uint_t
+noll_ta_symbol_hash (const noll_ta_symbol_t * symb)
+{
+  assert (NULL != symb);
+
+  uint_t h = noll_hash_add (2166136261u, symb->label_type);
+  switch (symb->label_type)
+    {
+    case NOLL_TREE_LABEL_ALLOCATED:
+      {
+        h = noll_hash_add_array (h, symb->allocated.sels);
+        h = noll_hash_add_set (h, symb->allocated.vars);
+        h = noll_hash_add_array (h, symb->allocated.marking);
+        break;
+      }
+
+    case NOLL_TREE_LABEL_ALIASING_VARIABLE:
+      {
+        h = noll_hash_add (h, symb->alias_var);
+        break;
+      }
+
+    case NOLL_TREE_LABEL_ALIASING_MARKING:
+      {
+        h = noll_hash_add (h, symb->alias_marking.id_relation);
+        h = noll_hash_add_array (h, symb->alias_marking.marking);
+        break;
+      }
+
+    case NOLL_TREE_LABEL_HIGHER_PRED:
+      {
+        h = noll_hash_add (h, symb->higher_pred.pred->pid);
+        h = noll_hash_add_set (h, symb->higher_pred.vars);
+        h = noll_hash_add_array (h, symb->higher_pred.marking);
+        break;
+      }
+
+    default:
+      {
+        if (noll_option_is_diag())
+        {
+          NOLL_DEBUG ("ERROR: invalid symbol label type!\n");
+        }
+        assert (false);
+      }
+    }
+
+  return h;
+}
+
+
+/**
+ * @brief  Allocates memory in the arena of the database
+ *
+ * The memory is released only by noll_ta_symbol_destroy().
+ *
+ * @param[in]  size  The number of bytes requested
+ *
+ * @returns  Pointer to @p size bytes of memory
+ */
+static void *
+noll_ta_symbol_arena_alloc (size_t size)
+{
+  return noll_arena_alloc (g_ta_symbols_arena, size);
+}
+
+
+/**
+ * @brief  Copies an UID array into the arena of the database
+ *
+ * @param[in]  arr  The array to be copied
+ *
+ * @returns  A copy of @p arr which shall not be modified nor deleted
+ */
+static noll_uid_array *
+noll_ta_symbol_arena_copy (const noll_uid_array * arr)
+{
+  assert (NULL != arr);
+
+  noll_uid_array *res = noll_ta_symbol_arena_alloc (sizeof (noll_uid_array));
+  res->size_ = noll_vector_size (arr);
+  res->capacity_ = noll_vector_size (arr);
+  res->data_ = NULL;
+  res->arena_ = g_ta_symbols_arena;
+  res->inline_ = false;
+  if (noll_vector_size (arr) > 0)
+    {
+      res->data_ = noll_ta_symbol_arena_alloc (noll_vector_size (arr) *
+                                               sizeof (uid_t));
+      memcpy (res->data_, noll_vector_array (arr),
+              noll_vector_size (arr) * sizeof (uid_t));
+    }
+
+  return res;
+}
+
+
 /**
  * @brief  Checks whether two symbols match
  *
@@ -481,76 +654,12 @@ noll_ta_symbol_init ()
 {
   g_ta_symbols = noll_ta_symbol_array_new ();
   noll_ta_symbol_array_reserve (g_ta_symbols, 10);
-}
-
-
-/**
- * @brief  A function to safely deallocate a TA symbol
- *
- * This function releases the memory allocated by a TA symbol. After the call
- * to the function, @p sym is invalid and the memory deallocated.
- *
- * @param[in,out]  sym  The symbol to be killed
- */
-static void
-noll_ta_symbol_kill (noll_ta_symbol_t * sym)
-{
-  assert (NULL != sym);
-
-  switch (sym->label_type)
-    {
-    case NOLL_TREE_LABEL_ALLOCATED:
-      {
-        assert (NULL != sym->allocated.sels);
-        noll_uid_array_delete (sym->allocated.sels);
-        assert (NULL != sym->allocated.marking);
-        noll_uid_array_delete (sym->allocated.marking);
-        assert (NULL != sym->allocated.vars);
-        noll_uid_array_delete (sym->allocated.vars);
-
-        break;
-      }
-
-    case NOLL_TREE_LABEL_ALIASING_VARIABLE:
-      {
-        // nothing spectacular
-        break;
-      }
-
-    case NOLL_TREE_LABEL_ALIASING_MARKING:
-      {
-        assert (NULL != sym->alias_marking.marking);
-        noll_uid_array_delete (sym->alias_marking.marking);
-
-        break;
-      }
 
-    case NOLL_TREE_LABEL_HIGHER_PRED:
-      {
-        assert (NULL != sym->higher_pred.marking);
-        noll_uid_array_delete (sym->higher_pred.marking);
-        assert (NULL != sym->higher_pred.vars);
-        noll_uid_array_delete (sym->higher_pred.vars);
-
-        break;
-      }
-
-    default:
-      {
-        if (noll_option_is_diag())
-        {
-          NOLL_DEBUG ("ERROR: invalid symbol label type!\n");
-        }
-        assert (false);
-      }
-    }
-
-  if (NULL != sym->str)
-    {                           // the string may not be allocated
-      free (sym->str);
-    }
-
-  free (sym);
+  g_ta_symbols_buckets = 64;
+  g_ta_symbols_table = calloc (g_ta_symbols_buckets,
+                               sizeof (noll_ta_symbol_t *));
+  assert (NULL != g_ta_symbols_table);
+  g_ta_symbols_arena = noll_arena_new ();
 }
 
 
@@ -559,14 +668,23 @@ noll_ta_symbol_destroy ()
 {
   assert (NULL != g_ta_symbols);
 
+  // the symbols and their arrays are in the arena, only strings are freed
   for (size_t i = 0; i < noll_vector_size (g_ta_symbols); ++i)
     {
       const noll_ta_symbol_t *smb = noll_vector_at (g_ta_symbols, i);
       assert (NULL != smb);
-      noll_ta_symbol_kill ((noll_ta_symbol_t*)smb);
+      free (smb->str);
     }
 
   noll_ta_symbol_array_delete (g_ta_symbols);
+  g_ta_symbols = NULL;
+
+  free (g_ta_symbols_table);
+  g_ta_symbols_table = NULL;
+  g_ta_symbols_buckets = 0;
+
+  noll_arena_delete (g_ta_symbols_arena);
+  g_ta_symbols_arena = NULL;
 }
 
 
@@ -595,7 +713,7 @@ noll_ta_symbol_is_pto (const noll_ta_symbol_t * symb)
 /**
  * @brief  Attempts to find a given symbol in the global database
  *
- * @param[in]  symb  The symbol to be sought
+ * @param[in]  symb  The symbol to be sought, with its hash computed
  *
  * @returns  Either a pointer to the unique representation of the symbol @p
  *           symb if it exists, or @p NULL if it does not exist
@@ -604,12 +722,13 @@ static const noll_ta_symbol_t *
 noll_ta_symbol_find (const noll_ta_symbol_t * symb)
 {
   assert (NULL != symb);
-  assert (NULL != g_ta_symbols);
+  assert (NULL != g_ta_symbols_table);
 
-  for (size_t i = 0; i < noll_vector_size (g_ta_symbols); ++i)
+  const noll_ta_symbol_t *iter =
+    g_ta_symbols_table[symb->hash & (g_ta_symbols_buckets - 1)];
+  for (; NULL != iter; iter = iter->next)
     {
-      const noll_ta_symbol_t *iter = noll_vector_at (g_ta_symbols, i);
-      if (noll_ta_symbol_match (symb, iter))
+      if ((iter->hash == symb->hash) && noll_ta_symbol_match (symb, iter))
         {
           return iter;
         }
@@ -619,6 +738,46 @@ noll_ta_symbol_find (const noll_ta_symbol_t * symb)
 }
 
 
+/**
+ * @brief  Inserts a symbol in the hash table of the database
+ *
+ * The table is doubled when it contains more symbols than buckets.
+ *
+ * @param[in,out]  symb  The symbol to be inserted, with its hash computed
+ */
+static void
+noll_ta_symbol_insert (noll_ta_symbol_t * symb)
+{
+  assert (NULL != symb);
+  assert (NULL != g_ta_symbols_table);
+
+  if (noll_vector_size (g_ta_symbols) > g_ta_symbols_buckets)
+    {                           // rehash all symbols in a double table
+      size_t buckets = 2 * g_ta_symbols_buckets;
+      noll_ta_symbol_t **table = calloc (buckets, sizeof (noll_ta_symbol_t *));
+      assert (NULL != table);
+      for (size_t i = 0; i < g_ta_symbols_buckets; ++i)
+        {
+          noll_ta_symbol_t *iter = g_ta_symbols_table[i];
+          while (NULL != iter)
+            {
+              noll_ta_symbol_t *next = iter->next;
+              iter->next = table[iter->hash & (buckets - 1)];
+              table[iter->hash & (buckets - 1)] = iter;
+              iter = next;
+            }
+        }
+      free (g_ta_symbols_table);
+      g_ta_symbols_table = table;
+      g_ta_symbols_buckets = buckets;
+    }
+
+  size_t bucket = symb->hash & (g_ta_symbols_buckets - 1);
+  symb->next = g_ta_symbols_table[bucket];
+  g_ta_symbols_table[bucket] = symb;
+}
+
+
 /**
  * @brief  Retrieves the string for an allocated node
  *
@@ -938,48 +1097,85 @@ noll_ta_symbol_fill_str (noll_ta_symbol_t * sym)
 
 
 /**
- * @brief  Allocates and pre-fills a TA symbol
+ * @brief  Copies a symbol into the arena of the database
  *
- * This function allocates a new TA symbol and pre-fills its data it is the
- * responsibility of the caller to deallocate the returned symbol.
+ * @param[in]  key  The symbol to be copied, its arrays are not shared
  *
- * @returns  An allocated TA symbol. It is the responsibility of the caller to
- * deallocate it.
+ * @returns  A copy of @p key which is never deallocated by the caller
  */
 static noll_ta_symbol_t *
-noll_ta_symbol_create (void)
+noll_ta_symbol_intern (const noll_ta_symbol_t * key)
 {
-  noll_ta_symbol_t *alloc_symb = calloc (1, sizeof (*alloc_symb));
-  assert (NULL != alloc_symb);
+  assert (NULL != key);
 
-  return alloc_symb;
+  noll_ta_symbol_t *symb =
+    noll_ta_symbol_arena_alloc (sizeof (noll_ta_symbol_t));
+  *symb = *key;
+  symb->str = NULL;
+  symb->next = NULL;
+
+  switch (symb->label_type)
+    {
+    case NOLL_TREE_LABEL_ALLOCATED:
+      {
+        symb->allocated.sels = noll_ta_symbol_arena_copy (key->allocated.sels);
+        symb->allocated.vars = noll_ta_symbol_arena_copy (key->allocated.vars);
+        symb->allocated.marking =
+          noll_ta_symbol_arena_copy (key->allocated.marking);
+        break;
+      }
+
+    case NOLL_TREE_LABEL_ALIASING_MARKING:
+      {
+        symb->alias_marking.marking =
+          noll_ta_symbol_arena_copy (key->alias_marking.marking);
+        break;
+      }
+
+    case NOLL_TREE_LABEL_HIGHER_PRED:
+      {
+        symb->higher_pred.vars =
+          noll_ta_symbol_arena_copy (key->higher_pred.vars);
+        symb->higher_pred.marking =
+          noll_ta_symbol_arena_copy (key->higher_pred.marking);
+        break;
+      }
+
+    default:
+      break;
+    }
+
+  return symb;
 }
 
 
 /**
  * @brief  Spawns a symbol by either finding in a DB or adding and returning
  *
- * This function, given the symbol @p symb, attempts to find @p symb in the
- * global database of symbols and if it is found, @p symb is deleted and the
- * found instance is returned, if not, then @p symb is added to the global
- * database and pointer to the instance is returned.
+ * This function, given the symbol @p key, attempts to find @p key in the
+ * global database of symbols and if it is found, the found instance is
+ * returned, if not, then a copy of @p key is added to the global database and
+ * pointer to the instance is returned. The arrays of @p key are only read, so
+ * @p key may be built on the stack from the arrays of the caller.
  *
- * @param[in]  symb  The symbol to be spawned
+ * @param[in,out]  key  The symbol to be spawned, its hash is filled in
  *
  * @returns  The spawned symbol
  */
 static const noll_ta_symbol_t *
-noll_symbol_spawn (noll_ta_symbol_t * symb)
+noll_symbol_spawn (noll_ta_symbol_t * key)
 {
-  assert (NULL != symb);
+  assert (NULL != key);
+
+  key->hash = noll_ta_symbol_hash (key);
 
   const noll_ta_symbol_t *ret_symb;
-  if ((ret_symb = noll_ta_symbol_find (symb)) != NULL)
+  if ((ret_symb = noll_ta_symbol_find (key)) != NULL)
     {
-      noll_ta_symbol_kill (symb);
       return ret_symb;
     }
 
+  noll_ta_symbol_t *symb = noll_ta_symbol_intern (key);
   noll_ta_symbol_fill_str (symb);       // compute the string
   assert (NULL != symb->str);
 
@@ -988,6 +1184,7 @@ noll_symbol_spawn (noll_ta_symbol_t * symb)
     NOLL_DEBUG ("Inserting new symbol: %s\n", symb->str);
   }
 
+  noll_ta_symbol_insert (symb);
   noll_ta_symbol_array_push (g_ta_symbols, symb);
 
   return symb;
@@ -1003,29 +1200,17 @@ noll_ta_symbol_get_unique_allocated (const noll_uid_array * sels,
   assert (NULL != sels);
   assert (NULL != marking);
 
-  noll_ta_symbol_t *symb = noll_ta_symbol_create ();
-  assert (NULL != symb);
-
-  symb->str = NULL;             // clear the string
-  symb->label_type = NOLL_TREE_LABEL_ALLOCATED;
-  noll_uid_array *alloc_sels = noll_uid_array_new ();
-  assert (NULL != alloc_sels);
-  noll_uid_array_copy (alloc_sels, sels);       // copy selectors
-  symb->allocated.sels = alloc_sels;
-
-  symb->allocated.vars = noll_uid_array_new ();
-  assert (NULL != symb->allocated.vars);
-  if (NULL != vars)
-    {                           // if there were some variables, copy
-      noll_uid_array_copy (symb->allocated.vars, vars);
-    }
-
-  symb->allocated.marking = noll_uid_array_new ();
-  assert (NULL != symb->allocated.marking);
-  noll_uid_array_copy (symb->allocated.marking, marking);
+  // the key is copied only if not yet in the database
+  noll_ta_symbol_t symb;
+  memset (&symb, 0, sizeof (symb));
+  symb.label_type = NOLL_TREE_LABEL_ALLOCATED;
+  symb.allocated.sels = (noll_uid_array *) sels;
+  symb.allocated.vars = (NULL != vars) ?
+    (noll_uid_array *) vars : &g_ta_symbols_novars;
+  symb.allocated.marking = (noll_uid_array *) marking;
 
   // get the unique representation of the symbol
-  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (symb);
+  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (&symb);
   assert (NULL != ret_sym);
 
   return ret_sym;
@@ -1035,14 +1220,13 @@ noll_ta_symbol_get_unique_allocated (const noll_uid_array * sels,
 const noll_ta_symbol_t *
 noll_ta_symbol_get_unique_aliased_var (uid_t alias_var)
 {
-  noll_ta_symbol_t *symb = noll_ta_symbol_create ();
-  assert (NULL != symb);
-
-  symb->label_type = NOLL_TREE_LABEL_ALIASING_VARIABLE;
-  symb->alias_var = alias_var;
+  noll_ta_symbol_t symb;
+  memset (&symb, 0, sizeof (symb));
+  symb.label_type = NOLL_TREE_LABEL_ALIASING_VARIABLE;
+  symb.alias_var = alias_var;
 
   // get the unique representation of the symbol
-  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (symb);
+  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (&symb);
   assert (NULL != ret_sym);
   return ret_sym;
 }
@@ -1059,16 +1243,14 @@ noll_ta_symbol_get_unique_aliased_marking (unsigned char id_rel,
           (NOLL_ALIAS_MARKING_REL_UP_UP == id_rel) ||
           (NOLL_ALIAS_MARKING_REL_UP_DOWN_FIRST == id_rel));
 
-  noll_ta_symbol_t *symb = noll_ta_symbol_create ();
-  assert (NULL != symb);
-  symb->label_type = NOLL_TREE_LABEL_ALIASING_MARKING;
-  symb->alias_marking.marking = noll_uid_array_new ();
-  assert (NULL != symb->alias_marking.marking);
-  noll_uid_array_copy (symb->alias_marking.marking, alias_marking);
-  symb->alias_marking.id_relation = id_rel;
+  noll_ta_symbol_t symb;
+  memset (&symb, 0, sizeof (symb));
+  symb.label_type = NOLL_TREE_LABEL_ALIASING_MARKING;
+  symb.alias_marking.marking = (noll_uid_array *) alias_marking;
+  symb.alias_marking.id_relation = id_rel;
 
   // get the unique representation of the symbol
-  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (symb);
+  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (&symb);
   assert (NULL != ret_sym);
   return ret_sym;
 }
@@ -1111,26 +1293,17 @@ noll_ta_symbol_get_unique_higher_pred (const noll_pred_t * pred,
   assert (NULL != pred);
   assert (NULL != marking);
 
-  noll_ta_symbol_t *symb = noll_ta_symbol_create ();
-  assert (NULL != symb);
-
-  symb->str = NULL;             // clear the string
-  symb->label_type = NOLL_TREE_LABEL_HIGHER_PRED;
-  symb->higher_pred.pred = pred;
-
-  symb->higher_pred.vars = noll_uid_array_new ();
-  assert (NULL != symb->higher_pred.vars);
-  if (NULL != vars)
-    {                           // if there were some variables, copy
-      noll_uid_array_copy (symb->allocated.vars, vars);
-    }
-
-  symb->higher_pred.marking = noll_uid_array_new ();
-  assert (NULL != symb->higher_pred.marking);
-  noll_uid_array_copy (symb->higher_pred.marking, marking);
+  // the key is copied only if not yet in the database
+  noll_ta_symbol_t symb;
+  memset (&symb, 0, sizeof (symb));
+  symb.label_type = NOLL_TREE_LABEL_HIGHER_PRED;
+  symb.higher_pred.pred = pred;
+  symb.higher_pred.vars = (NULL != vars) ?
+    (noll_uid_array *) vars : &g_ta_symbols_novars;
+  symb.higher_pred.marking = (noll_uid_array *) marking;
 
   // get the unique representation of the symbol
-  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (symb);
+  const noll_ta_symbol_t *ret_sym = noll_symbol_spawn (&symb);
   assert (NULL != ret_sym);
 
   return ret_sym;
@@ -1277,6 +1450,90 @@ noll_ta_symbol_get_unique_renamed (const noll_ta_symbol_t * sym,
   return sym;
 }
 
+/**
+ * @brief  Renames an array of variables
+ *
+ * @returns  A new array, the caller is responsible for its deallocation
+ */
+static noll_uid_array *
+noll_uid_array_rename (const noll_uid_array * vars,
+                       const noll_uid_array * vmap)
+{
+  assert (NULL != vars);
+  assert (NULL != vmap);
+
+  noll_uid_array *res = noll_uid_array_new ();
+  for (size_t i = 0; i < noll_vector_size (vars); ++i)
+    {
+      uid_t vi = noll_vector_at (vars, i);
+      if (vi < noll_vector_size (vmap))
+        vi = noll_vector_at (vmap, vi);
+      noll_uid_array_push (res, vi);
+    }
+
+  return res;
+}
+
+
+const noll_ta_symbol_t *
+noll_ta_symbol_get_unique_renamed_vars (const noll_ta_symbol_t * sym,
+                                        const noll_uid_array * vmap)
+{
+  // check inputs
+  assert (NULL != sym);
+  assert (NULL != vmap);
+
+  switch (sym->label_type)
+    {
+    case NOLL_TREE_LABEL_ALLOCATED:
+      {
+        noll_uid_array *vars =
+          noll_uid_array_rename (sym->allocated.vars, vmap);
+        const noll_ta_symbol_t *ret_sym =
+          noll_ta_symbol_get_unique_allocated (sym->allocated.sels, vars,
+                                               sym->allocated.marking);
+        noll_uid_array_delete (vars);
+        return ret_sym;
+      }
+
+    case NOLL_TREE_LABEL_ALIASING_VARIABLE:
+      {
+        if (sym->alias_var < noll_vector_size (vmap))
+          return noll_ta_symbol_get_unique_aliased_var
+            (noll_vector_at (vmap, sym->alias_var));
+        return sym;
+      }
+
+    case NOLL_TREE_LABEL_ALIASING_MARKING:
+      {
+        // no variable in the symbol
+        return sym;
+      }
+
+    case NOLL_TREE_LABEL_HIGHER_PRED:
+      {
+        noll_uid_array *vars =
+          noll_uid_array_rename (sym->higher_pred.vars, vmap);
+        const noll_ta_symbol_t *ret_sym =
+          noll_ta_symbol_get_unique_higher_pred (sym->higher_pred.pred, vars,
+                                                 sym->higher_pred.marking);
+        noll_uid_array_delete (vars);
+        return ret_sym;
+      }
+
+    default:
+      {
+        if (noll_option_is_diag())
+        {
+          NOLL_DEBUG ("ERROR: invalid symbol label type!\n");
+        }
+        assert (false);
+      }
+    }
+
+  return sym;
+}
+
 /*
  * A sound? approximation of the desired result
  */
@@ -254,6 +254,18 @@ extern "C"
                                      bool doSub,
                                      const noll_ta_symbol_array * vmap,
                                      noll_uid_array * mmap);
+/**
+ * @brief Renames the variables of a symbol
+ *
+ * @param[in] sym     A symbol to be renamed
+ * @param[in] vmap    The mapping used for vars: the variable v is renamed
+ *                    to vmap[v] (variables outside @p vmap are kept)
+ * @return            The unique renamed symbol
+ */
+  const noll_ta_symbol_t *
+  noll_ta_symbol_get_unique_renamed_vars (const noll_ta_symbol_t * sym,
+                                          const noll_uid_array * vmap);
+
 /**
  * @brief Comput an alias symbol from @p sym
  * 
@@ -24,6 +24,7 @@
 #include "noll_option.h"
 
 NOLL_VECTOR_DEFINE (noll_uid_array, uid_t);
+NOLL_VECTOR_DEFINE_SORTED (noll_uid_array, uid_t);
 
 NOLL_VECTOR_DEFINE (noll_uint_array, uint_t);
 
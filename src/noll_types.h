@@ -47,6 +47,12 @@ extern "C"
 
 /** Vector of identifiers */
     NOLL_VECTOR_DECLARE (noll_uid_array, uid_t);
+    NOLL_VECTOR_DECLARE_SORTED (noll_uid_array, uid_t);
+
+/** Vector of identifiers with inline storage, for short-lived arrays */
+#define NOLL_UID_INLINE 8
+    NOLL_VECTOR_DECLARE_INLINE (noll_uid_inline_array, noll_uid_array,
+                                uid_t, NOLL_UID_INLINE);
 
 /** Vector of integers */
     NOLL_VECTOR_DECLARE (noll_uint_array, uint_t);
@@ -34,6 +34,8 @@
 #include <string.h>
 #include <assert.h>
 
+#include "noll_arena.h"
+
 typedef uint32_t uint_t;
 
 #define NOLL_VECTOR_DECLARE(name, type)                              \
@@ -41,8 +43,11 @@ typedef struct name {                                                \
     type *data_;                                                     \
     uint_t size_;                                                    \
     uint_t capacity_;                                                \
+    noll_arena_t *arena_;                                            \
+    bool inline_;                                                    \
 } name;                                                              \
 name * name ## _new(void);                                           \
+name * name ## _new_in(noll_arena_t *a);                             \
 void name ## _delete(name *v);                                       \
 void name ## _push(name *v, type elem);                              \
 void name ## _pop(name *v);                                          \
@@ -74,6 +79,22 @@ name *name ## _new(void)                                \
     ret->data_ = NULL;                                                  \
     ret->size_ = 0;                                                     \
     ret->capacity_ = 0;                                                 \
+    ret->arena_ = NULL;                                                 \
+    ret->inline_ = false;                                               \
+                                                                        \
+    return ret;                                                         \
+}                                                                       \
+                                                                        \
+                                                                        \
+/* the array and its elements are freed with the arena @p a */          \
+name *name ## _new_in(noll_arena_t *a)                                  \
+{                                                                       \
+    name *ret = (name *)noll_arena_alloc(a, sizeof(name));              \
+    ret->data_ = NULL;                                                  \
+    ret->size_ = 0;                                                     \
+    ret->capacity_ = 0;                                                 \
+    ret->arena_ = a;                                                    \
+    ret->inline_ = false;                                               \
                                                                         \
     return ret;                                                         \
 }                                                                       \
@@ -81,6 +102,10 @@ name *name ## _new(void)                                \
                                                                         \
 void name ## _delete(name *v)                           \
 {                                                                       \
+    if (v->arena_ != NULL) {                                            \
+        return;                                                         \
+    }                                                                   \
+    assert(!v->inline_);                                                \
     if (v->data_ != NULL) {                                             \
         free(v->data_);                                                 \
     }                                                                   \
@@ -92,7 +117,7 @@ void name ## _push(name *v, type elem)              \
 {                                                                       \
     assert(v != NULL);                                                  \
     if (v->size_ >= v->capacity_) {                                     \
-        name ## _reserve(v, v->capacity_ ? v->capacity_ * 2 : 2); \
+        name ## _reserve(v, v->capacity_ ? v->capacity_ * 2 : 4);      \
     }                                                                   \
     v->data_[v->size_++] = elem;                                        \
 }                                                                       \
@@ -120,7 +145,8 @@ void name ## _resize(name *v, uint_t newsz)             \
         v->size_ = newsz;                                               \
     } else {                                                            \
         uint_t i;                                                       \
-        name ## _reserve(v, newsz);                               \
+        name ## _reserve(v, (newsz > 2 * v->capacity_) ?                \
+                            newsz : 2 * v->capacity_);                  \
         for (i = v->size_; i < newsz; ++i) {                            \
             v->data_[i] = 0;                                            \
         }                                                               \
@@ -134,7 +160,22 @@ void name ## _reserve(name *v, uint_t cap)              \
     assert(cap > 0);                                                    \
                                                                         \
     if (v->capacity_ < cap) {                                           \
-        v->data_ = (type *)realloc(v->data_, sizeof(type)*cap); \
+        if (v->arena_ != NULL) {                                        \
+            type *d = (type *)noll_arena_alloc(v->arena_,               \
+                                               sizeof(type)*cap);       \
+            if (v->data_ != NULL) {                                     \
+                memcpy(d, v->data_, sizeof(type) * v->capacity_);       \
+            }                                                           \
+            v->data_ = d;                                               \
+        } else if (v->inline_) {                                        \
+            /* leave the inline storage for the heap */                 \
+            type *d = (type *)malloc(sizeof(type)*cap);                 \
+            memcpy(d, v->data_, sizeof(type) * v->size_);               \
+            v->data_ = d;                                               \
+            v->inline_ = false;                                         \
+        } else {                                                        \
+            v->data_ = (type *)realloc(v->data_, sizeof(type)*cap);     \
+        }                                                               \
         v->capacity_ = cap;                                             \
     }                                                                   \
 }                                                                       \
@@ -143,11 +184,14 @@ void name ## _reserve(name *v, uint_t cap)              \
 void name ## _clear(name *v)                            \
 {                                                                       \
     v->size_ = 0;                                                       \
+    if (v->inline_) {                                                   \
+        return;                                                         \
+    }                                                                   \
     v->capacity_ = 0;                                                   \
-    if (v->data_) {                                                     \
+    if (v->data_ && v->arena_ == NULL) {                                \
         free(v->data_);                                                 \
-        v->data_ = NULL;                                                \
     }                                                                   \
+    v->data_ = NULL;                                                    \
 }                                                                       \
                                                                         \
                                                                         \
@@ -166,6 +210,9 @@ void name ## _swap(name *v1, name *v2)                                  \
     uint_t tmp1;                                                        \
     type *tmp2;                                                         \
                                                                         \
+    assert(v1->arena_ == v2->arena_);                                   \
+    assert(!v1->inline_ && !v2->inline_);                               \
+                                                                        \
     tmp1 = v1->size_;                                                   \
     v1->size_ = v2->size_;                                              \
     v2->size_ = tmp1;                                                   \
@@ -205,4 +252,78 @@ bool name ## _equal(const name *v1, const name *v2)                     \
     return true;                                                        \
 }
 
+
+/* Arrays with inline storage for the first @p n elements.
+ * They are used through their field v, an array of type @p vec,
+ * and live on the stack: _init starts it, _fini frees the heap
+ * storage taken if more than @p n elements were pushed. */
+
+#define NOLL_VECTOR_DECLARE_INLINE(name, vec, type, n)                  \
+typedef struct name {                                                   \
+    vec v;                                                              \
+    type buf_[n];                                                       \
+} name;                                                                 \
+                                                                        \
+static inline vec *name ## _init(name *s)                               \
+{                                                                       \
+    s->v.data_ = s->buf_;                                               \
+    s->v.size_ = 0;                                                     \
+    s->v.capacity_ = (n);                                               \
+    s->v.arena_ = NULL;                                                 \
+    s->v.inline_ = true;                                                \
+    return &s->v;                                                       \
+}                                                                       \
+                                                                        \
+static inline void name ## _fini(name *s)                               \
+{                                                                       \
+    if (!s->v.inline_ && s->v.data_ != NULL) {                          \
+        free(s->v.data_);                                               \
+    }                                                                   \
+    s->v.data_ = NULL;                                                  \
+}
+
+
+/* Arrays used as sorted sets, for types ordered by <.
+ * _sfind returns the position of @p elem or of its insertion point. */
+
+#define NOLL_VECTOR_DECLARE_SORTED(name, type)                          \
+uint_t name ## _sfind(const name *v, type elem);                        \
+bool name ## _scontains(const name *v, type elem);                      \
+void name ## _scup(name *v, type elem);
+
+#define NOLL_VECTOR_DEFINE_SORTED(name, type)                           \
+uint_t name ## _sfind(const name *v, type elem)                         \
+{                                                                       \
+    uint_t lo = 0;                                                      \
+    uint_t hi = v->size_;                                               \
+    while (lo < hi) {                                                   \
+        uint_t mid = lo + (hi - lo) / 2;                                \
+        if (v->data_[mid] < elem)                                       \
+            lo = mid + 1;                                               \
+        else                                                            \
+            hi = mid;                                                   \
+    }                                                                   \
+    return lo;                                                          \
+}                                                                       \
+                                                                        \
+                                                                        \
+bool name ## _scontains(const name *v, type elem)                       \
+{                                                                       \
+    uint_t i = name ## _sfind(v, elem);                                 \
+    return (i < v->size_) && (v->data_[i] == elem);                     \
+}                                                                       \
+                                                                        \
+                                                                        \
+void name ## _scup(name *v, type elem)                                  \
+{                                                                       \
+    assert(v != NULL);                                                  \
+    uint_t i = name ## _sfind(v, elem);                                 \
+    if ((i < v->size_) && (v->data_[i] == elem))                        \
+        return;                                                         \
+    name ## _push(v, elem);                                             \
+    memmove(v->data_ + i + 1, v->data_ + i,                             \
+            sizeof(type) * (v->size_ - 1 - i));                         \
+    v->data_[i] = elem;                                                 \
+}
+
 #endif /* NOLL_VECTOR_H_ */
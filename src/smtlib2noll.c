@@ -250,6 +250,39 @@ smtlib2_noll_parser_delete (smtlib2_noll_parser * p)
   free (p);
 }
 
+static void
+smtlib2_noll_free_key (intptr_t k)
+{
+  free ((void *) k);
+}
+
+/**
+ * Prepare the parser for a new problem using the same declarations:
+ * the global variables of the previous problem are forgotten,
+ * the sorts, fields and predicates are kept.
+ */
+void
+smtlib2_noll_parser_reset (smtlib2_noll_parser * p)
+{
+  noll_context_t *ctx = noll_ctx (p);
+
+  /* the variables of the previous problem shall be declared again */
+  for (uint_t i = 1; i < noll_vector_size (ctx->lvar_env); i++)
+    smtlib2_hashtable_erase_free (noll_funs (p),
+                                  (intptr_t) noll_vector_at (ctx->lvar_env,
+                                                             i)->vname,
+                                  smtlib2_noll_free_key, NULL);
+  for (uint_t i = 0; i < noll_vector_size (ctx->svar_env); i++)
+    smtlib2_hashtable_erase_free (noll_funs (p),
+                                  (intptr_t) noll_vector_at (ctx->svar_env,
+                                                             i)->vname,
+                                  smtlib2_noll_free_key, NULL);
+  noll_context_reset_global (ctx);
+
+  noll_error_parsing = 0;
+  smtlib2_abstract_parser_reset_response (&(p->parent_));
+}
+
 /* =========================================================================
  * Commands parsing.
  * ========================================================================= */
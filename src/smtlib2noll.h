@@ -42,4 +42,8 @@ typedef struct smtlib2_noll_parser
 smtlib2_noll_parser *smtlib2_noll_parser_new (void);
 void smtlib2_noll_parser_delete (smtlib2_noll_parser * p);
 
+/** Forget the global variables of the last problem parsed.
+ */
+void smtlib2_noll_parser_reset (smtlib2_noll_parser * p);
+
 #endif /* _SMTLIB2NOLL_H */